@@ -15,9 +15,17 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 namespace vc4c
 {
+    /*
+     * The positions of the basic blocks within the generated code, mapped by the kernel name and the name of the block
+     * label to the index of the first instruction of the block within the instructions of the kernel
+     */
+    using BlockLayout = std::unordered_map<std::string, std::unordered_map<std::string, std::size_t>>;
+
     /*!
      * The log-level
      * (see cpplog log-levels)
@@ -55,6 +63,22 @@ namespace vc4c
         Configuration& getConfiguration();
         const Configuration& getConfiguration() const;
 
+        /*
+         * Specializes the kernel with the given name for the parameter at the given index always having the given
+         * value (see Configuration#specializedParameters).
+         *
+         * For floating-point parameters, the value is the IEEE 754 bit-pattern of the parameter value.
+         */
+        void specializeParameter(const std::string& kernelName, std::size_t parameterIndex, uint32_t value);
+
+        /*
+         * Returns the positions of the basic blocks within the code generated by the last call to #convert().
+         *
+         * Together with the instrumentation of an emulated execution, this can be used to create the block profile for
+         * profile-guided optimization (see tools::createBlockProfile())
+         */
+        const BlockLayout& getBlockLayout() const;
+
         /*
          * Helper-function to easily compile a single input with the given configuration into the given output.
          *
@@ -63,16 +87,19 @@ namespace vc4c
          * \param config The configuration to use for compilation
          * \param options Specify additional compiler-options to pass onto the pre-compiler
          * \param inputFile Can be used by the compiler to speed-up compilation (e.g. by running the pre-compiler with
-         * this file instead of needing to write input to a temporary file) \return the number of bytes written (only
-         * meaningful for binary output-mode)
+         * this file instead of needing to write input to a temporary file)
+         * \param blockLayout If set, the positions of the basic blocks within the generated code are written into
+         * \return the number of bytes written (only meaningful for binary output-mode)
          */
         static std::size_t compile(std::istream& input, std::ostream& output, const Configuration& config = {},
-            const std::string& options = "", const Optional<std::string>& inputFile = {});
+            const std::string& options = "", const Optional<std::string>& inputFile = {},
+            BlockLayout* blockLayout = nullptr);
 
     private:
         std::istream& input;
         std::ostream& output;
         Configuration config;
+        BlockLayout blockLayout;
     };
 
     /*
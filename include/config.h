@@ -7,6 +7,7 @@
 #ifndef VC4C_CONFIG_H
 #define VC4C_CONFIG_H
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -167,6 +168,35 @@ namespace vc4c
          * NOTE: Setting this to a large value might lead to very long compilation times.
          */
         unsigned maxCommonExpressionDinstance = 64;
+
+        /*
+         * The maximum number of instructions of a loop body after unrolling the loop.
+         *
+         * Loops whose body exceeds this limit when completely unrolled are only partially unrolled (if at all).
+         */
+        unsigned maxUnrolledInstructions = 128;
+
+        /*
+         * The maximum number of locals live throughout a loop for loop-invariant calculations to be moved out of it.
+         *
+         * Any value calculated in front of the loop occupies a physical register for the whole loop. This limit is
+         * halved when running two hardware threads per QPU, since only half of the registers are available then.
+         */
+        unsigned maxLoopInvariantLocals = 32;
+
+        /*
+         * The number of live locals at which the instruction scheduler switches from minimizing stalls to reducing the
+         * register pressure.
+         *
+         * This limit is halved when running two hardware threads per QPU.
+         */
+        unsigned maxSchedulerRegisterPressure = 48;
+
+        /*
+         * The maximum distance of an instruction moved next to another instruction to combine the two into a single
+         * instruction executing on both ALUs.
+         */
+        unsigned maxCombinationDistance = 8;
     };
 
     /*
@@ -219,6 +249,52 @@ namespace vc4c
          * Whether to stop compilation when instruction verification failed
          */
         bool stopWhenVerificationFailed = true;
+        /*
+         * Whether to compile the kernels to be executed by two hardware threads per QPU.
+         *
+         * In this mode, the QPU switches to the other thread while waiting for memory loads via the TMU, but each
+         * thread can only use half of the physical registers.
+         *
+         * NOTE: Kernels using barriers (or any other semaphore access) are always compiled for a single thread per
+         * QPU, since a thread blocked on a semaphore cannot switch to the other thread. The same applies to kernels
+         * loading via the TMU within loops or conditional blocks, since both threads need to switch the same number of
+         * times.
+         */
+        bool useMultiThreading = false;
+        /*
+         * Known values of kernel parameters to specialize the compiled kernels for, mapped by the kernel name and the
+         * index of the parameter in the kernel signature.
+         *
+         * The values are given as their 32-bit representation (e.g. the IEEE 754 bit-pattern for floating-point
+         * parameters) and are propagated as constants through the kernel code, e.g. to calculate constant loop
+         * iteration counts or memory strides.
+         *
+         * NOTE: The specialized parameters are still passed to the kernel and need to be set to the given values when
+         * executing the kernel, otherwise the behavior is undefined. Only scalar non-pointer parameters of up to 32
+         * bits can be specialized.
+         */
+        std::unordered_map<std::string, std::unordered_map<std::size_t, uint32_t>> specializedParameters = {};
+        /*
+         * The number of executions of the basic blocks recorded by a previous execution of the kernels, mapped by the
+         * kernel name and the name of the block label.
+         *
+         * If set, optimizations use the actual block frequencies and branch probabilities instead of static heuristics
+         * for the blocks contained, e.g. to move never executed blocks out of the way or to not unroll never executed
+         * loops. The profile can be created from an emulated execution (see tools::createBlockProfile()).
+         *
+         * NOTE: Blocks not contained in the profile (e.g. since they were created by a different optimization
+         * configuration) fall back to the static heuristics.
+         */
+        std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>> blockProfile = {};
+        /*
+         * Whether to cache consecutive accesses to global memory within small loops in VPM.
+         *
+         * All values written by such a loop are written back to RAM with a single DMA access after the loop exits, and
+         * all values read are loaded with a single DMA access before the loop is entered.
+         *
+         * NOTE: This requires the memory areas to not be accessed via any other (aliasing) pointer within the loop
+         */
+        bool cacheMemoryInVPM = false;
     };
 
     /*
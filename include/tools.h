@@ -16,6 +16,8 @@
 #include <iostream>
 #include <limits>
 #include <map>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace vc4c
@@ -202,6 +204,11 @@ namespace vc4c
              * execution limit (false)
              */
             bool executionSuccessful = false;
+            /*
+             * The number of clock cycles emulated until all QPUs finished the execution (or the execution limit was
+             * reached)
+             */
+            uint32_t numCycles = 0;
             /*
              * The final contents of the parameter passed to the emulation (e.g. for output-parameter).
              */
@@ -227,6 +234,11 @@ namespace vc4c
              * execution limit (false)
              */
             bool executionSuccessful = false;
+            /*
+             * The number of clock cycles emulated until all QPUs finished the execution (or the execution limit was
+             * reached)
+             */
+            uint32_t numCycles = 0;
             /*
              * The instrumentation result for the emulation run. The indices of the instrumentation result correspond to
              * the indices of the instruction in the executed kernel
@@ -243,6 +255,33 @@ namespace vc4c
         EmulationResult emulate(const EmulationData& data);
         LowLevelEmulationResult emulate(const LowLevelEmulationData& data);
 
+        /*
+         * Determines the number of executions of all basic blocks of the emulated kernel from the instrumentation
+         * results.
+         *
+         * The block layout is the layout of the emulated kernel as reported by the compiler (see
+         * Compiler#getBlockLayout()), the result can be used as block profile for a profile-guided recompilation of the
+         * kernel (see Configuration#blockProfile).
+         */
+        std::unordered_map<std::string, uint32_t> createBlockProfile(
+            const EmulationResult& result, const std::unordered_map<std::string, std::size_t>& blockLayout);
+
+        /*
+         * Writes the block profile of all kernels into the given stream.
+         *
+         * The format is a stable text format, each line contains the kernel name, the block label and the number of
+         * block executions separated by a tab. Lines starting with '#' are comments.
+         */
+        void writeBlockProfile(std::ostream& stream,
+            const std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>>& blockProfile);
+
+        /*
+         * Reads the block profile in the format written by #writeBlockProfile() and adds it to the configuration
+         *
+         * @return whether the profile was successfully read
+         */
+        bool readBlockProfile(std::istream& stream, Configuration& config);
+
         /*
          * Parses the given command-line parameter and stores it in the configuration
          *
@@ -100,23 +100,23 @@ std::size_t Compiler::convert()
     qpu_asm::CodeGenerator codeGen(module, config);
 
     PROFILE_START(Normalizer);
-    norm.normalize(module);
+    norm.inlineFunctions(module);
     PROFILE_END(Normalizer);
 
     // remove all non-kernel functions, since we do not handle them anymore, to free up some memory
     module.dropNonKernels();
 
-    PROFILE_START(Optimizer);
-    opt.optimize(module);
-    PROFILE_END(Optimizer);
-
-    PROFILE_START(SecondNormalizer);
-    norm.adjust(module);
-    PROFILE_END(SecondNormalizer);
-
-    auto kernels = module.getKernels();
-    const auto f = [&codeGen](Method* kernelFunc) -> void { codeGen.toMachineCode(*kernelFunc); };
-    ThreadPool{"CodeGenerator"}.scheduleAll<Method*>(kernels, f);
+    // Each kernel runs through the remaining steps independent of all other kernels. Thus, we do not need to wait for
+    // all kernels to finish one step before starting the next one and a single slow kernel does not hold up the others.
+    PROFILE_START(KernelPipeline);
+    const auto f = [&](Method* kernelFunc) -> void {
+        norm.normalizeKernel(module, *kernelFunc);
+        opt.optimizeKernel(module, *kernelFunc);
+        norm.adjustKernel(module, *kernelFunc);
+        codeGen.toMachineCode(*kernelFunc);
+    };
+    ThreadPool{"Compiler"}.scheduleAll<Method*>(module.getKernels(), f);
+    PROFILE_END(KernelPipeline);
 
     // TODO could discard unused globals
     // since they are exported, they are still in the intermediate code, even if not used (e.g. optimized away)
@@ -124,6 +124,7 @@ std::size_t Compiler::convert()
     // code generation
     std::size_t bytesWritten = codeGen.writeOutput(output);
     output.flush();
+    blockLayout = codeGen.getBlockLayout();
 
     return bytesWritten;
 }
@@ -138,8 +139,18 @@ const Configuration& Compiler::getConfiguration() const
     return config;
 }
 
+void Compiler::specializeParameter(const std::string& kernelName, std::size_t parameterIndex, uint32_t value)
+{
+    config.specializedParameters[kernelName][parameterIndex] = value;
+}
+
+const BlockLayout& Compiler::getBlockLayout() const
+{
+    return blockLayout;
+}
+
 std::size_t Compiler::compile(std::istream& input, std::ostream& output, const Configuration& config,
-    const std::string& options, const Optional<std::string>& inputFile)
+    const std::string& options, const Optional<std::string>& inputFile, BlockLayout* blockLayout)
 {
     try
     {
@@ -159,6 +170,8 @@ std::size_t Compiler::compile(std::istream& input, std::ostream& output, const C
 
         conv.getConfiguration() = config;
         std::size_t result = conv.convert();
+        if(blockLayout)
+            *blockLayout = conv.getBlockLayout();
 
         // clean-up
         std::wcout.flush();
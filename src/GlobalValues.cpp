@@ -7,16 +7,124 @@
 #include "GlobalValues.h"
 
 #include "SIMDVector.h"
+#include "helper.h"
 #include "log.h"
 
 #include <algorithm>
 
 using namespace vc4c;
 
+/*
+ * Appends the in-memory representation of the given literal to the flat data, if it can be restored exactly.
+ *
+ * Sub-word integer values with the most significant bit set can be given zero- or sign-extended, but all elements of
+ * a single constant need to be extended the same way, since they are restored that way.
+ */
+static bool appendFlatScalar(Literal lit, DataType scalarType, std::vector<uint8_t>& data, Optional<bool>& signExtended)
+{
+    if(lit.type != (scalarType.isFloatingType() ? LiteralType::REAL : LiteralType::INTEGER))
+        return false;
+    const uint32_t bits = lit.toImmediate();
+    const uint32_t mask = scalarType.getScalarWidthMask();
+    const uint32_t msb = 1u << (scalarType.getScalarBitCount() - 1u);
+    if((bits & ~mask) != 0)
+    {
+        // only sign-extended negative values can be restored from the in-memory representation
+        if((bits & msb) == 0 || (bits | mask) != 0xFFFFFFFFu || (signExtended && !*signExtended))
+            return false;
+        signExtended = true;
+    }
+    else if(mask != 0xFFFFFFFFu && (bits & msb) != 0)
+    {
+        if(signExtended && *signExtended)
+            return false;
+        signExtended = false;
+    }
+    for(unsigned i = 0; i < scalarType.getScalarBitCount() / 8u; ++i)
+        // little endian (LSB has lowest address -> is first in memory)
+        data.push_back(static_cast<uint8_t>((bits >> (8u * i)) & 0xFFu));
+    return true;
+}
+
+static bool appendFlatElement(const CompoundConstant& element, DataType scalarType, unsigned numLanes,
+    std::vector<uint8_t>& data, Optional<bool>& signExtended)
+{
+    if(auto lit = element.getScalar())
+    {
+        // a single literal of vector type is used for all elements of the vector
+        for(unsigned i = 0; i < numLanes; ++i)
+        {
+            if(!appendFlatScalar(*lit, scalarType, data, signExtended))
+                return false;
+        }
+        return true;
+    }
+    auto lanes = element.getCompound();
+    if(!lanes || lanes->size() != numLanes)
+        return false;
+    return std::all_of(lanes->begin(), lanes->end(), [&](const CompoundConstant& lane) -> bool {
+        auto lit = lane.getScalar();
+        return lit && appendFlatScalar(*lit, scalarType, data, signExtended);
+    });
+}
+
+static std::size_t getFlatElementSize(DataType type)
+{
+    const auto& elementType = type.getArrayType()->elementType;
+    return elementType.getVectorWidth() * (elementType.getElementType().getScalarBitCount() / 8u);
+}
+
+CompoundConstant::CompoundConstant(DataType type, std::vector<CompoundConstant>&& values) :
+    type(type), elements(std::move(values))
+{
+    if(!isFlatStorageSupported(type))
+        return;
+    const auto& entries = VariantNamespace::get<std::vector<CompoundConstant>>(elements);
+    if(entries.empty() || entries.size() != type.getArrayType()->size)
+        return;
+    const auto& elementType = type.getArrayType()->elementType;
+    std::vector<uint8_t> data;
+    data.reserve(entries.size() * getFlatElementSize(type));
+    Optional<bool> signExtended;
+    for(const auto& entry : entries)
+    {
+        if(!appendFlatElement(entry, elementType.getElementType(), elementType.getVectorWidth(), data, signExtended))
+            // not all elements can be stored flat, keep the nested representation
+            return;
+    }
+    elements = std::move(data);
+    signExtendFlatData = signExtended.value_or(false);
+}
+
+CompoundConstant::CompoundConstant(DataType type, std::vector<uint8_t>&& rawData, bool signExtend) :
+    type(type), elements(std::move(rawData)), signExtendFlatData(signExtend)
+{
+    if(!isFlatStorageSupported(type) ||
+        VariantNamespace::get<std::vector<uint8_t>>(elements).size() !=
+            type.getArrayType()->size * getFlatElementSize(type))
+        throw CompilationError(CompilationStep::GENERAL, "Invalid raw data for constant of type", type.to_string());
+}
+
 bool CompoundConstant::isAllSame() const
 {
     if(getScalar())
         return true;
+    if(auto data = getFlatData())
+    {
+        const auto elementSize = getFlatElementSize(type);
+        if(data->size() <= elementSize)
+            return true;
+        // same as for nested elements, only containers of scalars can have all the same entries
+        if(!type.getArrayType()->elementType.isScalarType())
+            return false;
+        for(std::size_t offset = elementSize; offset < data->size(); offset += elementSize)
+        {
+            if(!std::equal(data->begin(), data->begin() + static_cast<std::ptrdiff_t>(elementSize),
+                   data->begin() + static_cast<std::ptrdiff_t>(offset)))
+                return false;
+        }
+        return true;
+    }
 
     if(auto entries = getCompound())
     {
@@ -38,6 +146,9 @@ bool CompoundConstant::isUndefined() const
     {
         return lit && lit->isUndefined();
     }
+    if(getFlatData())
+        // only defined values are stored flat
+        return false;
     if(auto elements = getCompound())
     {
         for(const auto& elem : *elements)
@@ -56,6 +167,8 @@ bool CompoundConstant::isZeroInitializer() const
     {
         return lit->unsignedInt() == 0;
     }
+    if(auto data = getFlatData())
+        return std::all_of(data->begin(), data->end(), [](uint8_t byte) -> bool { return byte == 0; });
     if(auto container = getCompound())
     {
         return std::all_of(container->begin(), container->end(),
@@ -80,9 +193,76 @@ Optional<std::vector<CompoundConstant>> CompoundConstant::getCompound() const
     {
         return *vec;
     }
+    if(getFlatData())
+    {
+        std::vector<CompoundConstant> entries;
+        entries.reserve(type.getArrayType()->size);
+        for(std::size_t i = 0; i < type.getArrayType()->size; ++i)
+            entries.emplace_back(getFlatElement(i));
+        return entries;
+    }
+    return {};
+}
+
+const std::vector<uint8_t>* CompoundConstant::getFlatData() const noexcept
+{
+    return VariantNamespace::get_if<std::vector<uint8_t>>(&elements);
+}
+
+Optional<CompoundConstant> CompoundConstant::getElement(std::size_t index) const
+{
+    if(auto vec = VariantNamespace::get_if<std::vector<CompoundConstant>>(&elements))
+    {
+        if(index < vec->size())
+            return (*vec)[index];
+        return {};
+    }
+    if(getFlatData() && index < type.getArrayType()->size)
+        return getFlatElement(index);
     return {};
 }
 
+CompoundConstant CompoundConstant::getFlatElement(std::size_t index) const
+{
+    const auto& data = VariantNamespace::get<std::vector<uint8_t>>(elements);
+    const auto& elementType = type.getArrayType()->elementType;
+    const auto scalarType = elementType.getElementType();
+    const unsigned numBytes = scalarType.getScalarBitCount() / 8u;
+    const uint32_t msb = 1u << (scalarType.getScalarBitCount() - 1u);
+    auto readScalar = [&](std::size_t offset) -> CompoundConstant {
+        uint32_t bits = 0;
+        for(unsigned i = 0; i < numBytes; ++i)
+            bits |= static_cast<uint32_t>(data[offset + i]) << (8u * i);
+        if(scalarType.isFloatingType())
+            return CompoundConstant(scalarType, Literal(bit_cast<uint32_t, float>(bits)));
+        if(signExtendFlatData && (bits & msb) != 0)
+            return CompoundConstant(
+                scalarType, Literal(bit_cast<uint32_t, int32_t>(bits | ~scalarType.getScalarWidthMask())));
+        return CompoundConstant(scalarType, Literal(bits));
+    };
+    const std::size_t offset = index * getFlatElementSize(type);
+    if(elementType.isScalarType())
+        return readScalar(offset);
+    std::vector<CompoundConstant> lanes;
+    lanes.reserve(elementType.getVectorWidth());
+    for(unsigned i = 0; i < elementType.getVectorWidth(); ++i)
+        lanes.emplace_back(readScalar(offset + i * numBytes));
+    return CompoundConstant(elementType, std::move(lanes));
+}
+
+bool CompoundConstant::isFlatStorageSupported(DataType type)
+{
+    auto arrayType = type.getArrayType();
+    if(!arrayType || !arrayType->elementType.isSimpleType() || arrayType->elementType.getVectorWidth() == 3)
+        return false;
+    const auto scalarType = arrayType->elementType.getElementType();
+    const auto bitWidth = scalarType.getScalarBitCount();
+    if(scalarType.isFloatingType())
+        return bitWidth == DataType::WORD;
+    return scalarType.isIntegralType() &&
+        (bitWidth == DataType::BYTE || bitWidth == DataType::HALF_WORD || bitWidth == DataType::WORD);
+}
+
 Optional<Value> CompoundConstant::toValue() const
 {
     if(auto lit = getScalar())
@@ -115,6 +295,12 @@ std::string CompoundConstant::to_string(bool withContent) const
     const std::string typeName = (type.isUnknown() ? "unknown" : type.to_string()) + ' ';
     if(auto lit = getScalar())
         return typeName + lit->to_string();
+    if(!withContent && getFlatData())
+    {
+        if(isZeroInitializer())
+            return typeName + "zerointializer";
+        return typeName + std::string("container with ") + std::to_string(type.getArrayType()->size) + " elements";
+    }
     if(auto container = getCompound())
     {
         if(withContent)
@@ -11,6 +11,7 @@
 #include "Values.h"
 #include "Variant.h"
 
+#include <cstdint>
 #include <vector>
 
 namespace vc4c
@@ -19,6 +20,10 @@ namespace vc4c
      * Content type for constant values containing several values (e.g. struct- or array- constants)
      *
      * NOTE: This can also contain containers of non-scalar values (e.g. array of vectors)
+     *
+     * Arrays of scalars or vectors of scalars, where all elements are defined and of the same literal kind, are stored
+     * as a flat buffer of their in-memory representation instead of a nested constant per element. This greatly
+     * reduces the memory footprint and processing time of large constant tables (e.g. look-up tables).
      */
     struct CompoundConstant
     {
@@ -29,10 +34,22 @@ namespace vc4c
         {
             VariantNamespace::get<std::vector<CompoundConstant>>(elements).reserve(size);
         }
-        CompoundConstant(DataType type, std::vector<CompoundConstant>&& values) :
-            type(type), elements(std::move(values))
-        {
-        }
+        /*
+         * Creates a container with the given elements.
+         *
+         * If the container is a homogeneous array which can be stored flat (see #isFlatStorageSupported()), the
+         * elements are converted into their in-memory representation.
+         */
+        CompoundConstant(DataType type, std::vector<CompoundConstant>&& values);
+        /*
+         * Creates an array constant from its in-memory representation (little endian, no padding between elements).
+         *
+         * Sub-word integer elements with the most significant bit set are restored sign-extended if signExtend is set
+         * and zero-extended (as when loaded from memory) otherwise.
+         *
+         * NOTE: The caller needs to make sure #isFlatStorageSupported() returns true for the given type.
+         */
+        CompoundConstant(DataType type, std::vector<uint8_t>&& rawData, bool signExtend = false);
 
         /*
          * Determines whether all elements of this container have the same value
@@ -50,6 +67,16 @@ namespace vc4c
 
         Optional<Literal> getScalar() const noexcept;
         Optional<std::vector<CompoundConstant>> getCompound() const;
+        /*
+         * Returns the in-memory representation of the elements of this array if it is stored flat, nullptr otherwise
+         */
+        const std::vector<uint8_t>* getFlatData() const noexcept;
+        /*
+         * Returns the element at the given index of this container.
+         *
+         * In contrast to #getCompound(), this does not need to copy all elements.
+         */
+        Optional<CompoundConstant> getElement(std::size_t index) const;
 
         /*
          * Converts this compound constant to a Value.
@@ -62,10 +89,22 @@ namespace vc4c
 
         std::string to_string(bool withContent = false) const;
 
+        /*
+         * Returns whether the elements of a constant of the given type can be stored as a flat buffer.
+         *
+         * This is the case for arrays of 8-, 16- or 32-bit integer, 32-bit floating-point scalars or vectors of these
+         * (except 3-element vectors, since they are padded in memory).
+         */
+        static bool isFlatStorageSupported(DataType type);
+
         DataType type;
 
     private:
-        Variant<std::vector<CompoundConstant>, Literal> elements;
+        Variant<std::vector<CompoundConstant>, Literal, std::vector<uint8_t>> elements;
+        // whether sub-word elements of the flat data are restored sign-extended
+        bool signExtendFlatData = false;
+
+        CompoundConstant getFlatElement(std::size_t index) const;
     };
 
     /*
@@ -64,8 +64,12 @@ namespace vc4c
          * The compilation-time preferred work-group size, specified by the work_group_size_hint attribute
          */
         std::array<uint32_t, 3> workGroupSizeHints;
+        /*
+         * Whether the kernel is compiled to be executed by two hardware threads per QPU
+         */
+        bool isMultiThreaded;
 
-        KernelMetaData() : uniformsUsed(), workGroupSizes(), workGroupSizeHints()
+        KernelMetaData() : uniformsUsed(), workGroupSizes(), workGroupSizeHints(), isMultiThreaded(false)
         {
             workGroupSizes.fill(0);
             workGroupSizeHints.fill(0);
@@ -10,6 +10,7 @@
 #include "GlobalValues.h"
 #include "Method.h"
 #include "SIMDVector.h"
+#include "Symbol.h"
 #include "performance.h"
 
 namespace vc4c
@@ -46,7 +47,7 @@ namespace vc4c
          * E.g. the inlining will check this map and if the called function name is a key in this map, it will try to
          * find a function with the mapped value as name to be inlined.
          */
-        FastMap<std::string, std::string> functionAliases;
+        FastMap<Symbol, Symbol> functionAliases;
 
         const Configuration& compilationConfig;
 
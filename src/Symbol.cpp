@@ -0,0 +1,61 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#include "Symbol.h"
+
+#include "performance.h"
+
+#include <mutex>
+
+using namespace vc4c;
+
+namespace
+{
+    /*
+     * The actual storage for all symbols.
+     *
+     * NOTE: Since the entries of an unordered map are node-based, references to existing entries are not invalidated
+     * when inserting new symbols.
+     */
+    struct SymbolTable
+    {
+        std::mutex mutex;
+        FastMap<std::string, uint32_t> entries;
+
+        const std::pair<const std::string, uint32_t>* intern(const std::string& name)
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            auto it = entries.find(name);
+            if(it == entries.end())
+                it = entries.emplace(name, static_cast<uint32_t>(entries.size())).first;
+            return &*it;
+        }
+
+        std::size_t size()
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            return entries.size();
+        }
+    };
+} // namespace
+
+static SymbolTable& getSymbolTable()
+{
+    // initialized on first use, so symbols can be safely created in the initialization of other static variables
+    static SymbolTable table;
+    return table;
+}
+
+Symbol::Symbol() : Symbol(std::string{}) {}
+
+Symbol::Symbol(const std::string& name) : entry(getSymbolTable().intern(name)) {}
+
+Symbol::Symbol(const char* name) : Symbol(std::string{name}) {}
+
+std::size_t Symbol::getNumberOfSymbols()
+{
+    return getSymbolTable().size();
+}
@@ -0,0 +1,157 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#ifndef VC4C_SYMBOL_H
+#define VC4C_SYMBOL_H
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+
+namespace vc4c
+{
+    /*
+     * An interned name (e.g. of a called function or of an intrinsic operation).
+     *
+     * All symbols created for the same string share a single entry in the symbol table, so copying a symbol does not
+     * allocate any memory and comparing two symbols only compares their entries instead of their contents.
+     *
+     * The symbol table is shared by all modules compiled by this process and is safe to be accessed concurrently.
+     * Entries are never removed, so the referenced strings stay valid for the whole lifetime of the program.
+     */
+    class Symbol
+    {
+        using Entry = std::pair<const std::string, uint32_t>;
+
+    public:
+        /*
+         * Creates the symbol for the empty string
+         */
+        Symbol();
+        Symbol(const std::string& name);
+        Symbol(const char* name);
+        Symbol(const Symbol&) noexcept = default;
+        Symbol(Symbol&&) noexcept = default;
+        ~Symbol() noexcept = default;
+
+        Symbol& operator=(const Symbol&) noexcept = default;
+        Symbol& operator=(Symbol&&) noexcept = default;
+
+        /*
+         * The unique ID of this symbol, the IDs are assigned in order of first creation of the symbols
+         */
+        inline uint32_t getID() const noexcept
+        {
+            return entry->second;
+        }
+
+        inline const std::string& to_string() const noexcept
+        {
+            return entry->first;
+        }
+
+        inline operator const std::string&() const noexcept
+        {
+            return entry->first;
+        }
+
+        inline bool empty() const noexcept
+        {
+            return entry->first.empty();
+        }
+
+        inline bool operator==(const Symbol& other) const noexcept
+        {
+            return entry == other.entry;
+        }
+
+        inline bool operator!=(const Symbol& other) const noexcept
+        {
+            return entry != other.entry;
+        }
+
+        inline bool operator<(const Symbol& other) const noexcept
+        {
+            return entry->second < other.entry->second;
+        }
+
+        /*
+         * Returns the number of distinct symbols created so far
+         */
+        static std::size_t getNumberOfSymbols();
+
+    private:
+        const Entry* entry;
+
+        // hidden friend operators to not take part in overload resolution for any other type
+        friend inline bool operator==(const Symbol& sym, const std::string& name) noexcept
+        {
+            return sym.entry->first == name;
+        }
+
+        friend inline bool operator==(const std::string& name, const Symbol& sym) noexcept
+        {
+            return sym.entry->first == name;
+        }
+
+        friend inline bool operator!=(const Symbol& sym, const std::string& name) noexcept
+        {
+            return sym.entry->first != name;
+        }
+
+        friend inline bool operator!=(const std::string& name, const Symbol& sym) noexcept
+        {
+            return sym.entry->first != name;
+        }
+
+        friend inline bool operator==(const Symbol& sym, const char* name) noexcept
+        {
+            return std::strcmp(sym.entry->first.data(), name) == 0;
+        }
+
+        friend inline bool operator==(const char* name, const Symbol& sym) noexcept
+        {
+            return std::strcmp(sym.entry->first.data(), name) == 0;
+        }
+
+        friend inline bool operator!=(const Symbol& sym, const char* name) noexcept
+        {
+            return std::strcmp(sym.entry->first.data(), name) != 0;
+        }
+
+        friend inline bool operator!=(const char* name, const Symbol& sym) noexcept
+        {
+            return std::strcmp(sym.entry->first.data(), name) != 0;
+        }
+
+        friend inline std::ostream& operator<<(std::ostream& s, const Symbol& sym)
+        {
+            return s << sym.entry->first;
+        }
+
+        friend inline std::wostream& operator<<(std::wostream& s, const Symbol& sym)
+        {
+            return s << sym.entry->first.data();
+        }
+    };
+} // namespace vc4c
+
+namespace std
+{
+    template <>
+    struct hash<vc4c::Symbol>
+    {
+        inline size_t operator()(const vc4c::Symbol& sym) const noexcept
+        {
+            return sym.getID();
+        }
+    };
+} // namespace std
+
+#endif /* VC4C_SYMBOL_H */
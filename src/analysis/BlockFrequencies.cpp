@@ -0,0 +1,54 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+#include "BlockFrequencies.h"
+
+#include "../Method.h"
+#include "../intermediate/IntermediateInstruction.h"
+
+#include <algorithm>
+
+using namespace vc4c;
+using namespace vc4c::analysis;
+
+BlockFrequencies::BlockFrequencies(const Method& method, const Configuration& config) : counts(nullptr)
+{
+    auto it = config.blockProfile.find(method.name);
+    if(it == config.blockProfile.end() || it->second.empty())
+        return;
+    counts = &it->second;
+    if(method.begin() != method.end())
+        kernelExecutions = getExecutionCount(*method.begin());
+}
+
+bool BlockFrequencies::empty() const
+{
+    return counts == nullptr;
+}
+
+Optional<uint32_t> BlockFrequencies::getExecutionCount(const BasicBlock& block) const
+{
+    if(counts == nullptr)
+        return {};
+    auto it = counts->find(block.getLabel()->getLabel()->name);
+    if(it == counts->end())
+        return {};
+    return it->second;
+}
+
+Optional<double> BlockFrequencies::getBranchProbability(const BasicBlock& source, const BasicBlock& target) const
+{
+    auto sourceCount = getExecutionCount(source);
+    auto targetCount = getExecutionCount(target);
+    if(!sourceCount || !targetCount || *sourceCount == 0)
+        return {};
+    return std::min(1.0, static_cast<double>(*targetCount) / static_cast<double>(*sourceCount));
+}
+
+bool BlockFrequencies::isNeverExecuted(const BasicBlock& block) const
+{
+    auto count = getExecutionCount(block);
+    return kernelExecutions && *kernelExecutions > 0 && count && *count == 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+#ifndef VC4C_BLOCK_FREQUENCIES_H
+#define VC4C_BLOCK_FREQUENCIES_H 1
+
+#include "Optional.h"
+#include "config.h"
+
+#include <string>
+#include <unordered_map>
+
+namespace vc4c
+{
+    class BasicBlock;
+    class Method;
+
+    namespace analysis
+    {
+        /*
+         * Provides the execution frequencies of the basic blocks of a kernel recorded by a previous execution (see
+         * Configuration#blockProfile) to be used by optimizations instead of static heuristics.
+         *
+         * The blocks are identified by the names of their labels, so only blocks also present (with the same name) in
+         * the profiled kernel have a known frequency.
+         */
+        class BlockFrequencies
+        {
+        public:
+            BlockFrequencies(const Method& method, const Configuration& config);
+
+            /*
+             * Returns whether there is any profile for the kernel
+             */
+            bool empty() const;
+
+            /*
+             * Returns the number of executions of the given block, if known
+             */
+            Optional<uint32_t> getExecutionCount(const BasicBlock& block) const;
+
+            /*
+             * Returns the probability of the given block being executed after the source block, if known.
+             *
+             * NOTE: This is only accurate, if the target block has the source block as its single predecessor.
+             */
+            Optional<double> getBranchProbability(const BasicBlock& source, const BasicBlock& target) const;
+
+            /*
+             * Returns whether the given block was never executed although the kernel itself was
+             */
+            bool isNeverExecuted(const BasicBlock& block) const;
+
+        private:
+            const std::unordered_map<std::string, uint32_t>* counts;
+            Optional<uint32_t> kernelExecutions;
+        };
+    } // namespace analysis
+} // namespace vc4c
+
+#endif /* VC4C_BLOCK_FREQUENCIES_H */
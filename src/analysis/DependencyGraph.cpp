@@ -230,6 +230,15 @@ static void createLocalDependencies(DependencyGraph& graph, DependencyNode& node
         });
 }
 
+/*
+ * Returns whether the instruction (possibly) modifies the flags
+ */
+static bool clobbersFlags(const intermediate::IntermediateInstruction* inst)
+{
+    // the flags are not preserved across thread switches
+    return inst->setFlags == SetFlag::SET_FLAGS || inst->signal == SIGNAL_SWITCH_THREAD;
+}
+
 static void createFlagDependencies(DependencyGraph& graph, DependencyNode& node,
     const intermediate::IntermediateInstruction* lastSettingOfFlags,
     const intermediate::IntermediateInstruction* lastConditional)
@@ -241,13 +250,13 @@ static void createFlagDependencies(DependencyGraph& graph, DependencyNode& node,
         auto& otherNode = graph.assertNode(lastSettingOfFlags);
         addDependency(otherNode.getOrCreateEdge(&node).data, DependencyType::FLAGS_READ_AFTER_WRITE);
     }
-    if(node.key->setFlags == SetFlag::SET_FLAGS && lastSettingOfFlags != nullptr)
+    if(clobbersFlags(node.key) && lastSettingOfFlags != nullptr)
     {
         // any setting of flags must be ordered after the previous setting of flags
         auto& otherNode = graph.assertNode(lastSettingOfFlags);
         addDependency(otherNode.getOrCreateEdge(&node).data, DependencyType::FLAGS_WRITE_AFTER_WRITE);
     }
-    if(node.key->setFlags == SetFlag::SET_FLAGS && lastConditional != nullptr)
+    if(clobbersFlags(node.key) && lastConditional != nullptr)
     {
         // any setting of flags must be ordered after any previous use of these flags
         auto& otherNode = graph.assertNode(lastConditional);
@@ -777,7 +786,7 @@ std::unique_ptr<DependencyGraph> DependencyGraph::createGraph(const BasicBlock&
         }
 
         // update the cached values
-        if(inst->setFlags == SetFlag::SET_FLAGS || (branch && !branch->isUnconditional()))
+        if(clobbersFlags(inst.get()) || (branch && !branch->isUnconditional()))
             // conditional branches may introduce setting of flags
             lastSettingOfFlags = inst.get();
         if(inst->hasConditionalExecution() || (branch && !branch->isUnconditional()))
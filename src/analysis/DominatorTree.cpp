@@ -0,0 +1,184 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+#include "DominatorTree.h"
+
+#include "../Profiler.h"
+#include "CompilationError.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace vc4c;
+using namespace vc4c::analysis;
+
+static constexpr std::size_t UNDEFINED_INDEX = std::numeric_limits<std::size_t>::max();
+
+DominatorTree::DominatorTree(ControlFlowGraph& cfg)
+{
+    PROFILE_START(createDominatorTree);
+    const CFGNode* start = &cfg.getStartOfControlFlow();
+
+    // 1. determine post-order of all reachable nodes (iteratively, to not overflow the stack for huge kernels)
+    {
+        FastSet<const CFGNode*> visitedNodes;
+        FastAccessList<std::pair<const CFGNode*, FastAccessList<const CFGNode*>>> stack;
+        auto pushNode = [&](const CFGNode* node) {
+            visitedNodes.emplace(node);
+            FastAccessList<const CFGNode*> successors;
+            node->forAllOutgoingEdges([&](const CFGNode& successor, const CFGEdge&) -> bool {
+                successors.emplace_back(&successor);
+                return true;
+            });
+            // reverse, so the successors are visited in their original order
+            std::reverse(successors.begin(), successors.end());
+            stack.emplace_back(node, std::move(successors));
+        };
+        pushNode(start);
+        while(!stack.empty())
+        {
+            auto& successors = stack.back().second;
+            if(successors.empty())
+            {
+                indices.emplace(stack.back().first, postOrder.size());
+                postOrder.emplace_back(stack.back().first);
+                stack.pop_back();
+                continue;
+            }
+            auto next = successors.back();
+            successors.pop_back();
+            if(visitedNodes.find(next) == visitedNodes.end())
+                // NOTE: this invalidates the successors reference!
+                pushNode(next);
+        }
+    }
+
+    // 2. cache the (reachable) predecessors of all nodes
+    FastAccessList<FastAccessList<std::size_t>> predecessors(postOrder.size());
+    for(std::size_t i = 0; i < postOrder.size(); ++i)
+    {
+        postOrder[i]->forAllIncomingEdges([&](const CFGNode& predecessor, const CFGEdge&) -> bool {
+            auto it = indices.find(&predecessor);
+            if(it != indices.end())
+                predecessors[i].emplace_back(it->second);
+            return true;
+        });
+    }
+
+    // 3. iteratively determine the immediate dominators by walking the nodes in reverse post-order
+    immediateDominators.assign(postOrder.size(), UNDEFINED_INDEX);
+    const std::size_t root = postOrder.size() - 1;
+    immediateDominators[root] = root;
+    auto intersect = [&](std::size_t first, std::size_t second) -> std::size_t {
+        while(first != second)
+        {
+            while(first < second)
+                first = immediateDominators[first];
+            while(second < first)
+                second = immediateDominators[second];
+        }
+        return first;
+    };
+    bool changed = true;
+    while(changed)
+    {
+        changed = false;
+        for(std::size_t i = root; i-- > 0;)
+        {
+            auto newDominator = UNDEFINED_INDEX;
+            for(auto pred : predecessors[i])
+            {
+                if(immediateDominators[pred] == UNDEFINED_INDEX)
+                    // predecessor not yet processed
+                    continue;
+                newDominator = newDominator == UNDEFINED_INDEX ? pred : intersect(pred, newDominator);
+            }
+            if(newDominator != immediateDominators[i])
+            {
+                immediateDominators[i] = newDominator;
+                changed = true;
+            }
+        }
+    }
+
+    // 4. build the actual tree and number the sub-trees to allow for constant-time dominance queries
+    children.resize(postOrder.size());
+    // iterate in reverse post-order to list the children in control flow order
+    for(std::size_t i = root; i-- > 0;)
+    {
+        if(immediateDominators[i] == UNDEFINED_INDEX)
+            throw CompilationError(CompilationStep::GENERAL, "Failed to determine immediate dominator of block",
+                postOrder[i]->key->to_string());
+        children[immediateDominators[i]].emplace_back(postOrder[i]);
+    }
+    subTreeIntervals.assign(postOrder.size(), std::make_pair(UNDEFINED_INDEX, UNDEFINED_INDEX));
+    std::size_t counter = 0;
+    FastAccessList<std::pair<std::size_t, std::size_t>> stack;
+    stack.emplace_back(root, 0);
+    subTreeIntervals[root].first = counter++;
+    while(!stack.empty())
+    {
+        auto& entry = stack.back();
+        if(entry.second == children[entry.first].size())
+        {
+            subTreeIntervals[entry.first].second = counter - 1;
+            stack.pop_back();
+            continue;
+        }
+        auto child = getIndex(*children[entry.first][entry.second++]);
+        subTreeIntervals[child].first = counter++;
+        // NOTE: this invalidates the entry reference!
+        stack.emplace_back(child, 0);
+    }
+    PROFILE_END(createDominatorTree);
+}
+
+const CFGNode& DominatorTree::getRoot() const
+{
+    return *postOrder.back();
+}
+
+bool DominatorTree::isReachable(const CFGNode& node) const
+{
+    return indices.find(&node) != indices.end();
+}
+
+const CFGNode* DominatorTree::getImmediateDominator(const CFGNode& node) const
+{
+    auto it = indices.find(&node);
+    if(it == indices.end() || it->second == postOrder.size() - 1)
+        return nullptr;
+    return postOrder[immediateDominators[it->second]];
+}
+
+const FastAccessList<const CFGNode*>& DominatorTree::getImmediatelyDominated(const CFGNode& node) const
+{
+    return children[getIndex(node)];
+}
+
+bool DominatorTree::dominates(const CFGNode& dominator, const CFGNode& node) const
+{
+    auto domIt = indices.find(&dominator);
+    auto nodeIt = indices.find(&node);
+    if(domIt == indices.end() || nodeIt == indices.end())
+        return false;
+    const auto& outer = subTreeIntervals[domIt->second];
+    const auto& inner = subTreeIntervals[nodeIt->second];
+    return outer.first <= inner.first && inner.second <= outer.second;
+}
+
+FastAccessList<const CFGNode*> DominatorTree::getReversePostOrder() const
+{
+    return FastAccessList<const CFGNode*>(postOrder.rbegin(), postOrder.rend());
+}
+
+std::size_t DominatorTree::getIndex(const CFGNode& node) const
+{
+    auto it = indices.find(&node);
+    if(it == indices.end())
+        throw CompilationError(CompilationStep::GENERAL, "Block is not reachable and not part of the dominator tree",
+            node.key->to_string());
+    return it->second;
+}
@@ -0,0 +1,84 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+#ifndef VC4C_DOMINATORTREE_H
+#define VC4C_DOMINATORTREE_H 1
+
+#include "../performance.h"
+#include "ControlFlowGraph.h"
+
+namespace vc4c
+{
+    namespace analysis
+    {
+        /*
+         * The dominator tree of a control-flow graph.
+         *
+         * A basic block A dominates a basic block B, if every path from the start of the control flow to B passes
+         * through A. The immediate dominator of B is the (unique) dominator of B which does not dominate any other
+         * dominator of B. Connecting every block to its immediate dominator results in the dominator tree.
+         *
+         * The tree is calculated via the iterative algorithm described in "A Simple, Fast Dominance Algorithm" by
+         * Cooper, Harvey and Kennedy, which converges in very few iterations for the reducible CFGs generated from
+         * OpenCL C code.
+         *
+         * NOTE: Blocks not reachable from the start of the control flow are not part of the dominator tree.
+         */
+        class DominatorTree
+        {
+        public:
+            explicit DominatorTree(ControlFlowGraph& cfg);
+
+            /*
+             * Returns the root of the dominator tree, the node of the first basic block executed
+             */
+            const CFGNode& getRoot() const;
+
+            /*
+             * Returns whether the given node is reachable from the start of the control flow and therefore part of this
+             * dominator tree
+             */
+            bool isReachable(const CFGNode& node) const;
+
+            /*
+             * Returns the immediate dominator of the given node or nullptr for the root and unreachable nodes
+             */
+            const CFGNode* getImmediateDominator(const CFGNode& node) const;
+
+            /*
+             * Returns all nodes immediately dominated by the given node, i.e. its children in the dominator tree
+             */
+            const FastAccessList<const CFGNode*>& getImmediatelyDominated(const CFGNode& node) const;
+
+            /*
+             * Returns whether the first node dominates the second node.
+             *
+             * NOTE: Every node dominates itself!
+             */
+            bool dominates(const CFGNode& dominator, const CFGNode& node) const;
+
+            /*
+             * Returns all reachable nodes in reverse post-order of the control flow, i.e. every node is listed before
+             * all its successors (ignoring back edges)
+             */
+            FastAccessList<const CFGNode*> getReversePostOrder() const;
+
+        private:
+            // all reachable nodes in post-order of a depth-first traversal of the CFG
+            FastAccessList<const CFGNode*> postOrder;
+            // the post-order index of all reachable nodes
+            FastMap<const CFGNode*, std::size_t> indices;
+            // the post-order indices of the immediate dominators
+            FastAccessList<std::size_t> immediateDominators;
+            FastAccessList<FastAccessList<const CFGNode*>> children;
+            // the first and last index of a pre-order traversal of the dominator tree within the sub-tree of the node
+            FastAccessList<std::pair<std::size_t, std::size_t>> subTreeIntervals;
+
+            std::size_t getIndex(const CFGNode& node) const;
+        };
+    } // namespace analysis
+} // namespace vc4c
+
+#endif /* VC4C_DOMINATORTREE_H */
@@ -26,7 +26,10 @@ using namespace vc4c;
 using namespace vc4c::qpu_asm;
 using namespace vc4c::intermediate;
 
-CodeGenerator::CodeGenerator(const Module& module, const Configuration& config) : config(config), module(module) {}
+CodeGenerator::CodeGenerator(const Module& module, const Configuration& config) :
+    config(config), module(module), optimizer(config)
+{
+}
 
 static FastMap<const Local*, std::size_t> mapLabels(Method& method)
 {
@@ -74,6 +77,7 @@ const FastAccessList<DecoratedInstruction>& CodeGenerator::generateInstructions(
     instructionsLock.lock();
 #endif
     auto& generatedInstructions = allInstructions[&method];
+    auto& kernelLayout = blockLayout[method.name];
 #ifdef MULTI_THREADED
     instructionsLock.unlock();
 #endif
@@ -97,8 +101,17 @@ const FastAccessList<DecoratedInstruction>& CodeGenerator::generateInstructions(
     }
     PROFILE_END(colorGraph);
 
+    // run the optimizations which depend on the instructions not being modified by the register allocation anymore,
+    // e.g. filling the branch delay slots
+    PROFILE_START(optimizeAllocatedKernel);
+    optimizer.optimizeAllocatedKernel(module, method);
+    PROFILE_END(optimizeAllocatedKernel);
+
     // create label-map + remove labels
     const auto labelMap = mapLabels(method);
+    for(const auto& entry : labelMap)
+        // the label map contains byte positions
+        kernelLayout.emplace(entry.first->name, entry.second / sizeof(uint64_t));
 
     // IMPORTANT: DO NOT OPTIMIZE, RE-ORDER, COMBINE, INSERT OR REMOVE ANY INSTRUCTION AFTER THIS POINT!!!
     // otherwise, labels/branches will be wrong
@@ -236,6 +249,11 @@ std::size_t CodeGenerator::writeOutput(std::ostream& stream)
     return numBytes;
 }
 
+const BlockLayout& CodeGenerator::getBlockLayout() const
+{
+    return blockLayout;
+}
+
 // register/instruction mapping
 void CodeGenerator::toMachineCode(Method& kernel)
 {
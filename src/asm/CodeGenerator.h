@@ -7,7 +7,9 @@
 #ifndef CODEGENERATOR_H
 #define CODEGENERATOR_H
 
+#include "../optimization/Optimizer.h"
 #include "../performance.h"
+#include "Compiler.h"
 #include "Instruction.h"
 #include "config.h"
 
@@ -34,10 +36,17 @@ namespace vc4c
             std::size_t writeOutput(std::ostream& stream);
             void toMachineCode(Method& kernel);
 
+            /*
+             * Returns the positions of the basic blocks within the instructions generated for all kernels
+             */
+            const BlockLayout& getBlockLayout() const;
+
         private:
             Configuration config;
             const Module& module;
+            optimizations::Optimizer optimizer;
             std::map<Method*, FastAccessList<qpu_asm::DecoratedInstruction>> allInstructions;
+            BlockLayout blockLayout;
 #ifdef MULTI_THREADED
             std::mutex instructionsLock;
 #endif
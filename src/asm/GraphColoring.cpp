@@ -9,6 +9,7 @@
 #include "../Profiler.h"
 #include "../analysis/ControlFlowGraph.h"
 #include "../analysis/DebugGraph.h"
+#include "../analysis/LivenessAnalysis.h"
 #include "../intermediate/IntermediateInstruction.h"
 #include "RegisterAllocation.h"
 #include "log.h"
@@ -462,9 +463,60 @@ GraphColoring::GraphColoring(Method& method, InstructionWalker it) :
     }
 }
 
+static bool isThreadSwitch(const intermediate::IntermediateInstruction* inst)
+{
+    if(auto combined = dynamic_cast<const intermediate::CombinedOperation*>(inst))
+        return (combined->op1 && isThreadSwitch(combined->op1.get())) ||
+            (combined->op2 && isThreadSwitch(combined->op2.get()));
+    return inst != nullptr && (inst->signal == SIGNAL_SWITCH_THREAD || inst->signal == SIGNAL_THREAD_SWITCH_LAST);
+}
+
+/*
+ * Determines all locals which are live while the QPU switches to the other hardware thread.
+ *
+ * Since the accumulators are not preserved across thread switches, these locals need to be on the physical register
+ * files.
+ */
+static FastSet<const Local*> findLocalsLiveAcrossThreadSwitches(Method& method)
+{
+    FastSet<const Local*> liveLocals;
+    analysis::GlobalLivenessAnalysis livenessAnalysis;
+    livenessAnalysis(method);
+    for(const auto& block : method)
+    {
+        const auto& blockAnalysis = livenessAnalysis.getLocalAnalysis(block);
+        for(auto it = block.begin(); it != block.end(); ++it)
+        {
+            if(!isThreadSwitch(it->get()))
+                continue;
+            // the thread switch takes effect after the next 2 instructions, so everything live up to the beginning of
+            // the third instruction is live across the thread switch
+            auto lastIt = it;
+            for(unsigned i = 0; i <= 3; ++i)
+            {
+                if(lastIt == block.end())
+                {
+                    liveLocals.insert(blockAnalysis.getEndResult().begin(), blockAnalysis.getEndResult().end());
+                    break;
+                }
+                if(*lastIt)
+                {
+                    const auto& live = blockAnalysis.getResult(lastIt->get());
+                    liveLocals.insert(live.begin(), live.end());
+                }
+                ++lastIt;
+            }
+        }
+    }
+    return liveLocals;
+}
+
 void GraphColoring::createGraph()
 {
     interferenceGraph = analysis::InterferenceGraph::createGraph(method);
+    FastSet<const Local*> threadSwitchLocals;
+    if(method.metaData.isMultiThreaded)
+        threadSwitchLocals = findLocalsLiveAcrossThreadSwitches(method);
     graph.reserveNodeSize(localUses.size());
     // 1. iteration: set files and locals used together and map to start/end of range
     PROFILE_START(createColoredNodes);
@@ -472,7 +524,18 @@ void GraphColoring::createGraph()
     {
         auto& node = graph.getOrCreateNode(pair.first);
         node.possibleFiles = pair.second.possibleFiles;
-        node.initialFile = pair.second.possibleFiles;
+        if(method.metaData.isMultiThreaded)
+        {
+            // each of the two hardware threads can only access one half of the physical register-files
+            for(std::size_t i = 16; i < 32; ++i)
+            {
+                node.blockRegister(RegisterFile::PHYSICAL_A, i);
+                node.blockRegister(RegisterFile::PHYSICAL_B, i);
+            }
+            if(threadSwitchLocals.find(pair.first) != threadSwitchLocals.end())
+                node.possibleFiles = remove_flag(node.possibleFiles, RegisterFile::ACCUMULATOR);
+        }
+        node.initialFile = node.possibleFiles;
         if(isReplicationUsed ||
             dynamic_cast<const intermediate::LoadImmediate*>(pair.first->getSingleWriter()) == nullptr ||
             dynamic_cast<const intermediate::LoadImmediate*>(pair.first->getSingleWriter())->type !=
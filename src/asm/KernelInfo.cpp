@@ -164,14 +164,18 @@ std::string KernelInfo::to_string() const
 
     return std::string("Kernel '") + (name + "' with ") +
         (std::to_string(getLength().getValue()) + " instructions, offset ") +
-        (std::to_string(getOffset().getValue()) + ", with following parameters: ") +
+        (std::to_string(getOffset().getValue()) + (isMultiThreaded() ? ", multi-threaded" : "") +
+            ", with following parameters: ") +
         ::to_string<ParamInfo>(parameters) + uniformsString;
 }
 LCOV_EXCL_STOP
 
 static void toBinary(const CompoundConstant& val, std::vector<uint8_t>& queue)
 {
-    if(auto container = val.getCompound())
+    if(auto data = val.getFlatData())
+        // already in the in-memory representation
+        queue.insert(queue.end(), data->begin(), data->end());
+    else if(auto container = val.getCompound())
     {
         for(const auto& element : *container)
             toBinary(element, queue);
@@ -363,6 +367,7 @@ KernelInfo qpu_asm::getKernelInfos(
                             << KernelInfo::MAX_WORK_GROUP_SIZES << logging::endl;
         }
     }
+    info.setMultiThreaded(method.metaData.isMultiThreaded);
     for(const Parameter& param : method.parameters)
     {
         std::string paramName = param.parameterName;
@@ -120,7 +120,7 @@ namespace vc4c
          * Binary layout:
          *
          * | offset | length | name-length | parameter count |
-         * | work-group size compilation hint                |
+         * | work-group size compilation hint | thread mode  |
          * | name ...
          *   ...                                             |
          *
@@ -158,7 +158,8 @@ namespace vc4c
              */
             BITFIELD_ENTRY(ParamCount, uint8_t, 56, Byte)
             /*
-             * The 3 dimensions for the work-group size specified in the source code
+             * The 3 dimensions for the work-group size specified in the source code (16 bit each) and the thread mode
+             * in the upper 16 bits
              */
             uint64_t workGroupSize;
             /*
@@ -172,6 +173,8 @@ namespace vc4c
 
             // The maximum work group sizes specified in the VC4CL runtime library
             static constexpr uint32_t MAX_WORK_GROUP_SIZES = NUM_QPUS;
+            // The bit in the work-group size field marking the kernel as compiled for two threads per QPU
+            static constexpr uint64_t MULTI_THREADED_FLAG = uint64_t{1} << 48;
 
             inline void setName(const std::string& name)
             {
@@ -179,6 +182,23 @@ namespace vc4c
                 setNameLength(Byte(name.size()));
             }
 
+            /*
+             * Whether the kernel is compiled to be executed by two hardware threads per QPU, which allows the host to
+             * launch twice the number of threads
+             */
+            inline bool isMultiThreaded() const
+            {
+                return (workGroupSize & MULTI_THREADED_FLAG) != 0;
+            }
+
+            inline void setMultiThreaded(bool multiThreaded)
+            {
+                if(multiThreaded)
+                    workGroupSize |= MULTI_THREADED_FLAG;
+                else
+                    workGroupSize &= ~MULTI_THREADED_FLAG;
+            }
+
             inline void addParameter(const ParamInfo& param)
             {
                 parameters.push_back(param);
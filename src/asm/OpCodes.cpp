@@ -8,13 +8,13 @@
 
 #include "../HalfType.h"
 #include "../SIMDVector.h"
+#include "../Symbol.h"
 #include "../Values.h"
 #include "../analysis/ValueRange.h"
 #include "../intrinsics/Operators.h"
 #include "CompilationError.h"
 
 #include <cmath>
-#include <map>
 
 using namespace vc4c;
 
@@ -1307,7 +1307,15 @@ const OpCode& OpCode::toOpCode(const std::string& name)
     return code;
 }
 
-static const std::multimap<std::string, OpCode> opCodes = {{OP_ADD.name, OP_ADD}, {OP_AND.name, OP_AND},
+const OpCode& OpCode::toOpCode(Symbol name)
+{
+    const OpCode& code = findOpCode(name);
+    if(code == OP_NOP && name != "nop")
+        throw CompilationError(CompilationStep::GENERAL, "No machine code operation for this op-code", name);
+    return code;
+}
+
+static const FastMap<std::string, OpCode> opCodes = {{OP_ADD.name, OP_ADD}, {OP_AND.name, OP_AND},
     {OP_ASR.name, OP_ASR}, {OP_CLZ.name, OP_CLZ}, {OP_FADD.name, OP_FADD}, {OP_FMAX.name, OP_FMAX},
     {OP_FMAXABS.name, OP_FMAXABS}, {OP_FMIN.name, OP_FMIN}, {OP_FMINABS.name, OP_FMINABS}, {OP_FMUL.name, OP_FMUL},
     {OP_FSUB.name, OP_FSUB}, {OP_FTOI.name, OP_FTOI}, {OP_ITOF.name, OP_ITOF}, {OP_MAX.name, OP_MAX},
@@ -1316,6 +1324,15 @@ static const std::multimap<std::string, OpCode> opCodes = {{OP_ADD.name, OP_ADD}
     {OP_V8ADDS.name, OP_V8ADDS}, {OP_V8MAX.name, OP_V8MAX}, {OP_V8MIN.name, OP_V8MIN}, {OP_V8MULD.name, OP_V8MULD},
     {OP_V8SUBS.name, OP_V8SUBS}, {OP_XOR.name, OP_XOR}};
 
+// The same op-codes as above, but looked up by their interned names, e.g. for intrinsic operations
+static const FastMap<Symbol, OpCode> opCodeSymbols = []() {
+    FastMap<Symbol, OpCode> symbols;
+    symbols.reserve(opCodes.size());
+    for(const auto& entry : opCodes)
+        symbols.emplace(Symbol{entry.first}, entry.second);
+    return symbols;
+}();
+
 // NOTE: The indices MUST correspond to the op-codes!
 static const std::array<OpCode, 32> addCodes = {OP_NOP, OP_FADD, OP_FSUB, OP_FMIN, OP_FMAX, OP_FMINABS, OP_FMAXABS,
     OP_FTOI, OP_ITOF, OP_NOP, OP_NOP, OP_NOP, OP_ADD, OP_SUB, OP_SHR, OP_ASR, OP_ROR, OP_SHL, OP_MIN, OP_MAX, OP_AND,
@@ -1395,6 +1412,14 @@ const OpCode& OpCode::findOpCode(const std::string& name)
     return OP_NOP;
 }
 
+const OpCode& OpCode::findOpCode(Symbol name)
+{
+    auto it = opCodeSymbols.find(name);
+    if(it != opCodeSymbols.end())
+        return it->second;
+    return OP_NOP;
+}
+
 Optional<Value> OpCode::getLeftIdentity(const OpCode& code)
 {
     if(code == OP_ADD)
@@ -25,6 +25,7 @@ namespace vc4c
     class SIMDVector;
     struct VectorFlags;
     struct OpCode;
+    class Symbol;
     enum class BranchCond : unsigned char;
 
     namespace analysis
@@ -857,6 +858,7 @@ namespace vc4c
          * Throws an exception if the op-code could not be found.
          */
         static const OpCode& toOpCode(const std::string& name);
+        static const OpCode& toOpCode(Symbol name);
         /*
          * Returns the op-code for the given code and whether the code is for the add or the mul ALU
          */
@@ -866,6 +868,7 @@ namespace vc4c
          * throwing an exception
          */
         static const OpCode& findOpCode(const std::string& name);
+        static const OpCode& findOpCode(Symbol name);
 
         /*
          * Returns the left-identity value for the given op-code
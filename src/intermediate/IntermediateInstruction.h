@@ -8,6 +8,7 @@
 #define INTERMEDIATEINSTRUCTION_H
 
 #include "../Method.h"
+#include "../Symbol.h"
 #include "../asm/OpCodes.h"
 #include "CompilationError.h"
 #include "Optional.h"
@@ -410,9 +411,9 @@ namespace vc4c
          */
         struct IntrinsicOperation : public IntermediateInstruction
         {
-            IntrinsicOperation(std::string&& opCode, Value&& dest, Value&& arg0, ConditionCode cond = COND_ALWAYS,
+            IntrinsicOperation(Symbol opCode, Value&& dest, Value&& arg0, ConditionCode cond = COND_ALWAYS,
                 SetFlag setFlags = SetFlag::DONT_SET);
-            IntrinsicOperation(std::string&& opCode, Value&& dest, Value&& arg0, Value&& arg1,
+            IntrinsicOperation(Symbol opCode, Value&& dest, Value&& arg0, Value&& arg1,
                 ConditionCode cond = COND_ALWAYS, SetFlag setFlags = SetFlag::DONT_SET);
             ~IntrinsicOperation() override = default;
 
@@ -427,7 +428,7 @@ namespace vc4c
             const Value& getFirstArg() const;
             const Optional<Value> getSecondArg() const;
 
-            std::string opCode;
+            Symbol opCode;
 
         protected:
             bool innerEquals(const IntermediateInstruction& other) const override;
@@ -435,8 +436,8 @@ namespace vc4c
 
         struct MethodCall final : public IntermediateInstruction
         {
-            explicit MethodCall(std::string&& methodName, std::vector<Value>&& args = {});
-            MethodCall(Value&& dest, std::string&& methodName, std::vector<Value>&& args = {});
+            explicit MethodCall(Symbol methodName, std::vector<Value>&& args = {});
+            MethodCall(Value&& dest, Symbol methodName, std::vector<Value>&& args = {});
             ~MethodCall() override = default;
 
             std::string to_string() const override;
@@ -450,7 +451,7 @@ namespace vc4c
 
             bool matchesSignature(const Method& method) const;
 
-            std::string methodName;
+            Symbol methodName;
 
         protected:
             bool innerEquals(const IntermediateInstruction& other) const override;
@@ -697,7 +698,7 @@ namespace vc4c
         struct Comparison final : public IntrinsicOperation
         {
         public:
-            Comparison(std::string&& comp, Value&& dest, Value&& val0, Value&& val1);
+            Comparison(Symbol comp, Value&& dest, Value&& val0, Value&& val1);
             ~Comparison() override = default;
 
             IntermediateInstruction* copyFor(
@@ -11,15 +11,15 @@
 using namespace vc4c;
 using namespace vc4c::intermediate;
 
-MethodCall::MethodCall(std::string&& methodName, std::vector<Value>&& args) :
-    IntermediateInstruction(Optional<Value>{}), methodName(std::move(methodName))
+MethodCall::MethodCall(Symbol methodName, std::vector<Value>&& args) :
+    IntermediateInstruction(Optional<Value>{}), methodName(methodName)
 {
     for(std::size_t i = 0; i < args.size(); ++i)
         setArgument(i, std::move(args[i]));
 }
 
-MethodCall::MethodCall(Value&& dest, std::string&& methodName, std::vector<Value>&& args) :
-    IntermediateInstruction(std::move(dest)), methodName(std::move(methodName))
+MethodCall::MethodCall(Value&& dest, Symbol methodName, std::vector<Value>&& args) :
+    IntermediateInstruction(std::move(dest)), methodName(methodName)
 {
     for(std::size_t i = 0; i < args.size(); ++i)
         setArgument(i, std::move(args[i]));
@@ -29,7 +29,7 @@ LCOV_EXCL_START
 std::string MethodCall::to_string() const
 {
     std::string signature = (getReturnType() == TYPE_VOID ? "" : getOutput()->to_string(true) + " = ") +
-        (getReturnType().to_string() + " ") + methodName + "(";
+        (getReturnType().to_string() + " ") + methodName.to_string() + "(";
     if(!getArguments().empty())
     {
         for(const Value& arg : getArguments())
@@ -55,10 +55,10 @@ IntermediateInstruction* MethodCall::copyFor(
     }
     if(getOutput())
         return (new MethodCall(renameValue(method, getOutput().value(), localPrefix, localMapping),
-                    std::string(methodName), std::move(newArgs)))
+                    methodName, std::move(newArgs)))
             ->copyExtrasFrom(this);
     else
-        return (new MethodCall(std::string(methodName), std::move(newArgs)))->copyExtrasFrom(this);
+        return (new MethodCall(methodName, std::move(newArgs)))->copyExtrasFrom(this);
 }
 
 qpu_asm::DecoratedInstruction MethodCall::convertToAsm(const FastMap<const Local*, Register>& registerMapping,
@@ -412,7 +412,7 @@ bool Operation::innerEquals(const IntermediateInstruction& other) const
 }
 
 IntrinsicOperation::IntrinsicOperation(
-    std::string&& opCode, Value&& dest, Value&& arg0, const ConditionCode cond, const SetFlag setFlags) :
+    Symbol opCode, Value&& dest, Value&& arg0, const ConditionCode cond, const SetFlag setFlags) :
     IntermediateInstruction(std::move(dest), cond, setFlags),
     opCode(opCode)
 {
@@ -420,7 +420,7 @@ IntrinsicOperation::IntrinsicOperation(
 }
 
 IntrinsicOperation::IntrinsicOperation(
-    std::string&& opCode, Value&& dest, Value&& arg0, Value&& arg1, const ConditionCode cond, const SetFlag setFlags) :
+    Symbol opCode, Value&& dest, Value&& arg0, Value&& arg1, const ConditionCode cond, const SetFlag setFlags) :
     IntermediateInstruction(std::move(dest), cond, setFlags),
     opCode(opCode)
 {
@@ -431,7 +431,7 @@ IntrinsicOperation::IntrinsicOperation(
 LCOV_EXCL_START
 std::string IntrinsicOperation::to_string() const
 {
-    return (getOutput()->to_string(true) + " = ") + (opCode + " ") + getFirstArg().to_string() +
+    return (getOutput()->to_string(true) + " = ") + (opCode.to_string() + " ") + getFirstArg().to_string() +
         (getSecondArg() ? std::string(", ") + assertArgument(1).to_string() : "") + createAdditionalInfoString();
 }
 LCOV_EXCL_STOP
@@ -440,14 +440,12 @@ IntermediateInstruction* IntrinsicOperation::copyFor(
     Method& method, const std::string& localPrefix, InlineMapping& localMapping) const
 {
     if(!getSecondArg())
-        return (new IntrinsicOperation(std::string(opCode),
-                    renameValue(method, getOutput().value(), localPrefix, localMapping),
+        return (new IntrinsicOperation(opCode, renameValue(method, getOutput().value(), localPrefix, localMapping),
                     renameValue(method, getFirstArg(), localPrefix, localMapping), conditional, setFlags))
             ->copyExtrasFrom(this);
-    return (
-        new IntrinsicOperation(std::string(opCode), renameValue(method, getOutput().value(), localPrefix, localMapping),
-            renameValue(method, getFirstArg(), localPrefix, localMapping),
-            renameValue(method, assertArgument(1), localPrefix, localMapping), conditional, setFlags))
+    return (new IntrinsicOperation(opCode, renameValue(method, getOutput().value(), localPrefix, localMapping),
+                renameValue(method, getFirstArg(), localPrefix, localMapping),
+                renameValue(method, assertArgument(1), localPrefix, localMapping), conditional, setFlags))
         ->copyExtrasFrom(this);
 }
 
@@ -785,15 +783,15 @@ bool Nop::innerEquals(const IntermediateInstruction& other) const
     return false;
 }
 
-Comparison::Comparison(std::string&& comp, Value&& dest, Value&& val0, Value&& val1) :
-    IntrinsicOperation(std::move(comp), std::move(dest), std::move(val0), std::move(val1))
+Comparison::Comparison(Symbol comp, Value&& dest, Value&& val0, Value&& val1) :
+    IntrinsicOperation(comp, std::move(dest), std::move(val0), std::move(val1))
 {
 }
 
 IntermediateInstruction* Comparison::copyFor(
     Method& method, const std::string& localPrefix, InlineMapping& localMapping) const
 {
-    return (new Comparison(std::string(opCode), renameValue(method, getOutput().value(), localPrefix, localMapping),
+    return (new Comparison(opCode, renameValue(method, getOutput().value(), localPrefix, localMapping),
                 renameValue(method, getFirstArg(), localPrefix, localMapping),
                 renameValue(method, assertArgument(1), localPrefix, localMapping)))
         ->copyExtrasFrom(this);
@@ -10,7 +10,11 @@
 #include "log.h"
 #include "operators.h"
 
+#include <algorithm>
+#include <array>
+#include <bitset>
 #include <map>
+#include <mutex>
 #include <sstream>
 
 using namespace vc4c;
@@ -316,6 +320,98 @@ static NODISCARD InstructionWalker insertDynamicVectorShuffle2Vectors(Instructio
     return it;
 }
 
+namespace
+{
+    /*
+     * A single step of shuffling vectors with a constant mask: Rotates the source vector down by the given offset and
+     * inserts the selected elements into the result vector.
+     */
+    struct ShuffleStep
+    {
+        uint8_t offset;
+        // 0 for the first source vector, 1 for the second one
+        uint8_t sourceIndex;
+        std::bitset<NATIVE_VECTOR_SIZE> elements;
+    };
+
+    /*
+     * The steps to shuffle vectors with a constant mask.
+     *
+     * If the first step is unconditional, it writes all elements of the result vector, the elements of all other
+     * steps are overwritten afterwards. The conditional steps are applied in pairs, sharing a single flag-setting
+     * mask load.
+     */
+    struct ShufflePlan
+    {
+        bool unconditionalFirstStep;
+        std::vector<ShuffleStep> steps;
+    };
+
+    /*
+     * The key to look up a shuffle plan: The 16 mask elements (UNDEFINED_SHUFFLE_INDEX for undefined elements), the
+     * width of the first source vector, the width of the result vector and whether the first step may be written
+     * unconditionally
+     */
+    using ShuffleMaskKey = std::array<uint8_t, NATIVE_VECTOR_SIZE + 3>;
+    constexpr uint8_t UNDEFINED_SHUFFLE_INDEX = 0xFF;
+
+    /*
+     * Caches the shuffle plans for constant masks, since the same masks (e.g. swizzles of vector3/vector4 types) are
+     * used over and over again.
+     *
+     * NOTE: Kernels can be compiled in parallel, so the accesses need to be synchronized.
+     */
+    struct ShufflePlanCache
+    {
+        std::mutex mutex;
+        std::map<ShuffleMaskKey, ShufflePlan> plans;
+    };
+} // namespace
+
+static ShufflePlan createShufflePlan(const ShuffleMaskKey& key)
+{
+    const auto firstVectorSize = key[NATIVE_VECTOR_SIZE];
+    const auto resultSize = key[NATIVE_VECTOR_SIZE + 1];
+    std::map<std::pair<uint8_t, uint8_t>, std::bitset<NATIVE_VECTOR_SIZE>> relativeSources;
+    for(uint8_t i = 0; i < NATIVE_VECTOR_SIZE; ++i)
+    {
+        if(key[i] == UNDEFINED_SHUFFLE_INDEX)
+            // don't write anything at this position
+            continue;
+        auto source = (key[i] >= firstVectorSize) ?
+            // source is from second vector
+            std::make_pair(static_cast<uint8_t>(rotateElementNumberDown(key[i] - firstVectorSize, i)), uint8_t{1}) :
+            // source is from first vector
+            std::make_pair(static_cast<uint8_t>(rotateElementNumberDown(key[i], i)), uint8_t{0});
+        relativeSources[source].set(i);
+    }
+
+    ShufflePlan plan{key[NATIVE_VECTOR_SIZE + 2] != 0, {}};
+    plan.steps.reserve(relativeSources.size());
+    for(const auto& entry : relativeSources)
+        plan.steps.emplace_back(ShuffleStep{entry.first.first, entry.first.second, entry.second});
+    if(plan.unconditionalFirstStep)
+        // write the step with the most elements unconditionally, so it does not need to be masked
+        std::stable_sort(plan.steps.begin(), plan.steps.end(), [](const ShuffleStep& one, const ShuffleStep& other) {
+            return one.elements.count() > other.elements.count();
+        });
+    else
+        // a single step writing all elements of the result vector does not need to be masked either
+        plan.unconditionalFirstStep = plan.steps.size() == 1 && plan.steps.front().elements.count() == resultSize;
+    return plan;
+}
+
+static const ShufflePlan& getShufflePlan(const ShuffleMaskKey& key)
+{
+    static ShufflePlanCache cache;
+    std::lock_guard<std::mutex> guard(cache.mutex);
+    auto it = cache.plans.find(key);
+    if(it == cache.plans.end())
+        // NOTE: std::map does not invalidate references to existing entries on insertion
+        it = cache.plans.emplace(key, createShufflePlan(key)).first;
+    return it->second;
+}
+
 static uint32_t toLowestIndex(uint32_t mask)
 {
     uint32_t index = 0;
@@ -408,81 +504,79 @@ InstructionWalker intermediate::insertVectorShuffle(InstructionWalker it, Method
         return insertReplication(it, tmp, destination);
     }
 
-    // copy source(s) into destination
-    // this allows us to skip extracting and inserting values from/to same index
-    // also required so register allocator finds unconditional write to destination
-    uint8_t numCorrespondingIndices = 0;
-    if(destination.checkLocal() && destination.local()->getUsers(LocalUse::Type::WRITER).empty())
-    {
-        if(isSingleSource || source0.type.getVectorWidth() + source1.type.getVectorWidth() > NATIVE_VECTOR_SIZE)
-        {
-            assign(it, destination) = source0;
-            numCorrespondingIndices = source0.type.getVectorWidth();
-        }
-        else
-        {
-            it = insertVectorConcatenation(it, method, source0, source1, destination);
-            numCorrespondingIndices =
-                static_cast<uint8_t>(source0.type.getVectorWidth() + source1.type.getVectorWidth());
-        }
-    }
-
     // mask is container of literals, indices have arbitrary order
     // For optimization, find combinations of elements to rotate together (same offset) from the same source vector
-    std::map<std::pair<uint8_t, uint8_t>, std::bitset<32>> relativeSources;
-    for(uint8_t i = 0; i < maskContainer.size(); ++i)
+    ShuffleMaskKey key;
+    key.fill(UNDEFINED_SHUFFLE_INDEX);
+    for(uint8_t i = 0; i < maskContainer.size() && i < NATIVE_VECTOR_SIZE; ++i)
     {
-        auto firstVectorSize = source0.type.getVectorWidth();
-        if(maskContainer[i].isUndefined())
-            // don't write anything at this position
-            continue;
-        if(maskContainer[i].unsignedInt() == i && i < numCorrespondingIndices)
-            // copies same element from and to same position, already done above
-            continue;
-        auto source = (maskContainer[i].unsignedInt() >= firstVectorSize) ?
-            // source is from second vector
-            std::make_pair(rotateElementNumberDown(maskContainer[i].unsignedInt() - firstVectorSize, i), 1) :
-            // source is from first vector
-            std::make_pair(rotateElementNumberDown(maskContainer[i].unsignedInt(), i), 0);
-        relativeSources[source] |= (1u << i);
+        if(!maskContainer[i].isUndefined())
+            key[i] = static_cast<uint8_t>(maskContainer[i].unsignedInt());
     }
-
-    for(const auto& sources : relativeSources)
+    key[NATIVE_VECTOR_SIZE] = static_cast<uint8_t>(source0.type.getVectorWidth());
+    key[NATIVE_VECTOR_SIZE + 1] = static_cast<uint8_t>(destination.type.getVectorWidth());
+    // if there is no other write to the destination, we can write the first step unconditionally.
+    // This is also required so register allocator finds unconditional write to destination
+    key[NATIVE_VECTOR_SIZE + 2] =
+        destination.checkLocal() && destination.local()->getUsers(LocalUse::Type::WRITER).empty() ? 1 : 0;
+    const auto& plan = getShufflePlan(key);
+
+    auto insertRotatedSource = [&](const ShuffleStep& step, const Value& dest) -> Value {
+        const Value& src = step.sourceIndex == 0 ? source0 : source1;
+        if(step.offset == 0)
+            return src;
+        auto tmp = dest.isUndefined() ? method.addNewLocal(destination.type, "%vector_shuffle") : dest;
+        // rotate source vector by the given offset
+        it = insertVectorRotation(it, src, Value(Literal(step.offset), TYPE_INT8), tmp, Direction::DOWN);
+        return tmp;
+    };
+
+    auto stepIt = plan.steps.begin();
+    if(plan.unconditionalFirstStep && stepIt != plan.steps.end())
+    {
+        auto tmp = insertRotatedSource(*stepIt, destination);
+        if(tmp != destination)
+            assign(it, destination) = tmp;
+        ++stepIt;
+    }
+    while(stepIt != plan.steps.end())
     {
-        const Value& src = sources.first.second == 0 ? source0 : source1;
-        if(sources.second.count() == destination.type.getVectorWidth())
+        const ShuffleStep& firstStep = *stepIt++;
+        const ShuffleStep* secondStep = stepIt != plan.steps.end() ? &*stepIt++ : nullptr;
+        auto firstTmp = insertRotatedSource(firstStep, UNDEFINED_VALUE);
+        auto secondTmp = secondStep ? insertRotatedSource(*secondStep, UNDEFINED_VALUE) : UNDEFINED_VALUE;
+        // set flags only for the selected elements
+        if(!secondStep && firstStep.elements.count() == 1)
         {
-            it = insertVectorRotation(
-                it, src, Value(Literal(sources.first.first), TYPE_INT8), destination, Direction::DOWN);
+            // for cosmetic purposes (and possible combination with other instructions), mask single elements via
+            // xoring small immediates
+            assign(it, NOP_REGISTER) = (ELEMENT_NUMBER_REGISTER ^
+                    Value(Literal(toLowestIndex(static_cast<uint32_t>(firstStep.elements.to_ulong()))), TYPE_INT8),
+                SetFlag::SET_FLAGS);
         }
         else
         {
-            auto tmp = method.addNewLocal(destination.type, "%vector_shuffle");
-            // rotate source vector by the given offset
-            it = insertVectorRotation(it, src, Value(Literal(sources.first.first), TYPE_INT8), tmp, Direction::DOWN);
-            // set flags only for the selected elements
-            ConditionCode cond = COND_NEVER;
-            if(sources.second.count() == 1)
+            // a single signed mask load selects the elements of both steps: zero flags for the elements of the first
+            // step, negative flags for the elements of the second step
+            SIMDVector selection(Literal(1));
+            for(uint8_t i = 0; i < NATIVE_VECTOR_SIZE; ++i)
             {
-                // for cosmetic purposes (and possible combination with other instructions), mask single elements via
-                // xoring small immediates
-                assign(it, NOP_REGISTER) = (ELEMENT_NUMBER_REGISTER ^
-                        Value(Literal(toLowestIndex(static_cast<uint32_t>(sources.second.to_ulong()))), TYPE_INT8),
-                    SetFlag::SET_FLAGS);
-                cond = COND_ZERO_SET;
+                if(firstStep.elements.test(i))
+                    selection[i] = Literal(0);
+                else if(secondStep && secondStep->elements.test(i))
+                    selection[i] = Literal(-1);
             }
-            else
-            {
-                it.emplace(new LoadImmediate(
-                    NOP_REGISTER, static_cast<uint32_t>(sources.second.to_ulong()), LoadType::PER_ELEMENT_UNSIGNED));
-                it->setSetFlags(SetFlag::SET_FLAGS);
-                it.nextInBlock();
-                cond = COND_ZERO_CLEAR;
-            }
-
-            // copy into destination only for the selected flags
-            assign(it, destination) = (tmp, cond);
+            it.emplace(new LoadImmediate(NOP_REGISTER,
+                LoadImmediate::fromLoadedValues(selection, LoadType::PER_ELEMENT_SIGNED),
+                LoadType::PER_ELEMENT_SIGNED));
+            it->setSetFlags(SetFlag::SET_FLAGS);
+            it.nextInBlock();
         }
+
+        // copy into destination only for the selected flags
+        assign(it, destination) = (firstTmp, COND_ZERO_SET);
+        if(secondStep)
+            assign(it, destination) = (secondTmp, COND_NEGATIVE_SET);
     }
     return it;
 }
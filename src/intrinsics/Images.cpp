@@ -32,15 +32,20 @@ const Value IMAGE_CONFIG_IMAGE_DEPTH_OFFSET = IMAGE_CONFIG_ARRAY_SIZE_OFFSET;
 
 Global* intermediate::reserveImageConfiguration(Module& module, Parameter& image)
 {
-    // TODO find a better/more central way to reserve space for image configurations (not in every front-end)
-    // XXX also make sure, a config for every image is only created once
     if(!image.type.getImageType())
         throw CompilationError(CompilationStep::GENERAL,
             "Can't reserve global data for image-configuration of non-image type", image.type.to_string());
+    const auto configName = ImageType::toImageConfigurationName(image.name);
+    for(Global& global : module.globalData)
+    {
+        if(global.name == configName)
+            // the configuration for this image is already reserved
+            return &global;
+    }
     CPPLOG_LAZY(logging::Level::DEBUG,
         log << "Reserving a buffer of " << IMAGE_CONFIG_NUM_UNIFORMS << " UNIFORMs for the image-configuration of "
             << image.to_string() << logging::endl);
-    auto it = module.globalData.emplace(module.globalData.end(), ImageType::toImageConfigurationName(image.name),
+    auto it = module.globalData.emplace(module.globalData.end(), configName,
         DataType(module.createPointerType(TYPE_INT32.toVectorType(IMAGE_CONFIG_NUM_UNIFORMS), AddressSpace::GLOBAL)),
         CompoundConstant(TYPE_INT32.toVectorType(IMAGE_CONFIG_NUM_UNIFORMS), Literal(0u)), false);
     return &(*it);
@@ -71,7 +76,7 @@ bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
 {
     if(auto callSite = it.get<MethodCall>())
     {
-        if(callSite->methodName.find("vc4cl_sampler_get_normalized_coords") != std::string::npos)
+        if(callSite->methodName.to_string().find("vc4cl_sampler_get_normalized_coords") != std::string::npos)
         {
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "Intrinsifying getting normalized-coordinates flag from sampler" << logging::endl);
@@ -79,7 +84,7 @@ bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
                 Value(Literal(Sampler::MASK_NORMALIZED_COORDS), TYPE_INT8)));
             return true;
         }
-        else if(callSite->methodName.find("vc4cl_sampler_get_addressing_mode") != std::string::npos)
+        else if(callSite->methodName.to_string().find("vc4cl_sampler_get_addressing_mode") != std::string::npos)
         {
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "Intrinsifying getting addressing-mode flag from sampler" << logging::endl);
@@ -87,7 +92,7 @@ bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
                 Value(Literal(Sampler::MASK_ADDRESSING_MODE), TYPE_INT8)));
             return true;
         }
-        else if(callSite->methodName.find("vc4cl_sampler_get_filter_mode") != std::string::npos)
+        else if(callSite->methodName.to_string().find("vc4cl_sampler_get_filter_mode") != std::string::npos)
         {
             CPPLOG_LAZY(
                 logging::Level::DEBUG, log << "Intrinsifying getting filter-mode flag from sampler" << logging::endl);
@@ -95,7 +100,7 @@ bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
                 Value(Literal(Sampler::MASK_FILTER_MODE), TYPE_INT8)));
             return true;
         }
-        else if(callSite->methodName.find("vc4cl_image_basic_setup") != std::string::npos)
+        else if(callSite->methodName.to_string().find("vc4cl_image_basic_setup") != std::string::npos)
         {
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "Intrinsifying getting image basic setup: " << callSite->assertArgument(0).to_string()
@@ -105,7 +110,7 @@ bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
             it.erase();
             return true;
         }
-        else if(callSite->methodName.find("vc4cl_image_access_setup") != std::string::npos)
+        else if(callSite->methodName.to_string().find("vc4cl_image_access_setup") != std::string::npos)
         {
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "Intrinsifying getting image access setup: " << callSite->assertArgument(0).to_string()
@@ -115,7 +120,7 @@ bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
             it.erase();
             return true;
         }
-        else if(callSite->methodName.find("vc4cl_image_extended_setup") != std::string::npos)
+        else if(callSite->methodName.to_string().find("vc4cl_image_extended_setup") != std::string::npos)
         {
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "Intrinsifying getting image extended setup: " << callSite->assertArgument(0).to_string()
@@ -125,7 +130,7 @@ bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
             it.erase();
             return true;
         }
-        else if(callSite->methodName.find("get_image_channel_data_type") != std::string::npos)
+        else if(callSite->methodName.to_string().find("get_image_channel_data_type") != std::string::npos)
         {
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "Generating query of image's channel data-type for image: "
@@ -134,7 +139,7 @@ bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
             it.erase();
             return true;
         }
-        else if(callSite->methodName.find("get_image_channel_order") != std::string::npos)
+        else if(callSite->methodName.to_string().find("get_image_channel_order") != std::string::npos)
         {
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "Generating query of image's channel order for image: "
@@ -144,7 +149,7 @@ bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
             // to not skip next instruction
             it.previousInBlock();
         }
-        else if(callSite->methodName.find("get_image_depth") != std::string::npos)
+        else if(callSite->methodName.to_string().find("get_image_depth") != std::string::npos)
         {
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "Generating query of image's depth for image: " << callSite->assertArgument(0).to_string()
@@ -154,7 +159,7 @@ bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
             it.erase();
             return true;
         }
-        else if(callSite->methodName.find("get_image_array_size") != std::string::npos)
+        else if(callSite->methodName.to_string().find("get_image_array_size") != std::string::npos)
         {
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "Generating query of image-array's size for image: " << callSite->assertArgument(0).to_string()
@@ -164,7 +169,7 @@ bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
             it.erase();
             return true;
         }
-        else if(callSite->methodName.find("__translate_sampler_initializer") == 0)
+        else if(callSite->methodName.to_string().find("__translate_sampler_initializer") == 0)
         {
             // new (LLVM 5.0+) way of converting sampler integer constants to sampler object
             // see: https://github.com/llvm-mirror/clang/commit/427517d1008ec4d8bae42449617edd7d7ee75852
@@ -179,13 +184,13 @@ bool intermediate::intrinsifyImageFunction(InstructionWalker it, Method& method)
             it.reset(new MoveOperation(out, it->assertArgument(0)));
             return true;
         }
-        else if(callSite->methodName.find("vc4cl_set_image_access_setup") != std::string::npos)
+        else if(callSite->methodName.to_string().find("vc4cl_set_image_access_setup") != std::string::npos)
         {
             // TODO
             it.erase();
             return true;
         }
-        else if(callSite->methodName.find("vc4cl_image_read") != std::string::npos)
+        else if(callSite->methodName.to_string().find("vc4cl_image_read") != std::string::npos)
         {
             // TODO other coordinates, other data
             it = periphery::insertReadTMU(
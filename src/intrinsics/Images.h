@@ -105,7 +105,11 @@ namespace vc4c
          * buffer.
          *
          * Returns the global the buffer is allocated at, to be used to set the UNIFORM pointer as well as to be set
-         * into the parameter-info.
+         * into the parameter-info. If the buffer for this image is already reserved, the existing global is returned.
+         *
+         * NOTE: This modifies the global data of the module and therefore must not be called while the kernels are
+         * compiled in parallel. The configurations are reserved for all kernel parameters in
+         * Normalizer#inlineFunctions().
          */
         Global* reserveImageConfiguration(Module& module, Parameter& image);
 
@@ -42,10 +42,39 @@ static const BinaryInstruction NO_OP2 = [](const Value& val0, const Value& val1)
 // see VC4CLStdLib (_intrinsics.h)
 static constexpr unsigned char VC4CL_UNSIGNED{1};
 
+// Interned names of the intrinsic operations and work-item functions handled below
+static const Symbol INTRINSIC_MOV{"mov"};
+static const Symbol INTRINSIC_MUL{"mul"};
+static const Symbol INTRINSIC_UDIV{"udiv"};
+static const Symbol INTRINSIC_SDIV{"sdiv"};
+static const Symbol INTRINSIC_UREM{"urem"};
+static const Symbol INTRINSIC_UMOD{"umod"};
+static const Symbol INTRINSIC_SREM{"srem"};
+static const Symbol INTRINSIC_FDIV{"fdiv"};
+static const Symbol INTRINSIC_TRUNC{"trunc"};
+static const Symbol INTRINSIC_FPTRUNC{"fptrunc"};
+static const Symbol INTRINSIC_ASHR{"ashr"};
+static const Symbol INTRINSIC_SITOFP{"sitofp"};
+static const Symbol INTRINSIC_UITOFP{"uitofp"};
+static const Symbol INTRINSIC_FPTOSI{"fptosi"};
+static const Symbol INTRINSIC_FPTOUI{"fptoui"};
+static const Symbol INTRINSIC_SEXT{"sext"};
+static const Symbol INTRINSIC_ZEXT{"zext"};
+static const Symbol INTRINSIC_FPEXT{"fpext"};
+static const Symbol INTRINSIC_FNEG{"fneg"};
+static const Symbol FUNCTION_WORK_DIMENSIONS{"vc4cl_work_dimensions"};
+static const Symbol FUNCTION_NUM_GROUPS{"vc4cl_num_groups"};
+static const Symbol FUNCTION_GROUP_ID{"vc4cl_group_id"};
+static const Symbol FUNCTION_GLOBAL_OFFSET{"vc4cl_global_offset"};
+static const Symbol FUNCTION_LOCAL_SIZE{"vc4cl_local_size"};
+static const Symbol FUNCTION_LOCAL_ID{"vc4cl_local_id"};
+static const Symbol FUNCTION_GLOBAL_SIZE{"vc4cl_global_size"};
+static const Symbol FUNCTION_GLOBAL_ID{"vc4cl_global_id"};
+
 using IntrinsicFunction = std::function<InstructionWalker(Method&, InstructionWalker, const MethodCall*)>;
 // NOTE: copying the captures is on purpose, since the sources do not exist anymore!
 
-static IntrinsicFunction intrinsifyUnaryALUInstruction(const std::string& opCode, const bool useSignFlag = false,
+static IntrinsicFunction intrinsifyUnaryALUInstruction(Symbol opCode, const bool useSignFlag = false,
     Pack packMode = PACK_NOP, Unpack unpackMode = UNPACK_NOP, bool setFlags = false)
 {
     return [opCode, useSignFlag, packMode, unpackMode, setFlags](
@@ -55,7 +84,7 @@ static IntrinsicFunction intrinsifyUnaryALUInstruction(const std::string& opCode
 
         CPPLOG_LAZY(logging::Level::DEBUG,
             log << "Intrinsifying unary '" << callSite->to_string() << "' to operation " << opCode << logging::endl);
-        if(opCode == "mov")
+        if(opCode == INTRINSIC_MOV)
             it.reset((new MoveOperation(callSite->getOutput().value(), callSite->assertArgument(0)))
                          ->copyExtrasFrom(callSite));
         else
@@ -76,7 +105,7 @@ static IntrinsicFunction intrinsifyUnaryALUInstruction(const std::string& opCode
     };
 }
 
-static IntrinsicFunction intrinsifyBinaryALUInstruction(const std::string& opCode, const bool useSignFlag = false,
+static IntrinsicFunction intrinsifyBinaryALUInstruction(Symbol opCode, const bool useSignFlag = false,
     Pack packMode = PACK_NOP, Unpack unpackMode = UNPACK_NOP, bool setFlags = false)
 {
     return [opCode, useSignFlag, packMode, unpackMode, setFlags](
@@ -491,7 +520,7 @@ static bool intrinsifyNoArgs(Method& method, InstructionWalker it)
     }
     for(const auto& pair : nonaryInstrinsics)
     {
-        if(callSite->methodName.find(pair.first) != std::string::npos)
+        if(callSite->methodName.to_string().find(pair.first) != std::string::npos)
         {
             pair.second.func(method, it, callSite);
             return true;
@@ -515,7 +544,7 @@ static bool intrinsifyUnary(Method& method, InstructionWalker it)
     Optional<Value> result = NO_VALUE;
     for(const auto& pair : unaryIntrinsicMapping)
     {
-        if(callSite->methodName.find(pair.first) != std::string::npos)
+        if(callSite->methodName.to_string().find(pair.first) != std::string::npos)
         {
             if((arg.getLiteralValue() || arg.checkVector()) && pair.second.unaryInstr &&
                 (result = pair.second.unaryInstr.value()(arg)))
@@ -533,7 +562,7 @@ static bool intrinsifyUnary(Method& method, InstructionWalker it)
     }
     for(const auto& pair : typeCastIntrinsics)
     {
-        if(callSite->methodName.find(pair.first) != std::string::npos)
+        if(callSite->methodName.to_string().find(pair.first) != std::string::npos)
         {
             // TODO support constant type-cast for constant containers
             if(arg.checkLiteral() && pair.second.first.unaryInstr &&
@@ -579,7 +608,7 @@ static bool intrinsifyBinary(Method& method, InstructionWalker it)
     }
     for(const auto& pair : binaryIntrinsicMapping)
     {
-        if(callSite->methodName.find(pair.first) != std::string::npos)
+        if(callSite->methodName.to_string().find(pair.first) != std::string::npos)
         {
             if(callSite->assertArgument(0).checkLiteral() && callSite->assertArgument(1).checkLiteral() &&
                 pair.second.binaryInstr &&
@@ -613,7 +642,7 @@ static bool intrinsifyTernary(Method& method, InstructionWalker it)
     }
     for(const auto& pair : ternaryIntrinsicMapping)
     {
-        if(callSite->methodName.find(pair.first) != std::string::npos)
+        if(callSite->methodName.to_string().find(pair.first) != std::string::npos)
         {
             pair.second.func(method, it, callSite);
             return true;
@@ -660,7 +689,7 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
     const Value& arg1 = op->getSecondArg().value_or(UNDEFINED_VALUE);
     const bool saturateResult = op->hasDecoration(InstructionDecorations::SATURATED_CONVERSION);
     // integer multiplication
-    if(op->opCode == "mul")
+    if(op->opCode == INTRINSIC_MUL)
     {
         // a * b = b * a
         if(arg0.getLiteralValue() && arg1.getLiteralValue())
@@ -741,6 +770,9 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
                 log << "Intrinsifying multiplication via binary method: " << op->to_string() << logging::endl);
             it = intrinsifyIntegerMultiplicationViaBinaryMethod(method, it, *op);
         }
+        else if(op->getOutput()->type.getScalarBitCount() > 32)
+            // 64-bit multiplication is lowered together with the other 64-bit operations, see LongOperations.cpp
+            return false;
         else if(std::all_of(op->getArguments().begin(), op->getArguments().end(), [](const Value& arg) -> bool {
                     return vc4c::analysis::ValueRange::getValueRange(arg).isUnsigned();
                 }))
@@ -755,7 +787,7 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
         return true;
     }
     // unsigned division
-    else if(op->opCode == "udiv")
+    else if(op->opCode == INTRINSIC_UDIV)
     {
         if(arg0.getLiteralValue() && arg1.getLiteralValue())
         {
@@ -788,12 +820,14 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
             // XXX is never used, LLVM always uses i32 for division??
             it = intrinsifyUnsignedIntegerDivisionByConstant(method, it, *op);
         }
+        else if(canOptimizeDivisionByInvariant(*op))
+            it = intrinsifyUnsignedIntegerDivisionByInvariant(method, it, *op);
         else
             it = intrinsifyUnsignedIntegerDivision(method, it, *op);
         return true;
     }
     // signed division
-    else if(op->opCode == "sdiv")
+    else if(op->opCode == INTRINSIC_SDIV)
     {
         if(arg0.getLiteralValue() && arg1.getLiteralValue())
         {
@@ -854,13 +888,15 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
                     it.reset(new Operation(OP_FTOI, op->getOutput().value(), resultFloat));
                 }
         */
+        else if(canOptimizeDivisionByInvariant(*op))
+            it = intrinsifySignedIntegerDivisionByInvariant(method, it, *op);
         else
             it = intrinsifySignedIntegerDivision(method, it, *op);
         return true;
     }
     // unsigned modulo
     // LLVM IR calls it urem, SPIR-V umod
-    else if(op->opCode == "urem" || op->opCode == "umod")
+    else if(op->opCode == INTRINSIC_UREM || op->opCode == INTRINSIC_UMOD)
     {
         if(arg0.getLiteralValue() && arg1.getLiteralValue())
         {
@@ -888,12 +924,14 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
         {
             it = intrinsifyUnsignedIntegerDivisionByConstant(method, it, *op, true);
         }
+        else if(canOptimizeDivisionByInvariant(*op))
+            it = intrinsifyUnsignedIntegerDivisionByInvariant(method, it, *op, true);
         else
             it = intrinsifyUnsignedIntegerDivision(method, it, *op, true);
         return true;
     }
     // signed modulo
-    else if(op->opCode == "srem")
+    else if(op->opCode == INTRINSIC_SREM)
     {
         if(arg0.getLiteralValue() && arg1.getLiteralValue())
         {
@@ -932,12 +970,14 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
         {
             it = intrinsifySignedIntegerDivisionByConstant(method, it, *op, true);
         }
+        else if(canOptimizeDivisionByInvariant(*op))
+            it = intrinsifySignedIntegerDivisionByInvariant(method, it, *op, true);
         else
             it = intrinsifySignedIntegerDivision(method, it, *op, true);
         return true;
     }
     // floating division
-    else if(op->opCode == "fdiv")
+    else if(op->opCode == INTRINSIC_FDIV)
     {
         if(arg0.getLiteralValue() && arg1.getLiteralValue())
         {
@@ -978,7 +1018,7 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
         return true;
     }
     // truncate bits
-    else if(op->opCode == "trunc")
+    else if(op->opCode == INTRINSIC_TRUNC)
     {
         if(saturateResult)
         {
@@ -1019,7 +1059,7 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
             throw CompilationError(CompilationStep::NORMALIZER, "Unhandled truncation", op->to_string());
         return true;
     }
-    else if(op->opCode == "fptrunc")
+    else if(op->opCode == INTRINSIC_FPTRUNC)
     {
         if(saturateResult)
         {
@@ -1032,7 +1072,7 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
         return true;
     }
     // arithmetic shift right
-    else if(op->opCode == "ashr")
+    else if(op->opCode == INTRINSIC_ASHR)
     {
         if(op->getFirstArg().type.getScalarBitCount() < 32)
         {
@@ -1052,7 +1092,7 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
         return true;
     }
     // integer to float
-    else if(op->opCode == "sitofp")
+    else if(op->opCode == INTRINSIC_SITOFP)
     {
         // for non 32-bit types, need to sign-extend
         Value tmp = op->getFirstArg();
@@ -1064,7 +1104,7 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
         it.reset(new Operation(OP_ITOF, op->getOutput().value(), tmp, op->conditional, op->setFlags));
         return true;
     }
-    else if(op->opCode == "uitofp")
+    else if(op->opCode == INTRINSIC_UITOFP)
     {
         const Value tmp = method.addNewLocal(op->getOutput()->type, "%uitofp");
         if(op->getFirstArg().type.getScalarBitCount() < 32)
@@ -1097,7 +1137,7 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
         return true;
     }
     // float to integer
-    else if(op->opCode == "fptosi")
+    else if(op->opCode == INTRINSIC_FPTOSI)
     {
         if(has_flag(op->decoration, intermediate::InstructionDecorations::SATURATED_CONVERSION))
         {
@@ -1113,7 +1153,7 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
         return true;
     }
     // float to unsigned integer
-    else if(op->opCode == "fptoui")
+    else if(op->opCode == INTRINSIC_FPTOUI)
     {
         if(has_flag(op->decoration, InstructionDecorations::SATURATED_CONVERSION))
         {
@@ -1150,7 +1190,7 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
         return true;
     }
     // sign extension
-    else if(op->opCode == "sext")
+    else if(op->opCode == INTRINSIC_SEXT)
     {
         CPPLOG_LAZY(logging::Level::DEBUG,
             log << "Intrinsifying sign extension with shifting: " << op->to_string() << logging::endl);
@@ -1161,7 +1201,7 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
         return true;
     }
     // zero extension
-    else if(op->opCode == "zext")
+    else if(op->opCode == INTRINSIC_ZEXT)
     {
         CPPLOG_LAZY(logging::Level::DEBUG,
             log << "Intrinsifying zero extension with and: " << op->to_string() << logging::endl);
@@ -1172,7 +1212,7 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
         return true;
     }
     // floating point conversion
-    else if(op->opCode == "fpext")
+    else if(op->opCode == INTRINSIC_FPEXT)
     {
         if(saturateResult)
         {
@@ -1184,7 +1224,7 @@ static bool intrinsifyArithmetic(Method& method, InstructionWalker it, const Mat
         it.erase();
         return true;
     }
-    else if(op->opCode == "fneg")
+    else if(op->opCode == INTRINSIC_FNEG)
     {
         CPPLOG_LAZY(logging::Level::DEBUG,
             log << "Intrinsifying unary floating-point negation to binary operation" << logging::endl);
@@ -1347,7 +1387,7 @@ static bool intrinsifyWorkItemFunctions(Method& method, InstructionWalker it)
     if(callSite->getArguments().size() > 1)
         return false;
 
-    if(callSite->methodName == "vc4cl_work_dimensions" && callSite->getArguments().empty())
+    if(callSite->methodName == FUNCTION_WORK_DIMENSIONS && callSite->getArguments().empty())
     {
         CPPLOG_LAZY(logging::Level::DEBUG, log << "Intrinsifying reading of work-item dimensions" << logging::endl);
         // setting the type to int8 allows us to optimize e.g. multiplications with work-item values
@@ -1362,7 +1402,7 @@ static bool intrinsifyWorkItemFunctions(Method& method, InstructionWalker it)
                         InstructionDecorations::WORK_GROUP_UNIFORM_VALUE))));
         return true;
     }
-    if(callSite->methodName == "vc4cl_num_groups" && callSite->getArguments().size() == 1)
+    if(callSite->methodName == FUNCTION_NUM_GROUPS && callSite->getArguments().size() == 1)
     {
         CPPLOG_LAZY(
             logging::Level::DEBUG, log << "Intrinsifying reading of the number of work-groups" << logging::endl);
@@ -1373,7 +1413,7 @@ static bool intrinsifyWorkItemFunctions(Method& method, InstructionWalker it)
                 InstructionDecorations::WORK_GROUP_UNIFORM_VALUE));
         return true;
     }
-    if(callSite->methodName == "vc4cl_group_id" && callSite->getArguments().size() == 1)
+    if(callSite->methodName == FUNCTION_GROUP_ID && callSite->getArguments().size() == 1)
     {
         CPPLOG_LAZY(logging::Level::DEBUG, log << "Intrinsifying reading of the work-group ids" << logging::endl);
         it = intrinsifyReadWorkGroupInfo(method, it, callSite->assertArgument(0),
@@ -1382,7 +1422,7 @@ static bool intrinsifyWorkItemFunctions(Method& method, InstructionWalker it)
                 InstructionDecorations::WORK_GROUP_UNIFORM_VALUE));
         return true;
     }
-    if(callSite->methodName == "vc4cl_global_offset" && callSite->getArguments().size() == 1)
+    if(callSite->methodName == FUNCTION_GLOBAL_OFFSET && callSite->getArguments().size() == 1)
     {
         CPPLOG_LAZY(logging::Level::DEBUG, log << "Intrinsifying reading of the global offsets" << logging::endl);
         it = intrinsifyReadWorkGroupInfo(method, it, callSite->assertArgument(0),
@@ -1393,19 +1433,19 @@ static bool intrinsifyWorkItemFunctions(Method& method, InstructionWalker it)
                 InstructionDecorations::WORK_GROUP_UNIFORM_VALUE));
         return true;
     }
-    if(callSite->methodName == "vc4cl_local_size" && callSite->getArguments().size() == 1)
+    if(callSite->methodName == FUNCTION_LOCAL_SIZE && callSite->getArguments().size() == 1)
     {
         CPPLOG_LAZY(logging::Level::DEBUG, log << "Intrinsifying reading of local work-item sizes" << logging::endl);
         it = intrinsifyReadLocalSize(method, it, callSite->assertArgument(0));
         return true;
     }
-    if(callSite->methodName == "vc4cl_local_id" && callSite->getArguments().size() == 1)
+    if(callSite->methodName == FUNCTION_LOCAL_ID && callSite->getArguments().size() == 1)
     {
         CPPLOG_LAZY(logging::Level::DEBUG, log << "Intrinsifying reading of local work-item ids" << logging::endl);
         it = intrinsifyReadLocalID(method, it, callSite->assertArgument(0));
         return true;
     }
-    if(callSite->methodName == "vc4cl_global_size" && callSite->getArguments().size() == 1)
+    if(callSite->methodName == FUNCTION_GLOBAL_SIZE && callSite->getArguments().size() == 1)
     {
         // global_size(dim) = local_size(dim) * num_groups(dim)
         CPPLOG_LAZY(logging::Level::DEBUG, log << "Intrinsifying reading of global work-item sizes" << logging::endl);
@@ -1429,7 +1469,7 @@ static bool intrinsifyWorkItemFunctions(Method& method, InstructionWalker it)
                              InstructionDecorations::WORK_GROUP_UNIFORM_VALUE))));
         return true;
     }
-    if(callSite->methodName == "vc4cl_global_id" && callSite->getArguments().size() == 1)
+    if(callSite->methodName == FUNCTION_GLOBAL_ID && callSite->getArguments().size() == 1)
     {
         // global_id(dim) = global_offset(dim) + (group_id(dim) * local_size(dim) + local_id(dim)
         CPPLOG_LAZY(logging::Level::DEBUG, log << "Intrinsifying reading of global work-item ids" << logging::endl);
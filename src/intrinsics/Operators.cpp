@@ -90,6 +90,37 @@ InstructionWalker intrinsics::intrinsifyUnsignedIntegerMultiplication(
     return it;
 }
 
+/*
+ * Inserts the calculation of the upper 32 bits of the unsigned 64-bit product of the given operands.
+ *
+ * Returns the two parts which need to be added to get the actual result, so the final addition can be merged into
+ * other instructions.
+ */
+static std::pair<Value, Value> insertUnsignedMultiplicationHighParts(
+    InstructionWalker& it, const Value& arg0, const Value& arg1, DataType outputType)
+{
+    auto arg0Hi = assign(it, outputType, "%mul_hi.arg0Hi") = as_unsigned{arg0} >> 16_val;
+    auto arg1Hi = assign(it, outputType, "%mul_hi.arg1Hi") = as_unsigned{arg1} >> 16_val;
+    auto arg0Lo = assign(it, outputType, "%mul_hi.arg0Lo") = arg0 & 0xFFFF_val;
+    auto arg1Lo = assign(it, outputType, "%mul_hi.arg1Lo") = arg1 & 0xFFFF_val;
+
+    auto resHiLo = assign(it, outputType, "%mul_hi.resHiLo") = mul24(arg0Hi, arg1Lo);
+    auto resLoHi = assign(it, outputType, "%mul_hi.resLoHi") = mul24(arg0Lo, arg1Hi);
+    auto resLo = assign(it, outputType, "%mul_hi.resLo") = mul24(arg0Lo, arg1Lo);
+    auto resOverflow = assign(it, outputType, "%mul_hi.of") = 0_val;
+    resLo = assign(it, outputType, "%mul_hi.resLo") = as_unsigned{resLo} >> 16_val;
+    auto resMid = assign(it, outputType, "%mul_hi.resMid") = (resHiLo + resLoHi, SetFlag::SET_FLAGS);
+    assign(it, resOverflow) = (resOverflow + 1_val, COND_CARRY_SET);
+    resMid = assign(it, outputType, "%mul_hi.resMid") = (resMid + resLo, SetFlag::SET_FLAGS);
+    assign(it, resOverflow) = (resOverflow + 1_val, COND_CARRY_SET);
+    resMid = assign(it, outputType, "%mul_hi.resMid") = as_unsigned{resMid} >> 16_val;
+    resOverflow = assign(it, outputType, "%mul_hi.of") = resOverflow << 16_val;
+    resMid = assign(it, outputType, "%mul_hi.resMid") = resMid + resOverflow;
+
+    auto resHi = assign(it, outputType, "%mul_hi.resHi") = mul24(arg0Hi, arg1Hi);
+    return std::make_pair(resMid, resHi);
+}
+
 InstructionWalker intrinsics::intrinsifyIntegerMultiplicationHighPart(
     Method& method, InstructionWalker it, const MethodCall* call)
 {
@@ -128,25 +159,9 @@ InstructionWalker intrinsics::intrinsifyIntegerMultiplicationHighPart(
     // we lose the upper 16 bits (2 * 24 = 48 > 32)!
 
     auto outputType = call->getOutput()->type;
-    auto arg0Hi = assign(it, outputType, "%mul_hi.arg0Hi") = as_unsigned{arg0} >> 16_val;
-    auto arg1Hi = assign(it, outputType, "%mul_hi.arg1Hi") = as_unsigned{arg1} >> 16_val;
-    auto arg0Lo = assign(it, outputType, "%mul_hi.arg0Lo") = arg0 & 0xFFFF_val;
-    auto arg1Lo = assign(it, outputType, "%mul_hi.arg1Lo") = arg1 & 0xFFFF_val;
-
-    auto resHiLo = assign(it, outputType, "%mul_hi.resHiLo") = mul24(arg0Hi, arg1Lo);
-    auto resLoHi = assign(it, outputType, "%mul_hi.resLoHi") = mul24(arg0Lo, arg1Hi);
-    auto resLo = assign(it, outputType, "%mul_hi.resLo") = mul24(arg0Lo, arg1Lo);
-    auto resOverflow = assign(it, outputType, "%mul_hi.of") = 0_val;
-    resLo = assign(it, outputType, "%mul_hi.resLo") = as_unsigned{resLo} >> 16_val;
-    auto resMid = assign(it, outputType, "%mul_hi.resMid") = (resHiLo + resLoHi, SetFlag::SET_FLAGS);
-    assign(it, resOverflow) = (resOverflow + 1_val, COND_CARRY_SET);
-    resMid = assign(it, outputType, "%mul_hi.resMid") = (resMid + resLo, SetFlag::SET_FLAGS);
-    assign(it, resOverflow) = (resOverflow + 1_val, COND_CARRY_SET);
-    resMid = assign(it, outputType, "%mul_hi.resMid") = as_unsigned{resMid} >> 16_val;
-    resOverflow = assign(it, outputType, "%mul_hi.of") = resOverflow << 16_val;
-    resMid = assign(it, outputType, "%mul_hi.resMid") = resMid + resOverflow;
-
-    auto resHi = assign(it, outputType, "%mul_hi.resHi") = mul24(arg0Hi, arg1Hi);
+    Value resMid = UNDEFINED_VALUE;
+    Value resHi = UNDEFINED_VALUE;
+    std::tie(resMid, resHi) = insertUnsignedMultiplicationHighParts(it, arg0, arg1, outputType);
 
     if(!isUnsigned)
     {
@@ -563,6 +578,188 @@ InstructionWalker intrinsics::intrinsifyUnsignedIntegerDivisionByConstant(
     return it;
 }
 
+/*
+ * The constants for the division by a run-time divisor via multiplication and shifts, see
+ * "Division by Invariant Integers using Multiplication" by Granlund and Montgomery, figure 4.1:
+ *
+ * t = mul_hi(magic, n)
+ * n / d = (t + ((n - t) >> shift1)) >> shift2
+ *
+ * with l = ceil(log2(d)), magic = floor(2^32 * (2^l - d) / d) + 1, shift1 = min(l, 1) and shift2 = max(l - 1, 0).
+ */
+struct InvariantDivisor
+{
+    Value divisor;
+    Value magic;
+    Value shift1;
+    Value shift2;
+};
+
+bool intrinsics::canOptimizeDivisionByInvariant(const IntrinsicOperation& op)
+{
+    // The divisor needs to be available before the first instruction of the kernel, to be able to calculate the
+    // constants only once per kernel execution
+    auto divisor = op.getSecondArg() & &Value::checkLocal;
+    auto param = divisor ? divisor->as<Parameter>() : nullptr;
+    return param && param->type.isScalarType() && param->type.getScalarBitCount() == 32 &&
+        !param->type.isFloatingType() && op.getFirstArg().type.getScalarBitCount() <= 32;
+}
+
+/*
+ * Returns the position at the very beginning of the kernel code to insert the calculations of the constants into
+ */
+static InstructionWalker getDivisionConstantsInsertionPoint(Method& method)
+{
+    return method.begin()->walk().nextInBlock();
+}
+
+/*
+ * Inserts the calculation of the constants for divisions by the given divisor at the given position (or returns the
+ * already calculated constants). The position needs to be behind the write of the divisor.
+ */
+static InvariantDivisor getInvariantDivisorConstants(Method& method, const Value& divisor, InstructionWalker it)
+{
+    const auto& name = divisor.local()->name;
+    InvariantDivisor result{divisor, method.createLocal(TYPE_INT32, name + ".udiv_magic")->createReference(),
+        method.createLocal(TYPE_INT32, name + ".udiv_shift1")->createReference(),
+        method.createLocal(TYPE_INT32, name + ".udiv_shift2")->createReference()};
+    if(!result.magic.local()->getUsers(LocalUse::Type::WRITER).empty())
+        // the constants for this divisor were already calculated for a previous division
+        return result;
+
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Calculating constants for divisions by " << divisor.to_string() << " at the start of the kernel"
+            << logging::endl);
+    // l = ceil(log2(d)) = 32 - clz(d - 1)
+    auto divisorMinusOne = assign(it, TYPE_INT32, "%udiv.magic") = (divisor - INT_ONE, SetFlag::SET_FLAGS);
+    auto leadingZeroes = assign(it, TYPE_INT32, "%udiv.magic") = OperationWrapper{OP_CLZ, divisorMinusOne};
+    auto ceilLog2 = assign(it, TYPE_INT32, "%udiv.magic") = 32_val - leadingZeroes;
+    assign(it, result.shift1) = min(as_signed{ceilLog2}, as_signed{INT_ONE});
+    auto log2MinusOne = assign(it, TYPE_INT32, "%udiv.magic") = ceilLog2 - INT_ONE;
+    assign(it, result.shift2) = max(as_signed{log2MinusOne}, as_signed{INT_ZERO});
+    // 2^l - d, calculated as (2^(l - 1) - d) + 2^(l - 1) to not overflow the shift for l = 32. For d = 1, l = 0 and
+    // 2^l - d = 0
+    auto halfPower = assign(it, TYPE_INT32, "%udiv.magic") = INT_ONE << log2MinusOne;
+    auto remainder = assign(it, TYPE_INT32, "%udiv.magic") = halfPower - divisor;
+    assign(it, remainder) = remainder + halfPower;
+    assign(it, remainder) = (INT_ZERO, COND_ZERO_SET);
+
+    /*
+     * Long division of remainder * 2^32 by d (with remainder < d, so the quotient fits into 32 bits):
+     * Doubling the remainder might overflow 32 bits, so the check (2 * remainder >= d) is done via the carry flag of
+     * (remainder + (2^32 - ceil(d / 2))) instead.
+     */
+    auto halfDivisor = assign(it, TYPE_INT32, "%udiv.magic") = as_unsigned{divisor} >> INT_ONE;
+    auto lowestBit = assign(it, TYPE_INT32, "%udiv.magic") = divisor & INT_ONE;
+    assign(it, halfDivisor) = halfDivisor + lowestBit;
+    auto negativeHalfDivisor = assign(it, TYPE_INT32, "%udiv.magic") = INT_ZERO - halfDivisor;
+    auto quotient = assign(it, TYPE_INT32, "%udiv.magic") = INT_ZERO;
+    for(unsigned i = 0; i < 32; ++i)
+    {
+        assignNop(it) = (remainder + negativeHalfDivisor, SetFlag::SET_FLAGS);
+        assign(it, remainder) = remainder << INT_ONE;
+        assign(it, remainder) = (remainder - divisor, COND_CARRY_SET);
+        assign(it, quotient) = quotient + quotient;
+        assign(it, quotient) = (quotient + INT_ONE, COND_CARRY_SET);
+    }
+    assign(it, result.magic) = quotient + INT_ONE;
+    return result;
+}
+
+/*
+ * Inserts the unsigned division of the numerator by the divisor with precalculated constants
+ */
+static InstructionWalker insertDivisionByInvariant(InstructionWalker it, const Value& numerator,
+    const InvariantDivisor& divisor, const Value& dest, bool useRemainder)
+{
+    auto type = numerator.type;
+    Value resMid = UNDEFINED_VALUE;
+    Value resHi = UNDEFINED_VALUE;
+    std::tie(resMid, resHi) = insertUnsignedMultiplicationHighParts(it, divisor.magic, numerator, type);
+    auto mulHigh = assign(it, type, "%udiv.mul_hi") = resMid + resHi;
+    auto tmp = assign(it, type, "%udiv.tmp") = numerator - mulHigh;
+    tmp = assign(it, type, "%udiv.tmp") = as_unsigned{tmp} >> divisor.shift1;
+    tmp = assign(it, type, "%udiv.tmp") = tmp + mulHigh;
+    if(!useRemainder)
+    {
+        it.reset(new Operation(OP_SHR, dest, tmp, divisor.shift2));
+        it->addDecorations(InstructionDecorations::UNSIGNED_RESULT);
+        return it;
+    }
+    auto quotient = assign(it, type, "%udiv.quotient") =
+        (as_unsigned{tmp} >> divisor.shift2, InstructionDecorations::UNSIGNED_RESULT);
+    // x mod y = x - (x/y) * y, where (x/y) * y <= x, so we only need the lower 32 bits of the product:
+    // a * b mod 2^32 = mul24(a, b) + ((mul24(a >> 24, b) + mul24(a, b >> 24)) << 24)
+    auto quotientHigh = assign(it, type, "%udiv.remainder") = as_unsigned{quotient} >> 24_val;
+    auto divisorHigh = assign(it, type, "%udiv.remainder") = as_unsigned{divisor.divisor} >> 24_val;
+    auto productLow = assign(it, type, "%udiv.remainder") = mul24(quotient, divisor.divisor);
+    auto productHigh0 = assign(it, type, "%udiv.remainder") = mul24(quotientHigh, divisor.divisor);
+    auto productHigh1 = assign(it, type, "%udiv.remainder") = mul24(quotient, divisorHigh);
+    auto productHigh = assign(it, type, "%udiv.remainder") = productHigh0 + productHigh1;
+    productHigh = assign(it, type, "%udiv.remainder") = productHigh << 24_val;
+    auto product = assign(it, type, "%udiv.remainder") = productLow + productHigh;
+    it.reset(new Operation(OP_SUB, dest, numerator, product));
+    it->addDecorations(InstructionDecorations::UNSIGNED_RESULT);
+    return it;
+}
+
+InstructionWalker intrinsics::intrinsifyUnsignedIntegerDivisionByInvariant(
+    Method& method, InstructionWalker it, IntrinsicOperation& op, bool useRemainder)
+{
+    if(!canOptimizeDivisionByInvariant(op))
+        throw CompilationError(
+            CompilationStep::NORMALIZER, "Can only optimize division by kernel parameter", op.to_string());
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Intrinsifying unsigned division by invariant value " << op.assertArgument(1).to_string()
+            << " via multiplication with precalculated constants" << logging::endl);
+    auto constants =
+        getInvariantDivisorConstants(method, op.assertArgument(1), getDivisionConstantsInsertionPoint(method));
+    return insertDivisionByInvariant(it, op.getFirstArg(), constants, op.getOutput().value(), useRemainder);
+}
+
+InstructionWalker intrinsics::intrinsifySignedIntegerDivisionByInvariant(
+    Method& method, InstructionWalker it, IntrinsicOperation& op, bool useRemainder)
+{
+    if(!canOptimizeDivisionByInvariant(op))
+        throw CompilationError(
+            CompilationStep::NORMALIZER, "Can only optimize division by kernel parameter", op.to_string());
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Intrinsifying signed division by invariant value " << op.assertArgument(1).to_string()
+            << " via multiplication with precalculated constants" << logging::endl);
+
+    // make the divisor positive once at the start of the kernel too
+    const auto& divisor = op.assertArgument(1);
+    auto divisorPos = method.createLocal(TYPE_INT32, divisor.local()->name + ".sdiv_abs")->createReference();
+    auto divisorSign = method.createLocal(TYPE_INT32, divisor.local()->name + ".sdiv_sign")->createReference();
+    // the constants depend on the positive divisor, so they need to be calculated behind it
+    auto insertIt = getDivisionConstantsInsertionPoint(method);
+    if(divisorPos.local()->getUsers(LocalUse::Type::WRITER).empty())
+    {
+        // see #insertMakePositive
+        assign(insertIt, divisorSign) = as_signed{divisor} >> 31_val;
+        auto tmp = assign(insertIt, TYPE_INT32, "%sdiv.abs") = divisor ^ divisorSign;
+        assign(insertIt, divisorPos) = (tmp - divisorSign, InstructionDecorations::UNSIGNED_RESULT);
+    }
+    auto constants = getInvariantDivisorConstants(method, divisorPos, insertIt);
+
+    Value opDest = op.getOutput().value();
+    Value numeratorSign = UNDEFINED_VALUE;
+    Value numeratorPos = method.addNewLocal(op.getFirstArg().type, "%unsigned");
+    it = insertMakePositive(it, method, op.getFirstArg(), numeratorPos, numeratorSign);
+
+    // use new temporary result, so we can store the final result in the correct value
+    const Value tmpDest = method.addNewLocal(opDest.type, "%result");
+    it = insertDivisionByInvariant(it, numeratorPos, constants, tmpDest, useRemainder);
+    it.nextInBlock();
+
+    if(useRemainder)
+        // For signed remainder (srem), the results sign only depends on the sign of the dividend!
+        return insertRestoreSign(it, method, tmpDest, opDest, numeratorSign);
+    // if exactly one operand was negative, invert sign of result
+    Value eitherSign = assign(it, numeratorSign.type) = numeratorSign ^ divisorSign;
+    return insertRestoreSign(it, method, tmpDest, opDest, eitherSign);
+}
+
 InstructionWalker intrinsics::intrinsifyFloatingDivision(Method& method, InstructionWalker it, IntrinsicOperation& op)
 {
     /*
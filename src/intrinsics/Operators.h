@@ -31,6 +31,13 @@ namespace vc4c
             Method& method, InstructionWalker it, intermediate::IntrinsicOperation& op, bool useRemainder = false);
         NODISCARD InstructionWalker intrinsifyUnsignedIntegerDivisionByConstant(
             Method& method, InstructionWalker it, intermediate::IntrinsicOperation& op, bool useRemainder = false);
+        // whether the divisor is invariant for the whole kernel execution, so the constants for the division by
+        // multiplication can be calculated once at the start of the kernel
+        bool canOptimizeDivisionByInvariant(const intermediate::IntrinsicOperation& op);
+        NODISCARD InstructionWalker intrinsifySignedIntegerDivisionByInvariant(
+            Method& method, InstructionWalker it, intermediate::IntrinsicOperation& op, bool useRemainder = false);
+        NODISCARD InstructionWalker intrinsifyUnsignedIntegerDivisionByInvariant(
+            Method& method, InstructionWalker it, intermediate::IntrinsicOperation& op, bool useRemainder = false);
 
         NODISCARD InstructionWalker intrinsifyFloatingDivision(
             Method& method, InstructionWalker it, intermediate::IntrinsicOperation& op);
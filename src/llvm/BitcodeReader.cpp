@@ -691,8 +691,6 @@ Method& BitcodeReader::parseFunction(Module& module, const llvm::Function& func)
             param.maxByteOffset = static_cast<std::size_t>(arg.getDereferenceableOrNullBytes());
 #endif
         CPPLOG_LAZY(logging::Level::DEBUG, log << "Reading parameter " << param.to_string(true) << logging::endl);
-        if(param.type.getImageType() && func.getCallingConv() == llvm::CallingConv::SPIR_KERNEL)
-            intermediate::reserveImageConfiguration(module, param);
         localMap[&arg] = &param;
     }
 
@@ -1460,7 +1458,7 @@ Value BitcodeReader::precalculateConstantExpression(Module& module, const llvm::
         }
     }
 
-    OpCode opCode = OpCode::findOpCode(expr->getOpcodeName());
+    OpCode opCode = OpCode::findOpCode(std::string{expr->getOpcodeName()});
 
     Optional<Value> result = NO_VALUE;
     if(opCode.numOperands == 1)
@@ -1544,6 +1542,13 @@ CompoundConstant BitcodeReader::toConstantGlobal(Module& module, const llvm::Val
     else if(auto constant = llvm::dyn_cast<const llvm::ConstantDataSequential>(val))
     {
         // vector/array constant, but packed in storage
+        if(CompoundConstant::isFlatStorageSupported(type))
+        {
+            // use the packed data directly instead of creating a constant per element. Negative elements are restored
+            // sign-extended, same as for scalar integer constants
+            auto rawData = constant->getRawDataValues();
+            return CompoundConstant(type, std::vector<uint8_t>(rawData.begin(), rawData.end()), true);
+        }
         std::vector<CompoundConstant> aggregate;
         aggregate.reserve(constant->getNumElements());
         for(unsigned i = 0; i < constant->getNumElements(); ++i)
@@ -67,6 +67,16 @@ static void printHelp()
               << "\tThe maximum number of iterations to repeat the optimizations in" << std::endl;
     std::cout << "\t--fcommon-subexpression-threshold=" << defaultConfig.additionalOptions.maxCommonExpressionDinstance
               << "\tThe maximum distance for two common subexpressions to be combined" << std::endl;
+    std::cout << "\t--funroll-threshold=" << defaultConfig.additionalOptions.maxUnrolledInstructions
+              << "\tThe maximum number of instructions of an unrolled loop body" << std::endl;
+    std::cout << "\t--floop-invariant-threshold=" << defaultConfig.additionalOptions.maxLoopInvariantLocals
+              << "\tThe maximum number of locals live throughout a loop to move loop-invariant code out of it"
+              << std::endl;
+    std::cout << "\t--fscheduler-pressure-threshold=" << defaultConfig.additionalOptions.maxSchedulerRegisterPressure
+              << "\tThe number of live locals at which the instruction scheduler starts reducing register pressure"
+              << std::endl;
+    std::cout << "\t--fcombine-distance-threshold=" << defaultConfig.additionalOptions.maxCombinationDistance
+              << "\tThe maximum distance of two instructions to be combined into a single instruction" << std::endl;
 
     std::cout << "options:" << std::endl;
     std::cout << "\t--kernel-info\t\tWrite the kernel-info meta-data (as required by VC4CL run-time, default)"
@@ -76,6 +86,19 @@ static void printHelp()
     std::cout << "\t--llvm\t\t\tExplicitely use the LLVM-IR front-end" << std::endl;
     std::cout << "\t--verification-error\tAbort if instruction verification failed" << std::endl;
     std::cout << "\t--no-verification-error\tContinue if instruction verification failed" << std::endl;
+    std::cout << "\t--multi-threading\tRun two hardware threads per QPU, switching threads on memory loads"
+              << std::endl;
+    std::cout << "\t--no-multi-threading\tRun a single hardware thread per QPU (default)" << std::endl;
+    std::cout << "\t--vpm-cache\t\tCache global memory accessed in small loops in VPM, write back after the loop"
+              << std::endl;
+    std::cout << "\t--no-vpm-cache\t\tAccess global memory in RAM for every single load and store (default)"
+              << std::endl;
+    std::cout << "\t--profile=<file>\tUse the block execution counts from the given profile (e.g. written by the "
+                 "tuner) for optimizations"
+              << std::endl;
+    std::cout << "\t--options=<file>\tApply the options from the given file (e.g. written by the tuner), one option "
+                 "per line, lines starting with '#' are ignored"
+              << std::endl;
     std::cout << "\tany other option is passed to the pre-compiler" << std::endl;
 
     std::cout << "modes:" << std::endl;
@@ -16,24 +16,61 @@
 using namespace vc4c;
 using namespace vc4c::normalization;
 
-static const Method* matchSignatures(
-    const std::vector<std::unique_ptr<Method>>& methods, const intermediate::MethodCall* callSignature)
+static uint64_t toSignatureKey(const Symbol& name, std::size_t numParameters)
 {
-    for(const auto& m : methods)
+    return (static_cast<uint64_t>(name.getID()) << 32) | static_cast<uint64_t>(numParameters);
+}
+
+FunctionIndex::FunctionIndex(const Module& module) : module(module)
+{
+    functions.reserve(module.methods.size());
+    for(const auto& m : module.methods)
+        functions[toSignatureKey(Symbol{m->name}, m->parameters.size())].push_back(m.get());
+}
+
+const Method* FunctionIndex::lookUp(const intermediate::MethodCall& call) const
+{
+    auto it = functions.find(toSignatureKey(call.methodName, call.getArguments().size()));
+    if(it == functions.end())
+        return nullptr;
+    for(const Method* m : it->second)
     {
-        if(callSignature->matchesSignature(*m))
+        if(call.matchesSignature(*m))
         {
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "Found method matching " << m->returnType.to_string() << ' ' << m->name << " with "
                     << m->parameters.size() << " arguments" << logging::endl);
-            return m.get();
+            return m;
         }
     }
     return nullptr;
 }
 
-static Method& inlineMethod(const std::string& localPrefix, const std::vector<std::unique_ptr<Method>>& methods,
-    const FastMap<std::string, std::string>& functionAliases, Method& currentMethod)
+const Method* FunctionIndex::findCalledMethod(intermediate::MethodCall& call) const
+{
+    // search for method with matching signature
+    if(auto calledMethod = lookUp(call))
+        return calledMethod;
+    // if not find directly, try aliasing
+    auto aliasIt = module.functionAliases.find(call.methodName);
+    if(aliasIt != module.functionAliases.end())
+    {
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Using alias '" << aliasIt->second << "' for call-site: " << call.to_string() << logging::endl);
+        // we need to rewrite the call-site function name, since this is checked in
+        // CallSite#matchesSignature(...)
+        call.methodName = aliasIt->second;
+        return lookUp(call);
+    }
+    return nullptr;
+}
+
+bool FunctionIndex::isInlined(const Method& method) const
+{
+    return inlinedFunctions.find(&method) != inlinedFunctions.end();
+}
+
+static void inlineMethod(FunctionIndex& index, Method& currentMethod, const Configuration& config)
 {
     auto it = currentMethod.walkAllInstructions();
     while(!it.isEndOfMethod())
@@ -41,35 +78,21 @@ static Method& inlineMethod(const std::string& localPrefix, const std::vector<st
         // Find all method calls
         if(auto call = it.get<intermediate::MethodCall>())
         {
-            // search for method with matching signature
-            auto calledMethod = matchSignatures(methods, call);
-            if(!calledMethod)
-            {
-                // if not find directly, try aliasing
-                auto aliasIt = functionAliases.find(call->methodName);
-                if(aliasIt != functionAliases.end())
-                {
-                    CPPLOG_LAZY(logging::Level::DEBUG,
-                        log << "Using alias '" << aliasIt->second << "' for call-site: " << call->to_string()
-                            << logging::endl);
-                    // we need to rewrite the call-site function name, since this is checked in
-                    // CallSite#matchesSignature(...)
-                    call->methodName = aliasIt->second;
-                    calledMethod = matchSignatures(methods, call);
-                }
-            }
+            auto calledMethod = index.findCalledMethod(*call);
             if(calledMethod)
             {
                 const std::size_t numInstructions = currentMethod.countInstructions();
-                // recursively search for used methods
-                const std::string newLocalPrefix = localPrefix +
+                // in-line all calls within the called method first, this is only done once per called method
+                if(!index.isInlined(*calledMethod))
+                    inlineMethods(index, const_cast<Method&>(*calledMethod), config);
+                // at this point, the called method has already inlined all other methods
+
+                const std::string newLocalPrefix =
                     (!(call->getReturnType() == TYPE_VOID) ?
                             call->getOutput()->local()->name :
                             std::string("%") + (calledMethod->name + ".") + std::to_string(rand())) +
                     '.';
                 const Local* methodEndLabel = currentMethod.createLocal(TYPE_LABEL, newLocalPrefix + "after");
-                inlineMethod(newLocalPrefix, methods, functionAliases, const_cast<Method&>(*calledMethod));
-                // at this point, the called method has already inlined all other methods
 
                 intermediate::InlineMapping mapping;
                 // the number of instructions is a good guess for the number of locals used
@@ -165,15 +188,18 @@ static Method& inlineMethod(const std::string& localPrefix, const std::vector<st
         }
         it.nextInMethod();
     }
-
-    return currentMethod;
 }
 
-void normalization::inlineMethods(const Module& module, Method& kernel, const Configuration& config)
+void normalization::inlineMethods(FunctionIndex& index, Method& method, const Configuration& config)
 {
+    if(index.isInlined(method))
+        return;
+    if(!index.currentFunctions.emplace(&method).second)
+        throw CompilationError(CompilationStep::NORMALIZER, "Recursive function calls are not supported", method.name);
     CPPLOG_LAZY(logging::Level::INFO, log << "-----" << logging::endl);
-    CPPLOG_LAZY(logging::Level::INFO, log << "Inlining functions for kernel: " << kernel.name << logging::endl);
-    // Starting at kernel
-    inlineMethod("", module.methods, module.functionAliases, kernel);
+    CPPLOG_LAZY(logging::Level::INFO, log << "Inlining functions for: " << method.name << logging::endl);
+    inlineMethod(index, method, config);
+    index.currentFunctions.erase(&method);
+    index.inlinedFunctions.emplace(&method);
     CPPLOG_LAZY(logging::Level::INFO, log << "-----" << logging::endl);
 }
@@ -7,15 +7,71 @@
 #ifndef INLINER_H
 #define INLINER_H
 
+#include "../performance.h"
+
+#include <cstdint>
+#include <vector>
+
 namespace vc4c
 {
     class Method;
     class Module;
     struct Configuration;
 
+    namespace intermediate
+    {
+        struct MethodCall;
+    } // namespace intermediate
+
     namespace normalization
     {
-        void inlineMethods(const Module& module, Method& kernel, const Configuration& config);
+        /*
+         * Index over all functions of a module used to look up the callees of function-calls while in-lining.
+         *
+         * The functions are grouped by their name and number of parameters, so resolving a call only needs to check
+         * the (usually single) function with the same signature instead of all functions of the module.
+         *
+         * The index also remembers the functions which already had all their function-calls in-lined, so every
+         * (library) function is only processed once, independent of the number of call-sites and kernels using it.
+         *
+         * NOTE: The index is not thread-safe and needs to be re-created if the functions of the module change.
+         */
+        class FunctionIndex
+        {
+        public:
+            explicit FunctionIndex(const Module& module);
+
+            /*
+             * Returns the function called by the given call-site or nullptr if no such function exists.
+             *
+             * If the function is not found directly, the function aliases of the module are checked. In this case, the
+             * name of the called function is updated to the aliased name.
+             */
+            const Method* findCalledMethod(intermediate::MethodCall& call) const;
+
+            /*
+             * Returns whether all function-calls in the given function have already been in-lined
+             */
+            bool isInlined(const Method& method) const;
+
+        private:
+            const Module& module;
+            FastMap<uint64_t, std::vector<const Method*>> functions;
+            FastSet<const Method*> inlinedFunctions;
+            FastSet<const Method*> currentFunctions;
+
+            const Method* lookUp(const intermediate::MethodCall& call) const;
+
+            friend void inlineMethods(FunctionIndex& index, Method& method, const Configuration& config);
+        };
+
+        /*
+         * In-lines all function-calls in the given function.
+         *
+         * The callees are processed bottom-up in the call-graph, i.e. all calls within a callee are in-lined (once)
+         * before the callee itself is in-lined into its call-sites.
+         */
+        void inlineMethods(FunctionIndex& index, Method& method, const Configuration& config);
     } // namespace normalization
 } // namespace vc4c
 
@@ -6,15 +6,30 @@
 
 #include "LongOperations.h"
 
+#include "../analysis/ValueRange.h"
 #include "../intermediate/IntermediateInstruction.h"
 #include "../intermediate/TypeConversions.h"
 #include "../intermediate/operators.h"
 #include "log.h"
 
+#include <limits>
+
 using namespace vc4c;
 using namespace vc4c::normalization;
 using namespace vc4c::operators;
 
+static const Symbol INTRINSIC_MUL{"mul"};
+
+/*
+ * Returns whether the upper word of a 64-bit value is known to be zero, i.e. the value fits into 32-bit
+ */
+static bool isUpperWordZero(const Value& upper, const Method& method)
+{
+    if(auto lit = upper.getLiteralValue())
+        return lit->unsignedInt() == 0;
+    return analysis::ValueRange::getValueRange(upper, &method).getSingletonValue().value_or(-1.0) == 0.0;
+}
+
 static void lowerLongOperation(
     Method& method, InstructionWalker it, intermediate::Operation& op, const Configuration& config)
 {
@@ -68,6 +83,17 @@ static void lowerLongOperation(
         out = Local::getLocalData<MultiRegisterData>(outLocal);
     }
 
+    if(op.op == OP_SUB && (in1Low & &Value::getLiteralValue) && (in1Up & &Value::getLiteralValue))
+    {
+        // %a - constant => %a + -constant
+        auto constant = (static_cast<uint64_t>(in1Up->getLiteralValue()->unsignedInt()) << 32) |
+            in1Low->getLiteralValue()->unsignedInt();
+        constant = ~constant + 1;
+        in1Low = Value(Literal(static_cast<uint32_t>(constant & 0xFFFFFFFF)), in1Low->type);
+        in1Up = Value(Literal(static_cast<uint32_t>(constant >> 32)), in1Low->type);
+        op.op = OP_ADD;
+    }
+
     if(op.op == OP_ADD)
     {
         /*
@@ -85,20 +111,25 @@ static void lowerLongOperation(
     }
     else if(op.op == OP_SUB)
     {
-        // %a - %b => %a + -%b
-        // build two's complement by inverting all bits and adding one
-        auto tmp = assign(it, op.getSecondArg()->type) = (~op.getSecondArg().value(), op.conditional, op.decoration);
-        auto firstIt = it.copy().previousInBlock();
-        tmp = assign(it, op.getSecondArg()->type) = (tmp + 1_val, op.conditional, op.decoration);
-        auto secondIt = it.copy().previousInBlock();
+        /*
+         * 64-bit subtract is %a + -%b with the two's complement -%b calculated directly:
+         * %neg.lower = 0 - %b.lower (set zero flag)
+         * %neg.upper = ~%b.upper
+         * %neg.upper = %neg.upper + 1 (if zero flag set, since only then the +1 of the complement carries over)
+         * %out.lower = %a.lower + %neg.lower (set carry flag)
+         * %tmp = %a.upper + %neg.upper
+         * %out.upper = %tmp + carry bit
+         */
+        auto negLow = assign(it, out->lower->type, "%sub.neg") = (INT_ZERO - in1Low.value(), SetFlag::SET_FLAGS);
+        auto negUp = assign(it, out->upper->type, "%sub.neg") = ~in1Up.value();
+        assign(it, negUp) = (negUp + INT_ONE, COND_ZERO_SET);
+        assign(it, out->lower->createReference()) = (in0Low + negLow, SetFlag::SET_FLAGS, op.decoration);
+        assign(it, out->upper->createReference()) = (in0Up + negUp, op.decoration);
         op.op = OP_ADD;
-        op.setArgument(1, tmp);
-        // do the actual lowering for the newly added bitwise NOT and ADD operations
-        if(auto firstOp = firstIt.get<intermediate::Operation>())
-            lowerLongOperation(method, firstIt, *firstOp, config);
-        if(auto secondOp = secondIt.get<intermediate::Operation>())
-            lowerLongOperation(method, secondIt, *secondOp, config);
-        lowerLongOperation(method, it, op, config);
+        op.setOutput(out->upper->createReference());
+        op.setArgument(0, out->upper->createReference());
+        op.setArgument(1, INT_ONE);
+        op.setCondition(COND_CARRY_SET);
     }
     else if(op.op == OP_NOT)
     {
@@ -116,6 +147,39 @@ static void lowerLongOperation(
         op.setArgument(1, in1Up.value());
         // TODO this is wrong when flags are set!
     }
+    else if((op.op == OP_SHR || op.op == OP_ASR) && (in1Low & &Value::getLiteralValue))
+    {
+        // shift by constant, no need to select the calculation at run-time
+        auto offset = in1Low->getLiteralValue()->unsignedInt() & 63;
+        auto offsetType = TYPE_INT8.toVectorType(outLocal->type.getVectorWidth());
+        auto isSigned = op.op == OP_ASR;
+        if(offset >= 32)
+        {
+            // %out.lower = %a.upper >> (offset - 32), %out.upper = 0 (or sign-extension)
+            auto lowerOffset = Value(Literal(offset - 32), offsetType);
+            assign(it, out->lower->createReference()) =
+                isSigned ? (as_signed{in0Up} >> lowerOffset) : (as_unsigned{in0Up} >> lowerOffset);
+            op.setArgument(0, isSigned ? in0Up : INT_ZERO);
+            op.setArgument(1, Value(Literal(isSigned ? 31u : 0u), offsetType));
+        }
+        else if(offset == 0)
+        {
+            assign(it, out->lower->createReference()) = in0Low;
+            op.op = OP_OR;
+            op.setArgument(0, in0Up);
+            op.setArgument(1, in0Up);
+        }
+        else
+        {
+            // %out.lower = (%a.lower >> offset) | (%a.upper << (32 - offset)), %out.upper = %a.upper >> offset
+            auto tmpLow = assign(it, out->lower->type) = as_unsigned{in0Low} >> Value(Literal(offset), offsetType);
+            auto tmpUp = assign(it, out->upper->type) = in0Up << Value(Literal(32 - offset), offsetType);
+            assign(it, out->lower->createReference()) = tmpLow | tmpUp;
+            op.setArgument(0, in0Up);
+            op.setArgument(1, Value(Literal(offset), offsetType));
+        }
+        op.setOutput(out->upper->createReference());
+    }
     else if(op.op == OP_SHR || op.op == OP_ASR)
     {
         auto offsetType = TYPE_INT8.toVectorType(outLocal->type.getVectorWidth());
@@ -165,6 +229,37 @@ static void lowerLongOperation(
         op.setArgument(1, in1Low.value());
         op.setCondition(cond);
     }
+    else if(op.op == OP_SHL && (in1Low & &Value::getLiteralValue))
+    {
+        // shift by constant, no need to select the calculation at run-time
+        auto offset = in1Low->getLiteralValue()->unsignedInt() & 63;
+        auto offsetType = TYPE_INT8.toVectorType(outLocal->type.getVectorWidth());
+        if(offset >= 32)
+        {
+            // %out.lower = 0, %out.upper = %a.lower << (offset - 32)
+            assign(it, out->lower->createReference()) = INT_ZERO;
+            op.setArgument(0, in0Low);
+            op.setArgument(1, Value(Literal(offset - 32), offsetType));
+        }
+        else if(offset == 0)
+        {
+            assign(it, out->lower->createReference()) = in0Low;
+            op.op = OP_OR;
+            op.setArgument(0, in0Up);
+            op.setArgument(1, in0Up);
+        }
+        else
+        {
+            // %out.lower = %a.lower << offset, %out.upper = (%a.lower >> (32 - offset)) | (%a.upper << offset)
+            auto tmpLow = assign(it, out->lower->type) = as_unsigned{in0Low} >> Value(Literal(32 - offset), offsetType);
+            auto tmpUp = assign(it, out->upper->type) = in0Up << Value(Literal(offset), offsetType);
+            assign(it, out->lower->createReference()) = in0Low << Value(Literal(offset), offsetType);
+            op.op = OP_OR;
+            op.setArgument(0, tmpLow);
+            op.setArgument(1, tmpUp);
+        }
+        op.setOutput(out->upper->createReference());
+    }
     else if(op.op == OP_SHL)
     {
         auto offsetType = TYPE_INT8.toVectorType(outLocal->type.getVectorWidth());
@@ -271,6 +366,136 @@ static void lowerLongOperation(
     }
 }
 
+/*
+ * Returns the lower and upper word of the given 64-bit operand
+ */
+static std::pair<Value, Value> splitLongOperand(const Value& val)
+{
+    if(auto data = Local::getLocalData<MultiRegisterData>(val.checkLocal()))
+        return std::make_pair(data->lower->createReference(), data->upper->createReference());
+    Value lower = val;
+    if(lower.type.getScalarBitCount() > 32)
+        // see above, truncate the type of literal/vector operands
+        lower.type = TYPE_INT32.toVectorType(lower.type.getVectorWidth());
+    auto lit = val.getLiteralValue();
+    return std::make_pair(lower, lit && lit->type == LiteralType::LONG_LEADING_ONES ? INT_MINUS_ONE : INT_ZERO);
+}
+
+/*
+ * Returns whether the given 32-bit value is known to be an unsigned value fitting into 24 bits, i.e. can be used as
+ * full operand of a mul24 instruction
+ */
+static bool fitsIntoMul24(const Value& val, const Method& method)
+{
+    if(auto lit = val.getLiteralValue())
+        return lit->unsignedInt() < (1u << 24);
+    auto range = analysis::ValueRange::getValueRange(val, &method);
+    return range.isUnsigned() && range.maxValue < static_cast<double>(1u << 24);
+}
+
+/*
+ * Lowers a 64-bit integer multiplication.
+ *
+ * With a = a.upper * 2^32 + a.lower (and b accordingly), the lower 64 bits of the product are
+ * a.lower * b.lower + ((a.upper * b.lower + a.lower * b.upper) << 32),
+ * so only the full 64-bit product of the lower words and the lower 32 bits of the two cross terms are required. The
+ * cross terms are skipped completely for upper words known to be zero.
+ */
+static void lowerLongMultiplication(Method& method, InstructionWalker it, intermediate::IntrinsicOperation& op)
+{
+    auto out = Local::getLocalData<MultiRegisterData>(op.checkOutputLocal());
+    if(!out)
+        throw CompilationError(
+            CompilationStep::NORMALIZER, "Can only multiply 64-bit values into long locals", op.to_string());
+    if(op.hasConditionalExecution() || op.doesSetFlag())
+        throw CompilationError(
+            CompilationStep::NORMALIZER, "Unhandled conditional or flag-setting 64-bit multiplication", op.to_string());
+    auto in0 = splitLongOperand(op.getFirstArg());
+    auto in1 = splitLongOperand(op.assertArgument(1));
+    auto type = out->lower->type;
+    bool in0UpperZero = isUpperWordZero(in0.second, method);
+    bool in1UpperZero = isUpperWordZero(in1.second, method);
+
+    if(in0UpperZero && in1UpperZero && fitsIntoMul24(in0.first, method) && fitsIntoMul24(in1.first, method))
+    {
+        auto range0 = analysis::ValueRange::getValueRange(in0.first, &method);
+        auto range1 = analysis::ValueRange::getValueRange(in1.first, &method);
+        if(range0.maxValue * range1.maxValue <= static_cast<double>(std::numeric_limits<uint32_t>::max()))
+        {
+            // the product fits into the lower word, this is just a 32-bit multiplication
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Demoting 64-bit multiplication of small values to mul24: " << op.to_string() << logging::endl);
+            assign(it, out->lower->createReference()) = (mul24(in0.first, in1.first), op.decoration);
+            it.reset(
+                (new intermediate::MoveOperation(out->upper->createReference(), INT_ZERO))->copyExtrasFrom(it.get()));
+            return;
+        }
+    }
+
+    /*
+     * The full 64-bit product of the lower words is calculated from their 16-bit parts, similar to mul_hi:
+     * %lower = a[0] * b[0] + ((a[1] * b[0] + a[0] * b[1]) << 16)
+     * %upper = a[1] * b[1] + ((a[1] * b[0] + a[0] * b[1]) >> 16) + carries
+     */
+    auto a0 = assign(it, type, "%mul.a0") = in0.first & 0xFFFF_val;
+    auto a1 = assign(it, type, "%mul.a1") = as_unsigned{in0.first} >> 16_val;
+    auto b0 = assign(it, type, "%mul.b0") = in1.first & 0xFFFF_val;
+    auto b1 = assign(it, type, "%mul.b1") = as_unsigned{in1.first} >> 16_val;
+    auto resLo = assign(it, type, "%mul.resLo") = mul24(a0, b0);
+    auto resHiLo = assign(it, type, "%mul.resHiLo") = mul24(a1, b0);
+    auto resLoHi = assign(it, type, "%mul.resLoHi") = mul24(a0, b1);
+    auto resHi = assign(it, type, "%mul.resHi") = mul24(a1, b1);
+    auto resMid = assign(it, type, "%mul.resMid") = (resHiLo + resLoHi, SetFlag::SET_FLAGS);
+    // the carry of the middle part has the value 2^48, i.e. 2^16 in the upper word
+    assign(it, resHi) = (resHi + 0x10000_val, COND_CARRY_SET);
+    auto midLo = assign(it, type, "%mul.midLo") = resMid << 16_val;
+    auto midHi = assign(it, type, "%mul.midHi") = as_unsigned{resMid} >> 16_val;
+    assign(it, out->lower->createReference()) = (resLo + midLo, SetFlag::SET_FLAGS, op.decoration);
+    assign(it, resHi) = resHi + midHi;
+    assign(it, resHi) = (resHi + INT_ONE, COND_CARRY_SET);
+
+    FastAccessList<Value> upperParts{resHi};
+    {
+        /*
+         * The cross terms only contribute their lower 32 bits to the upper word, which are calculated as:
+         * x * y mod 2^32 = mul24(x, y) + ((mul24(x >> 24, y) + mul24(x, y >> 24)) << 24)
+         * The parts to be shifted are summed up first to only require a single shift.
+         */
+        Optional<Value> shiftedSum;
+        auto addShifted = [&](const Value& val) {
+            shiftedSum = shiftedSum ? (assign(it, type, "%mul.cross") = *shiftedSum + val) : val;
+        };
+        auto addCrossTerm = [&](const Value& x, const Value& y) {
+            upperParts.emplace_back(assign(it, type, "%mul.cross") = mul24(x, y));
+            if(!fitsIntoMul24(x, method))
+            {
+                auto xHi = assign(it, type, "%mul.cross") = as_unsigned{x} >> 24_val;
+                addShifted(assign(it, type, "%mul.cross") = mul24(xHi, y));
+            }
+            if(!fitsIntoMul24(y, method))
+            {
+                auto yHi = assign(it, type, "%mul.cross") = as_unsigned{y} >> 24_val;
+                addShifted(assign(it, type, "%mul.cross") = mul24(x, yHi));
+            }
+        };
+        if(!in0UpperZero)
+            addCrossTerm(in0.second, in1.first);
+        if(!in1UpperZero)
+            addCrossTerm(in0.first, in1.second);
+        if(shiftedSum)
+            upperParts.emplace_back(assign(it, type, "%mul.cross") = *shiftedSum << 24_val);
+    }
+
+    auto upper = upperParts.front();
+    for(std::size_t i = 1; i + 1 < upperParts.size(); ++i)
+        upper = assign(it, type, "%mul.upper") = upper + upperParts[i];
+    if(upperParts.size() > 1)
+        it.reset((new intermediate::Operation(OP_ADD, out->upper->createReference(), upper, upperParts.back()))
+                     ->copyExtrasFrom(it.get()));
+    else
+        it.reset((new intermediate::MoveOperation(out->upper->createReference(), upper))->copyExtrasFrom(it.get()));
+}
+
 void normalization::lowerLongOperation(
     const Module& module, Method& method, InstructionWalker it, const Configuration& config)
 {
@@ -331,6 +556,15 @@ void normalization::lowerLongOperation(
             move->setSource(src->upper->createReference());
         }
     }
+    else if(auto intrinsic = it.get<intermediate::IntrinsicOperation>())
+    {
+        if(intrinsic->opCode == INTRINSIC_MUL)
+        {
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Lowering 64-bit multiplication: " << intrinsic->to_string() << logging::endl);
+            lowerLongMultiplication(method, it, *intrinsic);
+        }
+    }
     else if(auto call = it.get<intermediate::MethodCall>())
     {
         CPPLOG_LAZY(
@@ -339,27 +573,27 @@ void normalization::lowerLongOperation(
         auto out = Local::getLocalData<MultiRegisterData>(outLoc);
         auto src = Local::getLocalData<MultiRegisterData>(call->assertArgument(0).checkLocal());
 
-        if(out && call->methodName.find("vc4cl_int_to_long") != std::string::npos)
+        if(out && call->methodName.to_string().find("vc4cl_int_to_long") != std::string::npos)
         {
             it = intermediate::insertSignExtension(it, method, call->assertArgument(0), outLoc->createReference(), true,
                 call->conditional, call->setFlags);
             it.erase();
         }
-        else if(out && call->methodName.find("vc4cl_int_to_ulong") != std::string::npos)
+        else if(out && call->methodName.to_string().find("vc4cl_int_to_ulong") != std::string::npos)
         {
             // see "zext" above
             it = intermediate::insertZeroExtension(it, method, call->assertArgument(0), outLoc->createReference(), true,
                 call->conditional, call->setFlags);
             it.erase();
         }
-        else if(src && call->methodName.find("vc4cl_long_to_int") != std::string::npos)
+        else if(src && call->methodName.to_string().find("vc4cl_long_to_int") != std::string::npos)
         {
             // TODO correct for signed??
             assign(it, call->getOutput().value()) =
                 (src->lower->createReference(), call->conditional, call->decoration);
             it.erase();
         }
-        else if(out && src && call->methodName.find("vc4cl_bitcast_long") != std::string::npos)
+        else if(out && src && call->methodName.to_string().find("vc4cl_bitcast_long") != std::string::npos)
         {
             // simple copy move -> copy the parts
             it.emplace(new intermediate::MoveOperation(out->lower->createReference(), src->lower->createReference()));
@@ -370,7 +604,7 @@ void normalization::lowerLongOperation(
             it.nextInBlock();
             it.erase();
         }
-        else if(out && src && call->methodName.find("vc4cl_bitcast_ulong") != std::string::npos)
+        else if(out && src && call->methodName.to_string().find("vc4cl_bitcast_ulong") != std::string::npos)
         {
             // simple copy move -> copy the parts
             it.emplace(new intermediate::MoveOperation(out->lower->createReference(), src->lower->createReference()));
@@ -9,8 +9,12 @@
 #include "../InstructionWalker.h"
 #include "../Module.h"
 #include "../Profiler.h"
+#include "../analysis/ControlFlowGraph.h"
+#include "../analysis/ControlFlowLoop.h"
+#include "../analysis/DataDependencyGraph.h"
 #include "../intermediate/IntermediateInstruction.h"
 #include "../intermediate/operators.h"
+#include "../optimization/ControlFlow.h"
 #include "../periphery/VPM.h"
 #include "AddressCalculation.h"
 #include "MemoryMappings.h"
@@ -24,124 +28,176 @@ using namespace vc4c::operators;
 
 // TODO make use of parameter's maxByteOffset? E.g. for caching?
 
-struct BaseAndOffset
+/*
+ * Symbolic representation of a memory address as linear combination of unknown values and a constant byte offset.
+ *
+ * This allows to determine the distance between two addresses, even if their absolute values are unknown at
+ * compile-time, e.g. for base + index * 4 and base + (index + 1) * 4.
+ */
+struct AddressExpression
 {
-    Optional<Value> base;
-    Optional<int32_t> offset;
+    // the unknown values (the value of a local at the start of the basic block or the result of an instruction which
+    // cannot be analyzed) and their factors
+    SortedMap<const void*, int64_t> factors;
+    int64_t offset = 0;
 
-    explicit BaseAndOffset() : base(NO_VALUE), offset{} {}
+    bool hasSameFactors(const AddressExpression& other) const
+    {
+        return factors == other.factors;
+    }
 
-    BaseAndOffset(const Optional<Value>& base, Optional<int32_t> offset) : base(base), offset(offset) {}
+    AddressExpression operator+(const AddressExpression& other) const
+    {
+        AddressExpression result = *this;
+        result.offset += other.offset;
+        for(const auto& factor : other.factors)
+        {
+            if((result.factors[factor.first] += factor.second) == 0)
+                result.factors.erase(factor.first);
+        }
+        return result;
+    }
+
+    AddressExpression operator*(int64_t factor) const
+    {
+        AddressExpression result;
+        if(factor == 0)
+            return result;
+        result.offset = offset * factor;
+        for(const auto& part : factors)
+            result.factors.emplace(part.first, part.second * factor);
+        return result;
+    }
 };
 
-static BaseAndOffset findOffset(const Value& val)
+/*
+ * Calculates the symbolic addresses accessed within a basic block
+ *
+ * The locals (re-)written within the block are tracked in order of the instructions, which allows to also handle e.g.
+ * unrolled loops, where the same locals are written once per iteration.
+ */
+class AddressEvaluator
 {
-    if(!val.checkLocal())
-        return BaseAndOffset();
-    if(auto writer = val.getSingleWriter())
+public:
+    explicit AddressEvaluator(BasicBlock& block)
     {
-        const Optional<Value> offset = writer->precalculate(8).first;
-        if(offset && offset->isLiteralValue())
+        for(auto it = block.walk(); !it.isEndOfBlock(); it.nextInBlock())
         {
-            return BaseAndOffset(NO_VALUE, offset->getLiteralValue()->signedInt());
+            if(it.has())
+                blockInstructions.emplace(it.get());
         }
     }
-    return BaseAndOffset();
-}
 
-static BaseAndOffset findBaseAndOffset(const Value& val)
-{
-    // TODO add support for offsets via getlocal/global_id, etc.
-    // need to the set base to addr + offset and the offset to the offset of the offset (e.g. param[get_local_id(0) +
-    // 7])  but how to determine?
-    if(!val.checkLocal())
-        return BaseAndOffset();
-    if(val.local()->is<Parameter>() || val.local()->is<Global>() || val.local()->is<StackAllocation>())
-        return BaseAndOffset(val, 0);
-
-    // follow the references
-    const Local* ref = val.local()->getBase(false);
-    if(ref != val.local())
-        return findBaseAndOffset(ref->createReference());
-    if(val.local()->reference.first != nullptr && val.local()->reference.second != ANY_ELEMENT)
-        return BaseAndOffset(val.local()->reference.first->createReference(), val.local()->reference.second);
-
-    const auto writers = val.local()->getUsers(LocalUse::Type::WRITER);
-    if(writers.size() != 1)
-        return BaseAndOffset();
-
-    // The reader can be one of several valid cases:
-    // 1. a move from another local -> need to follow the move
-    if(auto move = dynamic_cast<const MoveOperation*>(*writers.begin()))
-        return findBaseAndOffset(move->getSource());
-    const auto& args = (*writers.begin())->getArguments();
-    // 2. an addition with a local and a literal -> the local is the base, the literal the offset
-    if(dynamic_cast<const Operation*>((*writers.begin())) != nullptr &&
-        dynamic_cast<const Operation*>((*writers.begin()))->op == OP_ADD && args.size() == 2 &&
-        std::any_of(args.begin(), args.end(), [](const Value& arg) -> bool { return arg.checkLocal(); }) &&
-        std::any_of(
-            args.begin(), args.end(), [](const Value& arg) -> bool { return arg.getLiteralValue().has_value(); }))
-    {
-        return BaseAndOffset(
-            std::find_if(args.begin(), args.end(), [](const Value& arg) -> bool { return arg.checkLocal(); })
-                ->local()
-                ->getBase(false)
-                ->createReference(),
-            (*std::find_if(
-                 args.begin(), args.end(), [](const Value& arg) -> bool { return arg.getLiteralValue().has_value(); }))
-                    .getLiteralValue()
-                    ->signedInt() /
-                /* in-memory width can't be > 2^30 anyway */
-                static_cast<int32_t>(val.type.getElementType().getInMemoryWidth()));
-    }
-
-    // 3. an addition with two locals -> one is the base, the other the calculation of the literal
-    if(dynamic_cast<const Operation*>((*writers.begin())) != nullptr &&
-        dynamic_cast<const Operation*>((*writers.begin()))->op == OP_ADD && args.size() == 2 &&
-        std::all_of(args.begin(), args.end(), [](const Value& arg) -> bool { return arg.checkLocal(); }))
-    {
-        const auto offset0 = findOffset(args[0]);
-        const auto offset1 = findOffset(args[1]);
-        if(offset0.offset && args[1].checkLocal())
-            return BaseAndOffset(args[1].local()->getBase(false)->createReference(),
-                offset0.offset.value() / static_cast<int32_t>(val.type.getElementType().getInMemoryWidth()));
-        if(offset1.offset && args[0].checkLocal())
-            return BaseAndOffset(args[0].local()->getBase(false)->createReference(),
-                offset1.offset.value() / static_cast<int32_t>(val.type.getElementType().getInMemoryWidth()));
+    /*
+     * Tracks the value written by the given instruction, needs to be called for all instructions in order
+     */
+    void update(const IntermediateInstruction& inst)
+    {
+        if(auto loc = inst.checkOutputLocal())
+            currentValues[loc] = evaluate(inst, 0, false);
+    }
+
+    Optional<AddressExpression> operator()(const Value& val) const
+    {
+        return evaluate(val, 0, false);
     }
+
+private:
+    // limits the depth of following the writers of locals not written in the basic block
+    static constexpr unsigned MAX_DEPTH = 8;
+    FastSet<const IntermediateInstruction*> blockInstructions;
+    FastMap<const Local*, AddressExpression> currentValues;
+
     /*
-        if(writers.size() == 1)
+     * The current values of the locals (re-)written in the block only apply to reads within the block. An instruction
+     * outside of the block might have read another value of the same local, so for these instructions (if
+     * outsideOfBlock is set), only literals and locals with a single writer outside of the block are resolved.
+     */
+    Optional<AddressExpression> evaluate(const Value& val, unsigned depth, bool outsideOfBlock) const
+    {
+        if(auto lit = val.getLiteralValue())
         {
-            // couldn't find literal offset for any direct base, try with arbitrary values
-            ref = val.local->getBase(true);
-            Optional<Value> offset = NO_VALUE;
-            for(const auto& arg : (*writers.begin())->getArguments())
-            {
-                if(ref != nullptr && arg.hasLocal() && arg.local->getBase(false) == ref)
-                    // skip finding the same base again
-                    continue;
-                auto tmp = findBaseAndOffset(arg);
-                if(tmp.base && tmp.base->local->getBase(true) == ref && tmp.offset.is(0))
-                    // this parameter is the base itself, is already handled
-                    continue;
-                // TODO how to combine the offsets?
-                // TODO also need to handle non-addition of offsets (e.g. ptr = base + (offset + size * i))
-                logging::debug() << "Found offset of " << tmp.base.to_string() << " + "
-                                 << (tmp.offset ? tmp.offset.value() : -1) << logging::endl;
-                logging::debug() << "Found offset of " << tmp.base.to_string() << " with expression: "
-                                 << vc4c::Expression::createExpression(*(*writers.begin())).to_string() <<
-       logging::endl;
-            }
-            // TODO why is this called twice? The whole function, from outside
-            logging::debug() << "Found base and non-literal offset: " << ref->to_string() << " - " << offset.to_string()
-                             << logging::endl;
-            if(ref && (ref->residesInMemory() || (ref->is<Parameter>() && ref->type.isPointerType())))
-                return BaseAndOffset(ref->createReference(), {});
+            AddressExpression result;
+            result.offset = lit->signedInt();
+            return result;
         }
-    */
+        auto loc = val.checkLocal();
+        if(!loc)
+            // e.g. registers, which can change their values at any time
+            return {};
+        if(!outsideOfBlock)
+        {
+            auto it = currentValues.find(loc);
+            if(it != currentValues.end())
+                return it->second;
+        }
+        // locals with a single writer outside of this block have the same value everywhere in this block
+        auto writer = val.getSingleWriter();
+        if(writer && depth < MAX_DEPTH && blockInstructions.find(writer) == blockInstructions.end())
+            return evaluate(*writer, depth + 1, true);
+        if(outsideOfBlock)
+            // the local might have had another value when it was read than at the start of this block
+            return {};
+        AddressExpression result;
+        result.factors.emplace(loc, 1);
+        return result;
+    }
 
-    return BaseAndOffset();
-}
+    AddressExpression evaluate(const IntermediateInstruction& inst, unsigned depth, bool outsideOfBlock) const
+    {
+        AddressExpression opaque;
+        opaque.factors.emplace(&inst, 1);
+        if(inst.hasConditionalExecution() || inst.hasSideEffects() || inst.hasUnpackMode() || inst.hasPackMode())
+            return opaque;
+
+        if(auto load = dynamic_cast<const LoadImmediate*>(&inst))
+        {
+            if(load->type != LoadType::REPLICATE_INT32)
+                return opaque;
+            AddressExpression result;
+            result.offset = load->getImmediate().signedInt();
+            return result;
+        }
+        if(auto move = dynamic_cast<const MoveOperation*>(&inst))
+        {
+            if(dynamic_cast<const VectorRotation*>(move))
+                return opaque;
+            return evaluate(move->getSource(), depth, outsideOfBlock).value_or(opaque);
+        }
+
+        auto firstArg = inst.getArgument(0);
+        auto secondArg = inst.getArgument(1);
+        auto first = firstArg ? evaluate(*firstArg, depth, outsideOfBlock) : Optional<AddressExpression>{};
+        auto second = secondArg ? evaluate(*secondArg, depth, outsideOfBlock) : Optional<AddressExpression>{};
+        if(!first || !second)
+            return opaque;
+        // the factors of multiplications and shifts need to be constant to keep the expression linear
+        auto firstConstant = first->factors.empty() ? Optional<int64_t>{first->offset} : Optional<int64_t>{};
+        auto secondConstant = second->factors.empty() ? Optional<int64_t>{second->offset} : Optional<int64_t>{};
+
+        if(auto op = dynamic_cast<const Operation*>(&inst))
+        {
+            if(op->op == OP_ADD)
+                return *first + *second;
+            if(op->op == OP_SUB)
+                return *first + (*second * -1);
+            if(op->op == OP_SHL && secondConstant && *secondConstant >= 0 && *secondConstant < 32)
+                return *first * (int64_t{1} << *secondConstant);
+            if(op->op == OP_MUL24 && secondConstant)
+                return *first * *secondConstant;
+            if(op->op == OP_MUL24 && firstConstant)
+                return *second * *firstConstant;
+        }
+        if(auto intrinsic = dynamic_cast<const IntrinsicOperation*>(&inst))
+        {
+            if(intrinsic->opCode == "mul" && secondConstant)
+                return *first * *secondConstant;
+            if(intrinsic->opCode == "mul" && firstConstant)
+                return *second * *firstConstant;
+        }
+        return opaque;
+    }
+};
 
 struct VPMAccessGroup
 {
@@ -192,11 +248,12 @@ struct VPMAccessGroup
     }
 };
 
-static InstructionWalker findGroupOfVPMAccess(
-    VPM& vpm, InstructionWalker start, const InstructionWalker end, VPMAccessGroup& group)
+using DMAAddresses = FastMap<const IntermediateInstruction*, AddressExpression>;
+
+static InstructionWalker findGroupOfVPMAccess(VPM& vpm, InstructionWalker start, const InstructionWalker end,
+    VPMAccessGroup& group, const DMAAddresses& addresses)
 {
-    Optional<Value> baseAddress = NO_VALUE;
-    int32_t nextOffset = -1;
+    Optional<AddressExpression> firstAddress;
     // the number of elements between two entries in memory
     group.stride = 0;
     group.groupType = TYPE_UNKNOWN;
@@ -230,45 +287,47 @@ static InstructionWalker findGroupOfVPMAccess(
         if(!it.get<MoveOperation>())
             throw CompilationError(
                 CompilationStep::OPTIMIZER, "Setting VPM address with non-move is not supported", it->to_string());
-        const auto baseAndOffset = findBaseAndOffset(it.get<MoveOperation>()->getSource());
+        const Value& addressValue = it.get<MoveOperation>()->getSource();
         const bool isVPMWrite = it->writesRegister(REG_VPM_DMA_STORE_ADDR);
-        CPPLOG_LAZY(logging::Level::DEBUG,
-            log << "Found base address " << baseAndOffset.base.to_string() << " with offset "
-                << std::to_string(baseAndOffset.offset.value_or(-1L)) << " for "
-                << (isVPMWrite ? "writing into" : "reading from") << " memory" << logging::endl);
+        auto addressIt = addresses.find(it.get());
 
-        if(!baseAndOffset.base)
+        if(addressIt == addresses.end() || !addressValue.type.getPointerType())
             // this address-write could not be fixed to a base and an offset
             // skip this address write for the next check
             return it.nextInBlock();
-        if(baseAndOffset.base && baseAndOffset.base->checkLocal() && baseAndOffset.base->local()->is<Parameter>() &&
-            has_flag(baseAndOffset.base->local()->as<Parameter>()->decorations, ParameterDecorations::VOLATILE))
+        auto baseLocal = addressValue.checkLocal() ? addressValue.local()->getBase(true) : nullptr;
+        if(baseLocal && baseLocal->is<Parameter>() &&
+            has_flag(baseLocal->as<Parameter>()->decorations, ParameterDecorations::VOLATILE))
             // address points to a volatile parameter, which explicitly forbids combining reads/writes
             // skip this address write for the next check
             return it.nextInBlock();
+        const AddressExpression& address = addressIt->second;
+        const int64_t elementSize = static_cast<int64_t>(addressValue.type.getElementType().getInMemoryWidth());
 
-        // check if this address is consecutive to the previous one (if any)
-        if(baseAddress)
+        // check if this address has a constant distance to the previous one (if any)
+        if(firstAddress)
         {
-            if(baseAndOffset.base && baseAddress.value() != baseAndOffset.base.value())
+            auto groupElementSize = static_cast<int64_t>(group.groupType.getElementType().getInMemoryWidth());
+            if(!address.hasSameFactors(*firstAddress) || elementSize != groupElementSize)
                 // a group exists, but the base addresses don't match
                 break;
-            if(group.addressWrites.size() == 1 && baseAndOffset.offset && group.stride == 0)
+            auto distance = static_cast<int32_t>(address.offset - firstAddress->offset);
+            if(group.addressWrites.size() == 1 && group.stride == 0 && distance > 0 && (distance % elementSize) == 0)
             {
                 // special case for first offset - use it to determine stride
-                group.stride = baseAndOffset.offset.value() -
-                    findBaseAndOffset(group.addressWrites[0].get<MoveOperation>()->getSource()).offset.value();
+                group.stride = static_cast<int>(distance / elementSize);
                 CPPLOG_LAZY(logging::Level::DEBUG,
                     log << "Using a stride of " << group.stride << " elements between consecutive access to memory"
                         << logging::endl);
             }
-            if(!baseAndOffset.offset || baseAndOffset.offset.value() != (nextOffset * group.stride))
+            if(group.stride == 0 ||
+                distance != static_cast<int64_t>(group.addressWrites.size()) * group.stride * elementSize)
                 // a group exists, but the offsets do not match
                 break;
         }
 
         // check if the access mode (read/write) is the same as for the group
-        if(baseAddress && group.isVPMWrite != isVPMWrite)
+        if(firstAddress && group.isVPMWrite != isVPMWrite)
             break;
 
         auto vpmSetups = periphery::findRelatedVPMInstructions(it, !isVPMWrite);
@@ -276,7 +335,7 @@ static InstructionWalker findGroupOfVPMAccess(
         auto dmaSetup = vpmSetups.dmaSetup;
 
         // check if the VPM and DMA configurations match with the previous one
-        if(baseAddress)
+        if(firstAddress)
         {
             if(!genericSetup || !dmaSetup)
                 // either there are no setups for this VPM access, or they are not loaded from literals (e.g. dynamic
@@ -296,9 +355,7 @@ static InstructionWalker findGroupOfVPMAccess(
         }
 
         // check for complex types
-        DataType elementType = baseAndOffset.base->type.getPointerType() ?
-            baseAndOffset.base->type.getPointerType()->elementType :
-            baseAndOffset.base->type;
+        DataType elementType = addressValue.type.getPointerType()->elementType;
         elementType = elementType.getArrayType() ? elementType.getArrayType()->elementType : elementType;
         if(!elementType.isSimpleType())
             // XXX for now, skip combining any access to complex types (here: only struct, image)
@@ -307,8 +364,9 @@ static InstructionWalker findGroupOfVPMAccess(
 
         // all matches so far, add to group (or create a new one)
         group.isVPMWrite = isVPMWrite;
-        group.groupType = baseAndOffset.base->type;
-        baseAddress = baseAndOffset.base.value();
+        group.groupType = addressValue.type;
+        if(!firstAddress)
+            firstAddress = address;
         group.addressWrites.push_back(it);
         if(dmaSetup)
             // not always given, e.g. for caching in VPM without accessing RAM
@@ -316,7 +374,6 @@ static InstructionWalker findGroupOfVPMAccess(
         if(genericSetup)
             // not always given, e.g. for copying memory without reading/writing into/from QPU
             group.genericSetups.push_back(genericSetup.value());
-        nextOffset = (baseAndOffset.offset.value_or(-1) / (group.stride == 0 ? 1 : group.stride)) + 1;
 
         if(group.isVPMWrite && group.addressWrites.size() >= vpm.getMaxCacheVectors(elementType, true))
         {
@@ -339,7 +396,7 @@ static InstructionWalker findGroupOfVPMAccess(
     return it;
 }
 
-static void groupVPMWrites(VPM& vpm, VPMAccessGroup& group)
+static bool groupVPMWrites(Method& method, VPM& vpm, VPMAccessGroup& group)
 {
     if(group.genericSetups.size() != group.addressWrites.size() || group.genericSetups.size() != group.dmaSetups.size())
     {
@@ -350,10 +407,10 @@ static void groupVPMWrites(VPM& vpm, VPMAccessGroup& group)
                              << " VPR address writes and " << group.dmaSetups.size() << " DMA setups" << logging::endl;
         });
         LCOV_EXCL_STOP
-        return;
+        return false;
     }
     if(group.addressWrites.size() <= 1)
-        return;
+        return false;
     CPPLOG_LAZY(logging::Level::DEBUG,
         log << "Combining " << group.addressWrites.size() << " writes to consecutive memory into one DMA write... "
             << logging::endl);
@@ -395,8 +452,24 @@ static void groupVPMWrites(VPM& vpm, VPMAccessGroup& group)
 
     // 3. remove all but the last address writes (and the following DMA waits), update the last write to write the first
     // address written to
-    group.addressWrites.back().get<MoveOperation>()->setSource(
-        Value(group.addressWrites.at(0).get<MoveOperation>()->getSource()));
+    Value firstAddress = group.addressWrites.at(0).get<MoveOperation>()->getSource();
+    if(auto loc = firstAddress.checkLocal())
+    {
+        bool isOverwritten = false;
+        for(auto it = group.addressWrites.front().copy().nextInBlock();
+            !it.isEndOfBlock() && it != group.addressWrites.back(); it.nextInBlock())
+            isOverwritten = isOverwritten || (it.has() && it->checkOutputLocal() == loc);
+        if(isOverwritten)
+        {
+            // e.g. for unrolled loops, the addresses of all iterations are written to the same local, so we need to
+            // preserve the first address
+            auto tmp = method.addNewLocal(firstAddress.type, "%dma_address");
+            tmp.local()->reference = std::make_pair(loc->reference.first, ANY_ELEMENT);
+            assign(group.addressWrites.front(), tmp) = firstAddress;
+            firstAddress = tmp;
+        }
+    }
+    group.addressWrites.back().get<MoveOperation>()->setSource(std::move(firstAddress));
     for(std::size_t i = 0; i < group.addressWrites.size() - 1; ++i)
     {
         if(!group.addressWrites[i].copy().nextInBlock()->readsRegister(
@@ -427,9 +500,10 @@ static void groupVPMWrites(VPM& vpm, VPMAccessGroup& group)
     }
 
     logging::debug() << "Removed " << numRemoved << " instructions by combining VPW writes" << logging::endl;
+    return true;
 }
 
-static void groupVPMReads(VPM& vpm, VPMAccessGroup& group)
+static bool groupVPMReads(VPM& vpm, VPMAccessGroup& group)
 {
     if(group.genericSetups.size() != group.addressWrites.size() || group.genericSetups.size() != group.dmaSetups.size())
     {
@@ -440,10 +514,10 @@ static void groupVPMReads(VPM& vpm, VPMAccessGroup& group)
                              << " VPR address writes and " << group.dmaSetups.size() << " DMA setups" << logging::endl;
         });
         LCOV_EXCL_STOP
-        return;
+        return false;
     }
     if(group.genericSetups.size() <= 1)
-        return;
+        return false;
     CPPLOG_LAZY(logging::Level::DEBUG,
         log << "Combining " << group.genericSetups.size() << " reads of consecutive memory into one DMA read... "
             << logging::endl);
@@ -522,6 +596,7 @@ static void groupVPMReads(VPM& vpm, VPMAccessGroup& group)
 
     CPPLOG_LAZY(logging::Level::DEBUG,
         log << "Removed " << numRemoved << " instructions by combining VPR reads" << logging::endl);
+    return true;
 }
 
 /*
@@ -534,27 +609,46 @@ static void groupVPMReads(VPM& vpm, VPMAccessGroup& group)
  * Also, this optimization currently only supports access memory <-> QPU, data exchange between only memory and VPM are
  * not optimized
  */
-static void combineVPMAccess(FastSet<BasicBlock*>& blocks, Method& method)
+bool normalization::combineVPMAccess(const FastSet<BasicBlock*>& blocks, Method& method)
 {
     // combine configurations of VPM (VPW/VPR) which have the same values
 
     // TODO for now, this cannot handle RAM->VPM, VPM->RAM only access as well as VPM->QPU or QPU->VPM
 
+    bool hasChanged = false;
     // run within all basic blocks
     for(BasicBlock* block : blocks)
     {
+        // determine the (symbolic) addresses of all DMA accesses in this block
+        DMAAddresses addresses;
+        AddressEvaluator evaluator(*block);
+        for(auto it = block->walk(); !it.isEndOfBlock(); it.nextInBlock())
+        {
+            if(!it.has())
+                continue;
+            auto move = it.get<MoveOperation>();
+            if(move && (move->writesRegister(REG_VPM_DMA_LOAD_ADDR) || move->writesRegister(REG_VPM_DMA_STORE_ADDR)))
+            {
+                if(auto address = evaluator(move->getSource()))
+                    addresses.emplace(move, *address);
+            }
+            evaluator.update(*it.get());
+        }
+
         auto it = block->walk();
         while(!it.isEndOfBlock())
         {
             VPMAccessGroup group;
-            it = findGroupOfVPMAccess(*method.vpm.get(), it, block->walkEnd(), group);
+            it = findGroupOfVPMAccess(*method.vpm.get(), it, block->walkEnd(), group, addresses);
             if(group.addressWrites.size() > 1)
             {
                 group.cleanDuplicateInstructions();
-                if(group.isVPMWrite)
-                    groupVPMWrites(*method.vpm.get(), group);
-                else
-                    groupVPMReads(*method.vpm.get(), group);
+                bool isCombined = group.isVPMWrite ? groupVPMWrites(method, *method.vpm.get(), group) :
+                                                     groupVPMReads(*method.vpm.get(), group);
+                if(isCombined)
+                    PROFILE_COUNTER(
+                        vc4c::profiler::COUNTER_GENERAL + 81, "Combined DMA accesses", group.addressWrites.size());
+                hasChanged = hasChanged || isCombined;
             }
         }
     }
@@ -563,6 +657,7 @@ static void combineVPMAccess(FastSet<BasicBlock*>& blocks, Method& method)
     method.cleanEmptyInstructions();
     PROFILE_COUNTER(
         vc4c::profiler::COUNTER_GENERAL + 80, "Scratch memory size (in rows)", method.vpm->getScratchArea().numRows);
+    return hasChanged;
 }
 
 InstructionWalker normalization::accessGlobalData(
@@ -756,6 +851,285 @@ void normalization::resolveStackAllocation(
     }
 }
 
+using InstructionPositions = FastMap<const IntermediateInstruction*, std::size_t>;
+
+/*
+ * Returns the single writer of the given value, if it is located in the loop block before the given position
+ */
+static const IntermediateInstruction* getPrecedingLoopWriter(
+    const Value& val, const InstructionPositions& loopInstructions, std::size_t position)
+{
+    auto writer = val.getSingleWriter();
+    auto posIt = writer ? loopInstructions.find(writer) : loopInstructions.end();
+    if(posIt == loopInstructions.end() || posIt->second >= position || writer->hasConditionalExecution())
+        return nullptr;
+    return writer;
+}
+
+static bool isLoopInvariant(const Value& val, const InstructionPositions& loopInstructions)
+{
+    if(val.getLiteralValue())
+        return true;
+    if(!val.checkLocal())
+        return false;
+    bool isWrittenInLoop = false;
+    val.local()->forUsers(LocalUse::Type::WRITER, [&](const LocalUser* writer) {
+        isWrittenInLoop = isWrittenInLoop || loopInstructions.find(writer) != loopInstructions.end();
+    });
+    return !isWrittenInLoop;
+}
+
+/*
+ * Matches the element index against the pattern (induction variable [+ loop-invariant offset]) and returns the
+ * loop-invariant offset
+ */
+static Optional<Value> findIndexOffset(const Value& index, const Local* inductionVariable,
+    const InstructionPositions& loopInstructions, std::size_t position)
+{
+    if(index.checkLocal() == inductionVariable)
+        return INT_ZERO;
+    auto writer = getPrecedingLoopWriter(index, loopInstructions, position);
+    if(auto move = dynamic_cast<const MoveOperation*>(writer))
+    {
+        if(!move->isSimpleMove() || dynamic_cast<const VectorRotation*>(move))
+            return NO_VALUE;
+        return findIndexOffset(move->getSource(), inductionVariable, loopInstructions, position);
+    }
+    auto op = dynamic_cast<const Operation*>(writer);
+    if(!op || op->op != OP_ADD || !op->isSimpleOperation() || !op->getSecondArg())
+        return NO_VALUE;
+    auto isInductionVariable = [&](const Value& arg) -> bool {
+        auto offset = findIndexOffset(arg, inductionVariable, loopInstructions, position);
+        return offset && *offset == INT_ZERO;
+    };
+    if(isLoopInvariant(*op->getSecondArg(), loopInstructions) && isInductionVariable(op->getFirstArg()))
+        return *op->getSecondArg();
+    if(isLoopInvariant(op->getFirstArg(), loopInstructions) && isInductionVariable(*op->getSecondArg()))
+        return op->getFirstArg();
+    return NO_VALUE;
+}
+
+/*
+ * Matches the byte offset against the pattern (index * element size) and returns the element index
+ */
+static Optional<Value> findElementIndex(const Value& byteOffset, unsigned elementSize,
+    const InstructionPositions& loopInstructions, std::size_t position)
+{
+    auto writer = getPrecedingLoopWriter(byteOffset, loopInstructions, position);
+    if(!writer || writer->getArguments().size() != 2)
+        return NO_VALUE;
+    auto factorArg = writer->getArgument(1);
+    auto factor = factorArg ? (factorArg->getConstantValue() & &Value::getLiteralValue) : Optional<Literal>{};
+    if(!factor)
+        return NO_VALUE;
+    // the multiplication with the element size inserted by the index calculation might already be lowered
+    auto op = dynamic_cast<const Operation*>(writer);
+    if(op && op->isSimpleOperation() && op->op == OP_SHL && factor->unsignedInt() < 32 &&
+        (1u << factor->unsignedInt()) == elementSize)
+        return op->getFirstArg();
+    if(op && op->isSimpleOperation() && op->op == OP_MUL24 && factor->unsignedInt() == elementSize)
+        return op->getFirstArg();
+    auto intrinsic = dynamic_cast<const IntrinsicOperation*>(writer);
+    if(intrinsic && intrinsic->opCode == "mul" && factor->unsignedInt() == elementSize)
+        return intrinsic->getFirstArg();
+    return NO_VALUE;
+}
+
+/*
+ * A memory access within a loop, which accesses the consecutive element of a memory area located in RAM in every
+ * iteration
+ */
+struct CachedLoopAccess
+{
+    InstructionWalker access;
+    const MemoryInstruction* mem;
+    // the loop-invariant base address
+    Value baseAddress;
+    // the loop-invariant offset added to the induction variable to calculate the element index
+    Value indexOffset;
+};
+
+static Optional<CachedLoopAccess> checkCacheableLoopAccess(InstructionWalker it, const InductionVariable& inductionVariable,
+    const InstructionPositions& loopInstructions)
+{
+    auto mem = it.get<const MemoryInstruction>();
+    if(mem->op != MemoryOperation::READ && mem->op != MemoryOperation::WRITE)
+        return {};
+    if(mem->getNumEntries() != INT_ONE)
+        return {};
+    const Value& address = mem->op == MemoryOperation::READ ? mem->getSource() : mem->getDestination();
+    const DataType valueType = mem->op == MemoryOperation::READ ? mem->getDestination().type : mem->getSource().type;
+    // only scalar 32-bit values are supported, since every value is stored in its own VPM row
+    if(!valueType.isSimpleType() || valueType.getPointerType() || valueType.getVectorWidth() != 1 ||
+        valueType.getScalarBitCount() != 32 || address.type.getElementType().getInMemoryWidth() != 4)
+        return {};
+
+    const auto position = loopInstructions.at(it.get());
+    // the induction variable needs to have the value of the current iteration
+    bool isChangedBefore = false;
+    inductionVariable.local->forUsers(LocalUse::Type::WRITER, [&](const LocalUser* writer) {
+        auto posIt = loopInstructions.find(writer);
+        isChangedBefore = isChangedBefore || (posIt != loopInstructions.end() && posIt->second < position);
+    });
+    if(isChangedBefore)
+        return {};
+
+    auto op = dynamic_cast<const Operation*>(getPrecedingLoopWriter(address, loopInstructions, position));
+    if(!op || op->op != OP_ADD || !op->isSimpleOperation() || !op->getSecondArg())
+        return {};
+    for(const auto& args : {std::make_pair(op->getFirstArg(), *op->getSecondArg()),
+            std::make_pair(*op->getSecondArg(), op->getFirstArg())})
+    {
+        if(!isLoopInvariant(args.first, loopInstructions))
+            continue;
+        auto index = findElementIndex(args.second, 4, loopInstructions, position);
+        auto indexOffset = index ? findIndexOffset(*index, inductionVariable.local, loopInstructions, position) : NO_VALUE;
+        if(indexOffset)
+            return CachedLoopAccess{it, mem, args.first, *indexOffset};
+    }
+    return {};
+}
+
+/*
+ * Caches the accesses to global memory within simple loops in VPM.
+ *
+ * For a loop consisting of a single block with a constant number of iterations N, which accesses the consecutive
+ * elements addr[i + offset] of a memory area located in RAM (and no other elements of the same memory area):
+ * - reads are replaced with a single DMA read of the N elements before the loop and reads from VPM within the loop
+ * - writes are replaced with writes into VPM within the loop and a single DMA write of the N elements after the loop
+ *
+ * Since we cannot synchronize the work-items in between, every QPU uses its own part of the VPM area.
+ *
+ * The instructions accessing memory which are handled here are removed from the list of memory accesses.
+ */
+static void cacheLoopAccessesInVPM(Method& method, FastSet<InstructionWalker>& accessInstructions,
+    const FastMap<const Local*, MemoryInfo>& infos)
+{
+    auto& cfg = method.getCFG();
+    auto loops = cfg.findLoops(false);
+    auto dependencyGraph = DataDependencyGraph::createDependencyGraph(method);
+
+    for(auto& loop : loops)
+    {
+        if(loop.size() != 1)
+            continue;
+        const CFGNode* loopNode = loop.front();
+        auto predecessor = loop.findPredecessor();
+        auto successor = loop.findSuccessor();
+        // the prefetch and write-back are only executed if the loop is entered and left, respectively
+        if(!predecessor || !successor || predecessor->getSingleSuccessor() != loopNode ||
+            successor->getSinglePredecessor() != loopNode)
+            continue;
+
+        auto inductionVariables = loop.findInductionVariables(*dependencyGraph, true);
+        if(inductionVariables.size() != 1)
+            continue;
+        const auto& inductionVariable = inductionVariables.front();
+        auto iterations = optimizations::determineConstantIterationCount(inductionVariable);
+        if(!iterations || *iterations < 2 || inductionVariable.inductionStep->op != OP_ADD)
+            continue;
+        auto startValue = inductionVariable.initialAssignment->precalculate(4).first & &Value::getLiteralValue;
+        auto stepValue = inductionVariable.inductionStep->findOtherArgument(inductionVariable.local->createReference());
+        auto step = stepValue ? (stepValue->getConstantValue() & &Value::getLiteralValue) : Optional<Literal>{};
+        if(!startValue || !step || step->signedInt() != 1)
+            continue;
+
+        BasicBlock& block = *loopNode->key;
+        InstructionPositions loopInstructions;
+        std::size_t index = 0;
+        for(auto it = block.walk(); !it.isEndOfBlock(); it.nextInBlock(), ++index)
+        {
+            if(it.has())
+                loopInstructions.emplace(it.get(), index);
+        }
+
+        // group the memory accesses in this loop by the memory area accessed
+        FastMap<const Local*, FastAccessList<InstructionWalker>> accessesByArea;
+        for(auto& it : accessInstructions)
+        {
+            if(it.getBasicBlock() != &block)
+                continue;
+            auto mem = it.get<const MemoryInstruction>();
+            for(const auto& addr : {mem->getSource(), mem->getDestination()})
+            {
+                if(auto loc = addr.checkLocal())
+                    accessesByArea[loc->getBase(true)].push_back(it);
+            }
+        }
+
+        for(auto& entry : accessesByArea)
+        {
+            auto infoIt = infos.find(entry.first);
+            if(entry.second.size() != 1 || infoIt == infos.end() ||
+                infoIt->second.type != MemoryAccessType::RAM_READ_WRITE_VPM)
+                continue;
+            auto access = checkCacheableLoopAccess(entry.second.front(), inductionVariable, loopInstructions);
+            if(!access)
+                continue;
+            const bool isRead = access->mem->op == MemoryOperation::READ;
+            // reading via DMA is limited to 16 rows, writing to 128 rows
+            if(*iterations > (isRead ? 16u : 128u))
+                continue;
+            const Value address = isRead ? access->mem->getSource() : access->mem->getDestination();
+            const Value value = isRead ? access->mem->getDestination() : access->mem->getSource();
+            auto area = method.vpm->addArea(entry.first, value.type.toArrayType(*iterations), true);
+            if(!area)
+                continue;
+
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Caching " << (isRead ? "reads from " : "writes to ") << entry.first->to_string() << " for "
+                    << *iterations << " iterations of loop in VPM: " << access->mem->to_string() << logging::endl);
+
+            // calculate the address of the first element accessed and the offset of this QPU's part of the VPM area
+            // in front of the loop
+            auto preheaderIt = predecessor->key->walkEnd();
+            while(preheaderIt.copy().previousInBlock().get<Branch>())
+                preheaderIt.previousInBlock();
+            Value firstIndex(*startValue, TYPE_INT32);
+            if(access->indexOffset != INT_ZERO)
+                firstIndex = assign(preheaderIt, TYPE_INT32, "%vpm_cache_index") = access->indexOffset + firstIndex;
+            auto firstOffset = assign(preheaderIt, TYPE_INT32, "%vpm_cache_offset") = firstIndex * Literal(4u);
+            auto firstAddress = assign(preheaderIt, address.type, "%vpm_cache_addr") =
+                (access->baseAddress + firstOffset, InstructionDecorations::UNSIGNED_RESULT);
+            if(auto ref = address.local()->reference.first)
+                firstAddress.local()->reference = std::make_pair(ref, ANY_ELEMENT);
+            auto qpuRow = assign(preheaderIt, TYPE_INT32, "%vpm_cache_row") =
+                mul24(Value(Literal(*iterations), TYPE_INT16), Value(REG_QPU_NUMBER, TYPE_INT8));
+
+            // the QPU-side VPM address of 32-bit values is the row, the DMA address also contains the column
+            const unsigned rowSize = VPM::getVPMStorageType(value.type).getInMemoryWidth();
+            auto dmaOffset = [&](InstructionWalker& it) -> Value {
+                return assign(it, TYPE_INT32, "%vpm_cache_offset") = qpuRow * Literal(rowSize);
+            };
+            if(isRead)
+                preheaderIt = method.vpm->insertReadRAM(method, preheaderIt, firstAddress, value.type, area, true,
+                    dmaOffset(preheaderIt), Value(Literal(*iterations), TYPE_INT32));
+            auto qpuOffset = assign(preheaderIt, TYPE_INT32, "%vpm_cache_offset") = qpuRow * Literal(4u);
+
+            // replace the memory access in the loop with the access to this QPU's part of the VPM area. Since no
+            // other QPU accesses these rows, the VPM does not need to be locked
+            accessInstructions.erase(access->access);
+            auto it = access->access;
+            auto elementOffset = assign(it, TYPE_INT32, "%vpm_cache_offset") = address - firstAddress;
+            auto inAreaOffset = assign(it, TYPE_INT32, "%vpm_cache_offset") = qpuOffset + elementOffset;
+            if(isRead)
+                it = method.vpm->insertReadVPM(method, it, value, area, false, inAreaOffset);
+            else
+                it = method.vpm->insertWriteVPM(method, it, value, area, false, inAreaOffset);
+            it.erase();
+
+            if(!isRead)
+            {
+                // write back all values written in the loop at once
+                auto successorIt = successor->key->walk().nextInBlock();
+                successorIt = method.vpm->insertWriteRAM(method, successorIt, firstAddress, value.type, area, true,
+                    dmaOffset(successorIt), Value(Literal(*iterations), TYPE_INT32));
+            }
+            PROFILE_COUNTER(vc4c::profiler::COUNTER_NORMALIZATION + 10, "Loop memory accesses cached in VPM", 1);
+        }
+    }
+}
+
 /* clang-format off */
 /*
  * Matrix of memory types and storage locations:
@@ -812,7 +1186,8 @@ void normalization::mapMemoryAccess(const Module& module, Method& method, const
      * 5. generate remaining instructions for RAM access via VPM scratch area
      * TODO:
      * 3.1 for memory located in RAM, try to group/queue reads/writes
-     * 3.2 also try to use VPM as cache (e.g. only write back into memory when VPM cache area full, prefetch into VPM)
+     * 3.2 also try to use VPM as cache for more than simple loops (e.g. only write back into memory when VPM cache
+     *     area full)
      * 4. final pass which actually converts VPM cache
      */
 
@@ -836,6 +1211,9 @@ void normalization::mapMemoryAccess(const Module& module, Method& method, const
         }
     }
 
+    if(config.cacheMemoryInVPM)
+        cacheLoopAccessesInVPM(method, memoryAccessInfo.accessInstructions, infos);
+
     // list of basic blocks where multiple VPM accesses could be combined
     FastSet<BasicBlock*> affectedBlocks;
 
@@ -875,12 +1253,11 @@ void normalization::mapMemoryAccess(const Module& module, Method& method, const
                 "Writing memory through a phi-node is not implemented yet", memIt->to_string());
 
         mapMemoryAccess(method, memIt, const_cast<MemoryInstruction*>(mem), srcInfo, dstInfo);
-        // TODO mark local for prefetch/write-back (if necessary)
     }
 
     method.vpm->dumpUsage();
 
-    // TODO move this to optimization?
+    // this is repeated as optimization, e.g. to also combine the accesses of multiple iterations of unrolled loops
     combineVPMAccess(affectedBlocks, method);
 
     // TODO clean up no longer used (all kernels!) globals and stack allocations
@@ -7,8 +7,11 @@
 #ifndef OPTIMIZATION_MEMORYACCESS_H
 #define OPTIMIZATION_MEMORYACCESS_H
 
+#include "../performance.h"
+
 namespace vc4c
 {
+    class BasicBlock;
     class Method;
     class Module;
     class InstructionWalker;
@@ -47,6 +50,15 @@ namespace vc4c
          * This optimization-step also contains most of the optimizations for accessing VPM/RAM.
          */
         void mapMemoryAccess(const Module& module, Method& method, const Configuration& config);
+
+        /*
+         * Combines the DMA accesses within the given basic blocks, which access memory addresses with a constant
+         * distance to each other, into single DMA accesses of multiple rows. The distance between the addresses is
+         * determined symbolically, so the addresses themselves do not need to be known at compile-time.
+         *
+         * Returns whether any DMA accesses were combined
+         */
+        bool combineVPMAccess(const FastSet<BasicBlock*>& blocks, Method& method);
     } // namespace normalization
 } // namespace vc4c
 
@@ -58,13 +58,19 @@ Optional<Value> normalization::getConstantValue(const Value& source)
     if(global->initialValue.isUndefined())
         // all entries are undefined
         return Value(global->initialValue.type.getElementType());
-    auto globalContainer = global->initialValue.getCompound();
+    // access single elements, since copying all elements of (large) constant tables is expensive
     if(global->initialValue.isAllSame())
+    {
         // all entries are the same
-        return globalContainer->at(0).toValue();
-    if(globalContainer && source.local()->reference.second >= 0)
+        auto firstElement = global->initialValue.getElement(0);
+        return firstElement ? firstElement->toValue() : NO_VALUE;
+    }
+    if(source.local()->reference.second >= 0)
+    {
         // fixed index
-        return globalContainer->at(static_cast<std::size_t>(source.local()->reference.second)).toValue();
+        auto element = global->initialValue.getElement(static_cast<std::size_t>(source.local()->reference.second));
+        return element ? element->toValue() : NO_VALUE;
+    }
     if(auto val = global->initialValue.toValue())
     {
         if(auto vector = val->checkVector())
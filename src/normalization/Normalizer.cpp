@@ -11,10 +11,12 @@
 #include "../Module.h"
 #include "../Profiler.h"
 #include "../ThreadPool.h"
+#include "../intrinsics/Images.h"
 #include "../intrinsics/Intrinsics.h"
 #include "../optimization/ControlFlow.h"
 #include "../optimization/Eliminator.h"
 #include "../optimization/Reordering.h"
+#include "../periphery/TMU.h"
 #include "../spirv/SPIRVBuiltins.h"
 #include "Inliner.h"
 #include "LiteralValues.h"
@@ -30,6 +32,75 @@
 using namespace vc4c;
 using namespace vc4c::normalization;
 
+/*
+ * Returns the literal value of the parameter specialized to the given 32-bit representation as it would be read
+ * (and extended) by the kernel
+ */
+static Literal toSpecializedValue(const Parameter& param, uint32_t value)
+{
+    if(param.type.isFloatingType())
+        return Literal(bit_cast<uint32_t, float>(value));
+    auto bitWidth = param.type.getScalarBitCount();
+    if(bitWidth >= 32)
+        return Literal(value);
+    auto mask = (1u << bitWidth) - 1u;
+    if(has_flag(param.decorations, ParameterDecorations::SIGN_EXTEND) && (value & (1u << (bitWidth - 1))))
+        return Literal(value | ~mask);
+    if(has_flag(param.decorations, ParameterDecorations::SIGN_EXTEND) ||
+        has_flag(param.decorations, ParameterDecorations::ZERO_EXTEND))
+        return Literal(value & mask);
+    return Literal(value);
+}
+
+/*
+ * Replaces all reads of kernel parameters with known values (see Configuration#specializedParameters) with these
+ * values
+ */
+static void specializeParameters(Module& module, Method& method, InstructionWalker it, const Configuration& config)
+{
+    auto kernelIt = config.specializedParameters.find(method.name);
+    if(kernelIt == config.specializedParameters.end() || !it.has())
+        return;
+    for(std::size_t i = 0; i < it->getArguments().size(); ++i)
+    {
+        const Value arg = it->assertArgument(i);
+        auto param = arg.checkLocal() ? arg.local()->as<Parameter>() : nullptr;
+        if(param == nullptr || param < method.parameters.data() ||
+            param >= method.parameters.data() + method.parameters.size())
+            continue;
+        auto valueIt = kernelIt->second.find(static_cast<std::size_t>(param - method.parameters.data()));
+        if(valueIt == kernelIt->second.end())
+            continue;
+        it->setArgument(i, Value(toSpecializedValue(*param, valueIt->second), arg.type));
+    }
+}
+
+/*
+ * Checks whether the parameters the given kernel is specialized for can be specialized
+ */
+static void checkSpecializedParameters(const Method& method, const Configuration& config)
+{
+    auto kernelIt = config.specializedParameters.find(method.name);
+    if(kernelIt == config.specializedParameters.end())
+        return;
+    for(const auto& entry : kernelIt->second)
+    {
+        if(entry.first >= method.parameters.size())
+            throw CompilationError(CompilationStep::NORMALIZER, "Cannot specialize non-existing kernel parameter",
+                method.name + ", index " + std::to_string(entry.first));
+        const Parameter& param = method.parameters[entry.first];
+        if(param.type.getPointerType() || !param.type.isScalarType())
+            throw CompilationError(CompilationStep::NORMALIZER,
+                "Only scalar non-pointer kernel parameters can be specialized", param.to_string(true));
+        if(param.type.getScalarBitCount() > 32)
+            throw CompilationError(CompilationStep::NORMALIZER,
+                "Only kernel parameters of up to 32 bits can be specialized", param.to_string(true));
+        CPPLOG_LAZY(logging::Level::INFO,
+            log << "Specializing kernel '" << method.name << "' for parameter '" << param.to_string(true)
+                << "' with value: " << toSpecializedValue(param, entry.second).to_string() << logging::endl);
+    }
+}
+
 /*
  * Propagate WORK_GROUP_UNIFORM_VALUE decoration through the kernel code
  */
@@ -139,6 +210,9 @@ static void checkNormalized(Module& module, Method& method, InstructionWalker it
 
 // NOTE: The order is on purpose and must not be changed!
 const static std::vector<std::pair<std::string, NormalizationStep>> initialNormalizationSteps = {
+    // replaces reads of kernel parameters with known values by the values. Needs to run first, so all following steps
+    // can make use of the constant values
+    {"SpecializeParameters", specializeParameters},
 #ifdef SPIRV_FRONTEND
     // fixes "loading" of OpenCL C work-item functions as SPIR-V built-ins. Needs to run before handling intrinsics
     {"LowerSPIRVBuiltins", spirv::lowerBuiltins},
@@ -201,7 +275,34 @@ static void runNormalizationStep(
     }
 }
 
+/*
+ * Returns whether the kernel can be executed by two hardware threads per QPU.
+ *
+ * A thread blocked on a semaphore (e.g. within a barrier) does not switch to the other thread on the same QPU, which
+ * might be the one required to release the semaphore.
+ */
+static bool canUseMultiThreading(const Method& method)
+{
+    for(const auto& block : method)
+    {
+        for(const auto& inst : block)
+        {
+            if(dynamic_cast<const intermediate::SemaphoreAdjustment*>(inst.get()))
+                return false;
+        }
+    }
+    return true;
+}
+
 void Normalizer::normalize(Module& module) const
+{
+    inlineFunctions(module);
+    // 4. run other normalization steps on kernel functions
+    const auto f = [&module, this](Method* kernelFunc) -> void { normalizeKernel(module, *kernelFunc); };
+    ThreadPool{"Normalization"}.scheduleAll<Method*>(module.getKernels(), f);
+}
+
+void Normalizer::inlineFunctions(Module& module) const
 {
     // 1. eliminate phi on all methods
     for(auto& method : module)
@@ -220,32 +321,42 @@ void Normalizer::normalize(Module& module) const
             method->countInstructions(), vc4c::profiler::COUNTER_NORMALIZATION + 1);
     }
     auto kernels = module.getKernels();
-    // 2. inline kernel-functions
+    // 2. reserve the image-configurations for all image parameters of the kernels
+    // this modifies the global data of the module and thus needs to be done before the kernels are processed in
+    // parallel, since the kernels read the global data (e.g. for looking up the image-configurations)
+    for(Method* kernelFunc : kernels)
+    {
+        for(auto& param : kernelFunc->parameters)
+        {
+            if(param.type.getImageType())
+                intermediate::reserveImageConfiguration(module, param);
+        }
+    }
+    // 3. inline kernel-functions
+    // the index is shared by all kernels, so every function called by several kernels is only prepared once
+    FunctionIndex functionIndex(module);
     for(Method* kernelFunc : kernels)
     {
         Method& kernel = *kernelFunc;
 
         PROFILE_COUNTER(vc4c::profiler::COUNTER_NORMALIZATION + 4, "Inline (before)", kernel.countInstructions());
         PROFILE_START(Inline);
-        inlineMethods(module, kernel, config);
+        inlineMethods(functionIndex, kernel, config);
         PROFILE_END(Inline);
         PROFILE_COUNTER_WITH_PREV(vc4c::profiler::COUNTER_NORMALIZATION + 5, "Inline (after)",
             kernel.countInstructions(), vc4c::profiler::COUNTER_NORMALIZATION + 4);
     }
-    // 3. run other normalization steps on kernel functions
-    const auto f = [&module, this](Method* kernelFunc) -> void { normalizeMethod(module, *kernelFunc); };
-    ThreadPool{"Normalization"}.scheduleAll<Method*>(kernels, f);
 }
 
 void Normalizer::adjust(Module& module) const
 {
     // run adjustment steps on kernel functions
     auto kernels = module.getKernels();
-    const auto f = [&module, this](Method* kernelFunc) -> void { adjustMethod(module, *kernelFunc); };
+    const auto f = [&module, this](Method* kernelFunc) -> void { adjustKernel(module, *kernelFunc); };
     ThreadPool{"Adjustment"}.scheduleAll<Method*>(kernels, f);
 }
 
-void Normalizer::normalizeMethod(Module& module, Method& method) const
+void Normalizer::normalizeKernel(Module& module, Method& method) const
 {
     CPPLOG_LAZY(logging::Level::DEBUG, log << "-----" << logging::endl);
     CPPLOG_LAZY(logging::Level::INFO, log << "Running normalization passes for: " << method.name << logging::endl);
@@ -253,6 +364,8 @@ void Normalizer::normalizeMethod(Module& module, Method& method) const
 
     PROFILE_START(NormalizationPasses);
 
+    checkSpecializedParameters(method, config);
+
     for(const auto& step : initialNormalizationSteps)
     {
         logging::debug() << logging::endl;
@@ -262,6 +375,15 @@ void Normalizer::normalizeMethod(Module& module, Method& method) const
         PROFILE_END_DYNAMIC(step.first);
     }
 
+    if(config.useMultiThreading)
+    {
+        method.metaData.isMultiThreaded = canUseMultiThreading(method);
+        if(!method.metaData.isMultiThreaded)
+            CPPLOG_LAZY(logging::Level::INFO,
+                log << "Kernel '" << method.name
+                    << "' uses semaphores and therefore can only run a single thread per QPU" << logging::endl);
+    }
+
     // maps all memory-accessing instructions to instructions actually performing the hardware memory-access
     // this step is called extra, because it needs to be run over all instructions
     logging::logLazy(logging::Level::DEBUG, []() {
@@ -272,6 +394,16 @@ void Normalizer::normalizeMethod(Module& module, Method& method) const
     mapMemoryAccess(module, method, config);
     PROFILE_END(MapMemoryAccess);
 
+    if(method.metaData.isMultiThreaded && !periphery::hasUniformTMUAccesses(method))
+    {
+        // the thread switches are inserted for the TMU loads, so the threads would execute a different number of them
+        method.metaData.isMultiThreaded = false;
+        CPPLOG_LAZY(logging::Level::INFO,
+            log << "Kernel '" << method.name
+                << "' loads from TMU in loops or conditional blocks and therefore can only run a single thread per QPU"
+                << logging::endl);
+    }
+
     // calculate current/final stack offsets after lowering stack-accesses
     method.calculateStackOffsets();
 
@@ -314,7 +446,7 @@ void Normalizer::normalizeMethod(Module& module, Method& method) const
     LCOV_EXCL_STOP
 }
 
-void Normalizer::adjustMethod(Module& module, Method& method) const
+void Normalizer::adjustKernel(Module& module, Method& method) const
 {
     CPPLOG_LAZY(logging::Level::DEBUG, log << "-----" << logging::endl);
     CPPLOG_LAZY(logging::Level::INFO, log << "Running adjustment passes for: " << method.name << logging::endl);
@@ -334,6 +466,15 @@ void Normalizer::adjustMethod(Module& module, Method& method) const
         PROFILE_END_DYNAMIC(step.first);
     }
 
+    // inserts the thread switches after all instructions are scheduled, so their delay slots can be filled
+    logging::logLazy(logging::Level::DEBUG, []() {
+        logging::debug() << logging::endl;
+        logging::debug() << "Running pass: InsertThreadSwitches" << logging::endl;
+    });
+    PROFILE_START(InsertThreadSwitches);
+    periphery::insertThreadSwitches(method);
+    PROFILE_END(InsertThreadSwitches);
+
     // extends the branches by adding the conditional execution and the delay-nops
     // this step is called extra, because it needs to be run over all instructions
     logging::logLazy(logging::Level::DEBUG, []() {
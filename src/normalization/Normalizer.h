@@ -46,6 +46,25 @@ namespace vc4c
              */
             void normalize(Module& module) const;
 
+            /*
+             * Eliminates the phi-nodes of all functions in the module and in-lines all called functions into the
+             * kernels.
+             *
+             * This is the first part of #normalize(), which needs to be run for the whole module at once, since the
+             * called functions are shared between all kernels.
+             */
+            void inlineFunctions(Module& module) const;
+
+            /*
+             * Runs the remaining normalization steps (after #inlineFunctions()) on the given kernel.
+             *
+             * After this function has returned, it is guaranteed, that all remaining instructions within the kernel are
+             * normalized (e.g. return true for #isNormalized()).
+             *
+             * This can be called for different kernels of the same module in parallel.
+             */
+            void normalizeKernel(Module& module, Method& kernel) const;
+
             /*
              * Runs the second batch of normalization steps, trying to fix any possible issues with hardware limitations
              *
@@ -55,17 +74,15 @@ namespace vc4c
              */
             void adjust(Module& module) const;
 
-        private:
-            Configuration config;
-
             /*
-             * Runs all registered normalization steps on the given method.
+             * Runs the adjustment steps on the given kernel.
              *
-             * After this function has returned, it is guaranteed, that all remaining instructions within the method are
-             * normalized (e.g. return true for #isNormalized()).
+             * This can be called for different kernels of the same module in parallel.
              */
-            void normalizeMethod(Module& module, Method& method) const;
-            void adjustMethod(Module& module, Method& method) const;
+            void adjustKernel(Module& module, Method& kernel) const;
+
+        private:
+            Configuration config;
         };
     } /* namespace normalization */
 } /* namespace vc4c */
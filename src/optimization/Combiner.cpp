@@ -7,15 +7,19 @@
 #include "Combiner.h"
 
 #include "../InstructionWalker.h"
+#include "../Profiler.h"
+#include "../analysis/DependencyGraph.h"
 #include "../analysis/MemoryAnalysis.h"
 #include "../intermediate/Helper.h"
 #include "../intermediate/operators.h"
+#include "../normalization/MemoryAccess.h"
 #include "../periphery/VPM.h"
 #include "Eliminator.h"
 #include "log.h"
 
 #include <algorithm>
 #include <cstdlib>
+#include <limits>
 #include <memory>
 
 // TODO combine y = (x >> n) << n with and
@@ -423,12 +427,140 @@ static const std::vector<MergeCondition> mergeConditions = {
         return true;
     }};
 
+static bool checkMergeConditions(IntermediateInstruction* first, IntermediateInstruction* second)
+{
+    Operation* firstOp = dynamic_cast<Operation*>(first);
+    MoveOperation* firstMove = dynamic_cast<MoveOperation*>(first);
+    Operation* secondOp = dynamic_cast<Operation*>(second);
+    MoveOperation* secondMove = dynamic_cast<MoveOperation*>(second);
+    if((firstOp == nullptr && firstMove == nullptr) || (secondOp == nullptr && secondMove == nullptr))
+        return false;
+    return std::all_of(mergeConditions.begin(), mergeConditions.end(),
+        [&](const MergeCondition& cond) -> bool { return cond(firstOp, secondOp, firstMove, secondMove); });
+}
+
+/*
+ * Returns whether the instruction at the given position can be moved directly behind the instruction at the
+ * destination position, i.e. whether it does not depend on any instruction in between
+ */
+static bool canBeMovedBehind(
+    const InstructionWalker& destination, const InstructionWalker& it, const DependencyGraph& dependencies)
+{
+    auto node = dependencies.findNode(it.get());
+    if(node == nullptr)
+        return false;
+    // the instructions between the destination and the current position
+    FastSet<const IntermediateInstruction*> skippedInstructions;
+    for(auto checkIt = destination.copy().nextInBlock(); checkIt != it; checkIt.nextInBlock())
+    {
+        if(checkIt.has())
+            skippedInstructions.emplace(checkIt.get());
+    }
+    bool hasDependency = false;
+    node->forAllIncomingEdges([&](const DependencyNode& dependency, const DependencyEdge& edge) -> bool {
+        // moving the instruction up shortens the distance to all instructions it depends on
+        if(skippedInstructions.find(dependency.key) != skippedInstructions.end() ||
+            (edge.data.isMandatoryDelay && edge.data.numDelayCycles > 0))
+            hasDependency = true;
+        return !hasDependency;
+    });
+    if(hasDependency)
+        return false;
+    // Since the read-after-writes of locals were already split up, we must not move the instruction directly behind
+    // a write of a local it reads and must not move it away from between a write and a read of a local.
+    auto writesLocalReadBy = [](const InstructionWalker& writer, const InstructionWalker& reader) -> bool {
+        if(writer.isStartOfBlock() || reader.isEndOfBlock() || !writer.has() || !reader.has())
+            return false;
+        auto output = writer->checkOutputLocal();
+        return output && reader->readsLocal(output);
+    };
+    return !writesLocalReadBy(destination, it) &&
+        !writesLocalReadBy(it.copy().previousInBlock(), it.copy().nextInBlock());
+}
+
+/*
+ * Moves instructions which can be combined with another instruction directly behind this instruction, so they can
+ * be combined.
+ *
+ * Pairing the instructions is a matching problem on the graph of instructions which can be combined within a window
+ * of the basic block. It is solved greedily in the order of the instructions by selecting for every instruction the
+ * partner with the fewest other possible partners, to not take away the only partner of another instruction.
+ */
+static std::size_t pairInstructions(BasicBlock& block, std::size_t windowSize)
+{
+    // the number of possible partners per instruction, for the original order of instructions
+    FastMap<const IntermediateInstruction*, unsigned> numPartners;
+    for(auto it = block.walk().nextInBlock(); !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(!it.get<Operation>() && !it.get<MoveOperation>())
+            continue;
+        auto checkIt = it.copy().nextInBlock();
+        for(std::size_t i = 0; i < windowSize && !checkIt.isEndOfBlock(); ++i, checkIt.nextInBlock())
+        {
+            if(checkIt.has() && checkMergeConditions(it.get(), checkIt.get()))
+            {
+                ++numPartners[it.get()];
+                ++numPartners[checkIt.get()];
+            }
+        }
+    }
+    if(numPartners.empty())
+        return 0;
+
+    auto dependencies = DependencyGraph::createGraph(block);
+    FastSet<const IntermediateInstruction*> pairedInstructions;
+    std::size_t numMoved = 0;
+    for(auto it = block.walk().nextInBlock(); !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(!it.has() || numPartners.find(it.get()) == numPartners.end() ||
+            pairedInstructions.find(it.get()) != pairedInstructions.end())
+            continue;
+        auto nextIt = it.copy().nextInBlock();
+        if(!nextIt.isEndOfBlock() && nextIt.has() &&
+            pairedInstructions.find(nextIt.get()) == pairedInstructions.end() &&
+            checkMergeConditions(it.get(), nextIt.get()))
+        {
+            // already neighbors, nothing to move
+            pairedInstructions.emplace(it.get());
+            pairedInstructions.emplace(nextIt.get());
+            continue;
+        }
+        Optional<InstructionWalker> partner;
+        unsigned partnerCandidates = std::numeric_limits<unsigned>::max();
+        auto checkIt = nextIt;
+        for(std::size_t i = 0; i < windowSize && !checkIt.isEndOfBlock(); ++i, checkIt.nextInBlock())
+        {
+            if(!checkIt.has() || pairedInstructions.find(checkIt.get()) != pairedInstructions.end())
+                continue;
+            auto candidatesIt = numPartners.find(checkIt.get());
+            if(candidatesIt == numPartners.end() || candidatesIt->second >= partnerCandidates ||
+                !checkMergeConditions(it.get(), checkIt.get()) || !canBeMovedBehind(it, checkIt, *dependencies))
+                continue;
+            partner = checkIt;
+            partnerCandidates = candidatesIt->second;
+        }
+        if(!partner)
+            continue;
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Moving instruction to be combined with '" << it->to_string() << "': " << (*partner)->to_string()
+                << logging::endl);
+        pairedInstructions.emplace(it.get());
+        pairedInstructions.emplace(partner->get());
+        nextIt.emplace(partner->release());
+        partner->erase();
+        ++numMoved;
+    }
+    return numMoved;
+}
+
 bool optimizations::combineOperations(const Module& module, Method& method, const Configuration& config)
 {
     // TODO can combine operation x and y if y is something like (result of x & 0xFF/0xFFFF) -> pack-mode
     bool hasChanged = false;
+    std::size_t numMovedInstructions = 0;
     for(BasicBlock& bb : method)
     {
+        numMovedInstructions += pairInstructions(bb, config.additionalOptions.maxCombinationDistance);
         auto it = bb.walk();
         while(!it.isEndOfBlock() && !it.copy().nextInBlock().isEndOfBlock())
         {
@@ -463,9 +595,7 @@ bool optimizations::combineOperations(const Module& module, Method& method, cons
                      */
                     // TODO a written-to register MUST not be read in the next instruction (check instruction
                     // before/after combined) (unless within local range)
-                    bool conditionsMet = std::all_of(mergeConditions.begin(), mergeConditions.end(),
-                        [op, nextOp, move, nextMove](
-                            const MergeCondition& cond) -> bool { return cond(op, nextOp, move, nextMove); });
+                    bool conditionsMet = checkMergeConditions(instr, nextInstr);
                     if(instr->checkOutputLocal() && nextInstr->checkOutputLocal())
                     {
                         // extra check, only combine writes to the same local, if local is only used within the next
@@ -629,6 +759,31 @@ bool optimizations::combineOperations(const Module& module, Method& method, cons
         }
     }
 
+    // the dual-issue ratio is the number of ALU operations executed together with another one
+    std::size_t numALUOperations = 0;
+    std::size_t numCombinedOperations = 0;
+    for(const BasicBlock& bb : method)
+    {
+        for(const auto& inst : bb)
+        {
+            if(dynamic_cast<const CombinedOperation*>(inst.get()))
+            {
+                numALUOperations += 2;
+                numCombinedOperations += 2;
+            }
+            else if((dynamic_cast<const Operation*>(inst.get()) || dynamic_cast<const MoveOperation*>(inst.get())) &&
+                inst->mapsToASMInstruction())
+                ++numALUOperations;
+        }
+    }
+    CPPLOG_LAZY(logging::Level::INFO,
+        log << "Combined " << numCombinedOperations << " of " << numALUOperations << " ALU operations (moved "
+            << numMovedInstructions << " instructions for pairing), dual-issue ratio of "
+            << (numALUOperations == 0 ? 0 : (numCombinedOperations * 100) / numALUOperations)
+            << "% for kernel: " << method.name << logging::endl);
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 346, "ALU operations", numALUOperations);
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 347, "Dual-issued ALU operations", numCombinedOperations);
+
     return hasChanged;
 }
 
@@ -1204,3 +1359,11 @@ bool optimizations::cacheWorkGroupDMAAccess(const Module& module, Method& method
     // XXX
     return eliminateDeadCode(module, method, config);
 }
+
+bool optimizations::combineDMAAccesses(const Module& module, Method& method, const Configuration& config)
+{
+    FastSet<BasicBlock*> blocks;
+    for(auto& block : method)
+        blocks.emplace(&block);
+    return normalization::combineVPMAccess(blocks, method);
+}
@@ -156,6 +156,29 @@ namespace vc4c
 
         // TODO documentation, TODO move somewhere else?!
         bool cacheWorkGroupDMAAccess(const Module& module, Method& method, const Configuration& config);
+
+        /*
+         * Combines DMA accesses to memory addresses with a constant distance to each other within a basic block into
+         * single DMA accesses of multiple rows.
+         *
+         * In contrast to the combination of DMA accesses done when mapping the memory accesses, this also combines
+         * the accesses of the different iterations of unrolled loops and of merged basic blocks.
+         *
+         * Example:
+         *   %addr = add %out, %offset
+         *   [DMA write of 1 row of int to %addr]
+         *   %offset = add %offset, 64
+         *   %addr = add %out, %offset
+         *   [DMA write of 1 row of int to %addr]
+         *
+         * becomes:
+         *   %addr = add %out, %offset
+         *   %dma_address = %addr
+         *   %offset = add %offset, 64
+         *   %addr = add %out, %offset
+         *   [DMA write of 2 rows of int with a stride of 60 bytes to %dma_address]
+         */
+        bool combineDMAAccesses(const Module& module, Method& method, const Configuration& config);
     } // namespace optimizations
 } // namespace vc4c
 #endif /* COMBINER_H */
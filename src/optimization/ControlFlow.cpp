@@ -8,9 +8,11 @@
 
 #include "../InstructionWalker.h"
 #include "../Profiler.h"
+#include "../analysis/BlockFrequencies.h"
 #include "../analysis/ControlFlowGraph.h"
 #include "../analysis/ControlFlowLoop.h"
 #include "../analysis/DataDependencyGraph.h"
+#include "../analysis/DependencyGraph.h"
 #include "../intermediate/Helper.h"
 #include "../intermediate/TypeConversions.h"
 #include "../intermediate/VectorHelper.h"
@@ -128,13 +130,7 @@ static Optional<unsigned> calculateIterationCount(
     return {};
 }
 
-/*
- * For now uses a very simple algorithm:
- * - checks the maximum vector-width used inside the loop
- * - tries to find an optimal factor, which never exceeds 16 elements and divides the number of iterations equally
- */
-static Optional<unsigned> determineVectorizationFactor(const ControlFlowLoop& loop,
-    const InductionVariable& inductionVariable, Literal lowerBound, Literal upperBound, Literal stepValue)
+static unsigned char determineMaximumVectorWidth(const ControlFlowLoop& loop)
 {
     unsigned char maxTypeWidth = 1;
     InstructionWalker it = loop.front()->key->walk();
@@ -151,6 +147,18 @@ static Optional<unsigned> determineVectorizationFactor(const ControlFlowLoop& lo
     CPPLOG_LAZY(logging::Level::DEBUG,
         log << "Found maximum used vector-width of " << static_cast<unsigned>(maxTypeWidth) << " elements"
             << logging::endl);
+    return maxTypeWidth;
+}
+
+/*
+ * For now uses a very simple algorithm:
+ * - checks the maximum vector-width used inside the loop
+ * - tries to find an optimal factor, which never exceeds 16 elements and divides the number of iterations equally
+ */
+static Optional<unsigned> determineVectorizationFactor(const ControlFlowLoop& loop,
+    const InductionVariable& inductionVariable, Literal lowerBound, Literal upperBound, Literal stepValue)
+{
+    auto maxTypeWidth = determineMaximumVectorWidth(loop);
 
     // the number of iterations from the bounds depends on the iteration operation
     auto iterations = calculateIterationCount(inductionVariable, lowerBound, upperBound, stepValue);
@@ -173,6 +181,25 @@ static Optional<unsigned> determineVectorizationFactor(const ControlFlowLoop& lo
     return factor;
 }
 
+/*
+ * Variant for loops where the number of iterations is only known at run-time.
+ *
+ * Since the iterations not filling a whole vector are executed by a scalar copy of the loop, the factor does not need
+ * to divide the number of iterations. Instead, it is the biggest power of two fitting into 16 SIMD-elements, which
+ * allows to calculate the number of remaining iterations with a simple bit-mask.
+ */
+static unsigned determineVectorizationFactor(const ControlFlowLoop& loop)
+{
+    auto maxTypeWidth = determineMaximumVectorWidth(loop);
+
+    unsigned factor = 16;
+    while(factor * maxTypeWidth > 16)
+        factor /= 2;
+    CPPLOG_LAZY(
+        logging::Level::DEBUG, log << "Determined possible vectorization-factor of " << factor << logging::endl);
+    return factor;
+}
+
 /*
  * On the cost-side, we have (as increments):
  * - instructions inserted to construct vectors from scalars
@@ -704,6 +731,350 @@ static void vectorize(ControlFlowLoop& loop, InductionVariable& inductionVariabl
         log << "Vectorization done, changed " << numVectorized << " instructions!" << logging::endl);
 }
 
+/*
+ * The blocks and values required to execute the iterations not filling a whole vector (for loops with an iteration
+ * count only known at run-time) in a scalar copy of the vectorized loop
+ */
+struct ScalarRemainder
+{
+    // The header block of the scalar copy of the loop
+    BasicBlock* header;
+    // The copy of the induction variable used by the scalar copy of the loop
+    Value inductionVariable;
+    // The first value of the induction variable not handled by the vectorized loop
+    Value vectorEnd;
+};
+
+/*
+ * Returns the basic blocks of the loop in the order of the function, if the loop consists of consecutive blocks
+ * starting with the loop header and only the last block exits the loop.
+ */
+static FastAccessList<BasicBlock*> findConsecutiveLoopBlocks(Method& method, const ControlFlowLoop& loop)
+{
+    FastAccessList<BasicBlock*> blocks;
+    auto header = loop.getHeader();
+    auto successor = loop.findSuccessor();
+    if(!header || !successor)
+        return blocks;
+
+    auto blockIt = std::find_if(
+        method.begin(), method.end(), [&](const BasicBlock& block) -> bool { return &block == header->key; });
+    for(; blockIt != method.end() && blocks.size() < loop.size(); ++blockIt)
+    {
+        if(std::none_of(
+               loop.begin(), loop.end(), [&](const CFGNode* node) -> bool { return node->key == &(*blockIt); }))
+            return FastAccessList<BasicBlock*>{};
+        blocks.push_back(&(*blockIt));
+    }
+    if(blocks.size() != loop.size())
+        return FastAccessList<BasicBlock*>{};
+
+    bool hasSingleExit = true;
+    for(const CFGNode* node : loop)
+    {
+        if(node->key == blocks.back())
+            continue;
+        node->forAllOutgoingEdges([&](const CFGNode& neighbor, const CFGEdge& edge) -> bool {
+            if(&neighbor == successor)
+                hasSingleExit = false;
+            return hasSingleExit;
+        });
+    }
+    if(!hasSingleExit)
+        return FastAccessList<BasicBlock*>{};
+    return blocks;
+}
+
+static FastSet<const Local*> findLocalsWrittenInLoop(const FastAccessList<BasicBlock*>& loopBlocks)
+{
+    FastSet<const Local*> locals;
+    for(auto block : loopBlocks)
+    {
+        for(auto it = block->walk(); !it.isEndOfBlock(); it.nextInBlock())
+        {
+            if(it.has() && it->checkOutputLocal())
+                locals.emplace(it->checkOutputLocal());
+        }
+    }
+    return locals;
+}
+
+/*
+ * Returns the instructions in the last block of the loop comparing the next value of the induction variable to the
+ * upper bound
+ */
+static FastAccessList<InstructionWalker> findUpperBoundComparisons(
+    BasicBlock& tail, const InductionVariable& inductionVariable)
+{
+    FastAccessList<InstructionWalker> comparisons;
+    auto stepLocal = inductionVariable.inductionStep->checkOutputLocal();
+    auto boundLocal = inductionVariable.repeatCondition->second.checkLocal();
+    if(!stepLocal || !boundLocal)
+        return comparisons;
+    for(auto it = tail.walk(); !it.isEndOfBlock(); it.nextInBlock())
+    {
+        auto op = it.get<intermediate::Operation>();
+        if(op && (op->op == OP_XOR || op->op == OP_MIN || op->op == OP_MAX || op->op == OP_SUB) &&
+            op->readsLocal(stepLocal) && op->readsLocal(boundLocal))
+            comparisons.push_back(it);
+    }
+    return comparisons;
+}
+
+/*
+ * Checks whether the iterations of the loop not filling a whole vector can be executed by a scalar copy of the loop:
+ * - the loop iterates in steps of +1 while the induction variable is less than (or not equal to) the upper bound
+ * - the loop consists of consecutive blocks and is only left from its last block
+ * - no value calculated inside the loop is used after the loop, since it would need to be merged from both loops
+ * - the loop does not access any stack allocation, since it would be duplicated when copying the loop
+ */
+static bool canInsertScalarRemainder(const ControlFlowLoop& loop, const InductionVariable& inductionVariable,
+    Literal stepValue, const FastAccessList<BasicBlock*>& loopBlocks)
+{
+    auto comparison = inductionVariable.repeatCondition->first;
+    if(comparison != intermediate::COMP_SIGNED_LT && comparison != intermediate::COMP_UNSIGNED_LT &&
+        comparison != intermediate::COMP_NEQ)
+    {
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Unsupported comparison for vectorizing loop with dynamic upper bound: " << comparison
+                << logging::endl);
+        return false;
+    }
+    if(inductionVariable.inductionStep->op != OP_ADD || stepValue.signedInt() != 1)
+    {
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Unsupported induction step for vectorizing loop with dynamic upper bound: "
+                << inductionVariable.inductionStep->to_string() << logging::endl);
+        return false;
+    }
+    if(loopBlocks.empty() || !loop.findPredecessor())
+    {
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Unsupported loop structure for vectorizing loop with dynamic upper bound" << logging::endl);
+        return false;
+    }
+
+    auto writtenLocals = findLocalsWrittenInLoop(loopBlocks);
+    if(writtenLocals.find(inductionVariable.repeatCondition->second.checkLocal()) != writtenLocals.end())
+    {
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Upper bound is modified inside of the loop: " << inductionVariable.repeatCondition->second.to_string()
+                << logging::endl);
+        return false;
+    }
+    for(auto local : writtenLocals)
+    {
+        for(const auto& pair : local->getUsers())
+        {
+            // the only value set outside of the loop is the initial value of the induction variable
+            if(!loop.findInLoop(pair.first) && (local != inductionVariable.local || pair.second.readsLocal()))
+            {
+                CPPLOG_LAZY(logging::Level::DEBUG,
+                    log << "Local is accessed outside of loop with dynamic upper bound: " << pair.first->to_string()
+                        << logging::endl);
+                return false;
+            }
+        }
+    }
+    for(auto block : loopBlocks)
+    {
+        for(auto it = block->walk(); !it.isEndOfBlock(); it.nextInBlock())
+        {
+            if(!it.has())
+                continue;
+            bool accessesStack = false;
+            it->forUsedLocals([&](const Local* local, LocalUse::Type, const intermediate::IntermediateInstruction&) {
+                for(auto loc = local; loc != nullptr; loc = loc->reference.first)
+                    accessesStack = accessesStack || loc->is<StackAllocation>();
+            });
+            if(accessesStack)
+            {
+                CPPLOG_LAZY(logging::Level::DEBUG,
+                    log << "Cannot copy loop accessing stack allocations: " << it->to_string() << logging::endl);
+                return false;
+            }
+        }
+    }
+
+    if(findUpperBoundComparisons(*loopBlocks.back(), inductionVariable).empty())
+    {
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Failed to find comparison with dynamic upper bound for: " << inductionVariable.local->to_string()
+                << logging::endl);
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Inserts a scalar copy of the loop (before it is vectorized) directly after the loop, which executes the remaining
+ * iterations not filling a whole vector:
+ *
+ * loop:            (vectorized afterwards)
+ *   ...
+ *   repeat while the next induction variable is less than (or not equal to) %vector_end
+ * remainder_exit:
+ *   %remainder_iv = %vector_end
+ *   skip remainder if %vector_end == upper bound
+ * remainder_loop:  (scalar copy of the original loop)
+ *   ...
+ *   repeat while the next remainder induction variable is less than (or not equal to) the upper bound
+ * successor:
+ *
+ * The calculation of %vector_end is inserted in front of the loop after vectorizing the loop.
+ */
+static ScalarRemainder insertScalarRemainder(
+    Method& method, const InductionVariable& inductionVariable, const FastAccessList<BasicBlock*>& loopBlocks)
+{
+    auto& tail = *loopBlocks.back();
+    const Value& upperBound = inductionVariable.repeatCondition->second;
+    auto writtenLocals = findLocalsWrittenInLoop(loopBlocks);
+
+    // find successor block before modifying the control flow
+    const Local* successorLabel = nullptr;
+    for(auto it = tail.walk(); !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(auto branch = it.get<intermediate::Branch>())
+        {
+            if(std::none_of(loopBlocks.begin(), loopBlocks.end(), [&](const BasicBlock* block) -> bool {
+                   return block->getLabel()->getLabel() == branch->getTarget();
+               }))
+                successorLabel = branch->getTarget();
+        }
+    }
+
+    auto insertIt =
+        std::find_if(method.begin(), method.end(), [&](const BasicBlock& block) -> bool { return &block == &tail; });
+    ++insertIt;
+    if(!successorLabel)
+        // the loop is left via fall-through
+        successorLabel = insertIt->getLabel()->getLabel();
+
+    auto& exitBlock =
+        method.createAndInsertNewBlock(insertIt, method.addNewLocal(TYPE_LABEL, "%vector_remainder").local()->name);
+    const std::string prefix = exitBlock.getLabel()->getLabel()->name + '.';
+
+    // copy the loop blocks, only the locals written inside the loop (including the block labels) are renamed
+    intermediate::InlineMapping mapping;
+    FastAccessList<BasicBlock*> copiedBlocks;
+    copiedBlocks.reserve(loopBlocks.size());
+    for(auto block : loopBlocks)
+    {
+        auto& copy = method.createAndInsertNewBlock(insertIt, prefix + block->getLabel()->getLabel()->name);
+        mapping.emplace(block->getLabel()->getLabel(), copy.getLabel()->getLabel());
+        copiedBlocks.push_back(&copy);
+    }
+    for(auto block : loopBlocks)
+    {
+        for(auto it = block->walk(); !it.isEndOfBlock(); it.nextInBlock())
+        {
+            if(!it.has())
+                continue;
+            it->forUsedLocals([&](const Local* local, LocalUse::Type, const intermediate::IntermediateInstruction&) {
+                for(auto loc = local; loc != nullptr; loc = loc->reference.first)
+                {
+                    if(writtenLocals.find(loc) == writtenLocals.end())
+                        mapping.emplace(loc, loc);
+                }
+            });
+        }
+    }
+    for(std::size_t i = 0; i < loopBlocks.size(); ++i)
+    {
+        auto copyIt = copiedBlocks[i]->walkEnd();
+        for(auto it = loopBlocks[i]->walk().nextInBlock(); !it.isEndOfBlock(); it.nextInBlock())
+        {
+            if(!it.has())
+                continue;
+            copyIt.emplace(it->copyFor(method, prefix, mapping));
+            copyIt.nextInBlock();
+        }
+    }
+
+    ScalarRemainder remainder{copiedBlocks.front(), mapping.at(inductionVariable.local)->createReference(),
+        method.addNewLocal(upperBound.type, "%vector_end")};
+
+    // initialize remainder loop and skip it, if there are no more iterations left
+    auto it = exitBlock.walkEnd();
+    assign(it, remainder.inductionVariable) = (remainder.vectorEnd, InstructionDecorations::PHI_NODE);
+    auto cond = assignNop(it) = as_signed{remainder.vectorEnd} == as_signed{upperBound};
+    auto condValue = method.addNewLocal(TYPE_BOOL, "%vector_remainder_skip");
+    assign(it, condValue) = (BOOL_TRUE, cond);
+    assign(it, condValue) = (BOOL_TRUE ^ BOOL_TRUE, cond.invert());
+    it.emplace(new intermediate::Branch(successorLabel, COND_ZERO_CLEAR, condValue));
+
+    // leave the (to be vectorized) loop into the remainder block instead of the successor
+    for(auto& comparison : findUpperBoundComparisons(tail, inductionVariable))
+        comparison->replaceValue(upperBound, remainder.vectorEnd, LocalUse::Type::READER);
+    for(auto tailIt = tail.walk(); !tailIt.isEndOfBlock(); tailIt.nextInBlock())
+    {
+        auto branch = tailIt.get<intermediate::Branch>();
+        if(branch && branch->getTarget() == successorLabel)
+            tailIt.reset((new intermediate::Branch(
+                              exitBlock.getLabel()->getLabel(), branch->conditional, branch->getCondition()))
+                             ->copyExtrasFrom(branch));
+    }
+
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Inserted scalar remainder loop starting at: " << remainder.header->to_string() << logging::endl);
+    return remainder;
+}
+
+/*
+ * Inserts a block in front of the (already vectorized) loop which calculates the end of the vectorized iterations and
+ * directly jumps to the scalar remainder loop, if there are not enough iterations to fill a single vector:
+ *
+ * vector_guard:
+ *   %remainder_iv = lower bound
+ *   %count = upper bound - lower bound
+ *   %vector_end = upper bound - (%count & (factor - 1))
+ *   skip vectorized loop if %count < factor
+ * loop:
+ */
+static void insertVectorizationGuard(Method& method, const ControlFlowLoop& loop,
+    const FastAccessList<BasicBlock*>& loopBlocks, const ScalarRemainder& remainder, const Value& upperBound,
+    Literal lowerBound, unsigned vectorizationFactor)
+{
+    auto& header = *loopBlocks.front();
+    auto predecessor = loop.findPredecessor();
+    auto headerIt =
+        std::find_if(method.begin(), method.end(), [&](const BasicBlock& block) -> bool { return &block == &header; });
+    auto& guardBlock =
+        method.createAndInsertNewBlock(headerIt, method.addNewLocal(TYPE_LABEL, "%vector_guard").local()->name);
+
+    // enter the loop via the guard block
+    for(auto it = predecessor->key->walk(); !it.isEndOfBlock(); it.nextInBlock())
+    {
+        auto branch = it.get<intermediate::Branch>();
+        if(branch && branch->getTarget() == header.getLabel()->getLabel())
+            it.reset((new intermediate::Branch(
+                          guardBlock.getLabel()->getLabel(), branch->conditional, branch->getCondition()))
+                         ->copyExtrasFrom(branch));
+    }
+
+    auto it = guardBlock.walkEnd();
+    Value startValue(lowerBound, upperBound.type);
+    if(!normalization::toImmediate(lowerBound))
+    {
+        startValue = method.addNewLocal(upperBound.type, "%vector_start");
+        it.emplace(new intermediate::LoadImmediate(startValue, lowerBound));
+        it.nextInBlock();
+    }
+    assign(it, remainder.inductionVariable) = (startValue, InstructionDecorations::PHI_NODE);
+    auto count = assign(it, upperBound.type, "%vector_count") = upperBound - startValue;
+    const Value factorMask(Literal(vectorizationFactor - 1u), TYPE_INT8);
+    auto rest = assign(it, upperBound.type, "%vector_rest") = count & factorMask;
+    assign(it, remainder.vectorEnd) = upperBound - rest;
+    auto cond = assignNop(it) = as_signed{count} <= as_signed{factorMask};
+    auto condValue = method.addNewLocal(TYPE_BOOL, "%vector_skip");
+    assign(it, condValue) = (BOOL_TRUE, cond);
+    assign(it, condValue) = (BOOL_TRUE ^ BOOL_TRUE, cond.invert());
+    it.emplace(new intermediate::Branch(remainder.header->getLabel()->getLabel(), COND_ZERO_CLEAR, condValue));
+
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Inserted vectorization guard: " << guardBlock.to_string() << logging::endl);
+}
+
 bool optimizations::vectorizeLoops(const Module& module, Method& method, const Configuration& config)
 {
     // 1. find loops
@@ -713,9 +1084,19 @@ bool optimizations::vectorizeLoops(const Module& module, Method& method, const C
 
     // 2. determine data dependencies of loop bodies
     auto dependencyGraph = DataDependencyGraph::createDependencyGraph(method);
+    // the loops where a scalar copy was inserted, which is not reflected in the loops nesting these loops
+    FastAccessList<const ControlFlowLoop*> copiedLoops;
 
     for(auto& loop : loops)
     {
+        if(std::any_of(copiedLoops.begin(), copiedLoops.end(),
+               [&](const ControlFlowLoop* other) -> bool { return loop.includes(*other) || other->includes(loop); }))
+        {
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Skipping loop nested with already vectorized loop with dynamic upper bound" << logging::endl);
+            continue;
+        }
+
         // 3. determine operation on iteration variable and bounds
         auto inductionVariable = extractLoopControl(loop, *dependencyGraph);
         PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 333, "Loops found", 1);
@@ -736,7 +1117,11 @@ bool optimizations::vectorizeLoops(const Module& module, Method& method, const C
         auto lowerBound = (inductionVariable.initialAssignment->precalculate(4).first & &Value::getLiteralValue);
         auto upperBound = inductionVariable.repeatCondition->second.getLiteralValue();
 
-        if(!lowerBound || !upperBound)
+        // an upper bound only known at run-time (e.g. a kernel parameter) is supported by executing the remaining
+        // iterations not filling a whole vector in a scalar copy of the loop
+        bool hasDynamicUpperBound = !upperBound && inductionVariable.repeatCondition->second.checkLocal();
+
+        if(!lowerBound || (!upperBound && !hasDynamicUpperBound))
         {
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "Upper or lower bound is not a literal value, aborting vectorization!" << logging::endl);
@@ -759,8 +1144,22 @@ bool optimizations::vectorizeLoops(const Module& module, Method& method, const C
             continue;
         }
 
+        FastAccessList<BasicBlock*> loopBlocks;
+        if(hasDynamicUpperBound)
+        {
+            loopBlocks = findConsecutiveLoopBlocks(method, loop);
+            if(!canInsertScalarRemainder(loop, inductionVariable, *stepConstant, loopBlocks))
+            {
+                CPPLOG_LAZY(logging::Level::DEBUG,
+                    log << "Cannot insert scalar remainder for loop with dynamic upper bound, aborting vectorization!"
+                        << logging::endl);
+                continue;
+            }
+        }
+
         // 4. determine vectorization factor
-        Optional<unsigned> vectorizationFactor =
+        Optional<unsigned> vectorizationFactor = hasDynamicUpperBound ?
+            determineVectorizationFactor(loop) :
             determineVectorizationFactor(loop, inductionVariable, *lowerBound, *upperBound, *stepConstant);
         if(!vectorizationFactor)
         {
@@ -788,10 +1187,22 @@ bool optimizations::vectorizeLoops(const Module& module, Method& method, const C
         }
 
         // 6. run vectorization
+        Optional<ScalarRemainder> remainder;
+        if(hasDynamicUpperBound)
+            // the loop needs to be copied before its instructions are vectorized
+            remainder = insertScalarRemainder(method, inductionVariable, loopBlocks);
         vectorize(loop, inductionVariable, method, *dependencyGraph, *vectorizationFactor, *stepConstant);
         // increasing the iteration step might create a value not fitting into small immediate
         normalization::handleImmediate(
             module, method, loop.findInLoop(inductionVariable.inductionStep).value(), config);
+        if(remainder)
+        {
+            // the initial value of the induction variable needs to be fixed before the loop predecessor changes
+            insertVectorizationGuard(method, loop, loopBlocks, *remainder, inductionVariable.repeatCondition->second,
+                *lowerBound, *vectorizationFactor);
+            copiedLoops.push_back(&loop);
+            PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 335, "Loops with scalar remainder", 1);
+        }
         hasChanged = true;
 
         PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 334, "Vectorization factors", *vectorizationFactor);
@@ -800,71 +1211,430 @@ bool optimizations::vectorizeLoops(const Module& module, Method& method, const C
     return hasChanged;
 }
 
-void optimizations::extendBranches(const Module& module, Method& method, const Configuration& config)
+Optional<unsigned> optimizations::determineConstantIterationCount(const InductionVariable& inductionVariable)
 {
-    auto it = method.walkAllInstructions();
-    // we only need to set the same flag once
-    std::pair<Value, intermediate::InstructionDecorations> lastSetFlags =
-        std::make_pair(UNDEFINED_VALUE, intermediate::InstructionDecorations::NONE);
-    while(!it.isEndOfMethod())
+    if(!inductionVariable.initialAssignment || !inductionVariable.inductionStep ||
+        !inductionVariable.repeatCondition || !inductionVariable.repeatCondition->first)
+        return {};
+    auto lowerBound = (inductionVariable.initialAssignment->precalculate(4).first & &Value::getLiteralValue);
+    auto upperBound = inductionVariable.repeatCondition->second.getLiteralValue();
+    Optional<Literal> stepConstant{};
+    if(auto stepValue = inductionVariable.inductionStep->findOtherArgument(inductionVariable.local->createReference()))
+        stepConstant =
+            ((stepValue->getSingleWriter() ? stepValue->getSingleWriter()->precalculate(4).first : stepValue) &
+                &Value::getLiteralValue);
+    if(!lowerBound || !upperBound || !stepConstant || stepConstant->signedInt() == 0)
+        return {};
+
+    // the iteration count calculation rounds down, which does not match the actual number of iterations if the
+    // distance is not a multiple of the step
+    auto distance = calculateDistance(inductionVariable, *lowerBound, *upperBound);
+    if(!distance || (*distance % static_cast<unsigned>(std::abs(stepConstant->signedInt()))) != 0)
+        return {};
+    return calculateIterationCount(inductionVariable, *lowerBound, *upperBound, *stepConstant);
+}
+
+/*
+ * Unrolls the single block of the loop by the given factor by inserting (factor - 1) copies of the loop body in front
+ * of the original body.
+ *
+ * The copies do neither contain the branches nor the calculation of the branch conditions, since the branches are
+ * never taken for the number of iterations being a multiple of the unroll factor.
+ * If the loop is completely unrolled, the branches are also removed from the original body.
+ */
+static void unrollLoop(Method& method, BasicBlock& block, const BasicBlock* successor, unsigned factor,
+    bool unrollCompletely)
+{
+    FastAccessList<InstructionWalker> body;
+    FastAccessList<InstructionWalker> branches;
+    FastSet<const Local*> branchConditions;
+    for(auto it = block.walk().nextInBlock(); !it.isEndOfBlock(); it.nextInBlock())
     {
+        if(!it.has())
+            continue;
         if(auto branch = it.get<intermediate::Branch>())
         {
-            CPPLOG_LAZY(logging::Level::DEBUG, log << "Extending branch: " << branch->to_string() << logging::endl);
-            if(branch->hasConditionalExecution() || !branch->getCondition().hasLiteral(Literal(true)))
-            {
-                /*
-                 * branch can only depend on scalar value
-                 * -> set any not used vector-element (all except element 0) to a value where it doesn't influence
-                 * the condition
-                 *
-                 * Using ELEMENT_NUMBER sets the vector-elements 1 to 15 to a non-zero value and 0 to either 0 (if
-                 * condition was false) or 1 (if condition was true)
-                 */
-                // TODO can be skipped, if it is checked/guaranteed, that the last instruction setting flags is the
-                // boolean-selection for the given condition  but we need to check more than the last instructions,
-                // since there could be moves inserted by phi
-
-                // skip setting of flags, if the previous setting wrote the same flags
-                if(lastSetFlags.first != branch->getCondition() ||
-                    branch->hasDecoration(intermediate::InstructionDecorations::BRANCH_ON_ALL_ELEMENTS) !=
-                        has_flag(lastSetFlags.second, intermediate::InstructionDecorations::BRANCH_ON_ALL_ELEMENTS))
-                {
-                    auto cond = branch->getCondition();
-                    if(auto lit = cond.getLiteralValue())
-                    {
-                        if(auto imm = normalization::toImmediate(*lit))
-                            cond = Value(*imm, cond.type);
-                        else
-                            throw CompilationError(CompilationStep::NORMALIZER,
-                                "Unhandled literal value in branch condition", branch->to_string());
-                    }
-                    if(branch->hasDecoration(intermediate::InstructionDecorations::BRANCH_ON_ALL_ELEMENTS))
-                        assign(it, NOP_REGISTER) = (branch->getCondition() | cond, SetFlag::SET_FLAGS);
-                    else
-                        assign(it, NOP_REGISTER) = (ELEMENT_NUMBER_REGISTER | cond, SetFlag::SET_FLAGS);
-                }
-                lastSetFlags.first = branch->getCondition();
-                lastSetFlags.second = branch->decoration;
-            }
-            // go to next instruction
-            it.nextInBlock();
-            // insert 3 NOPs before
-            it.emplace(new intermediate::Nop(intermediate::DelayType::BRANCH_DELAY));
-            it.emplace(new intermediate::Nop(intermediate::DelayType::BRANCH_DELAY));
-            it.emplace(new intermediate::Nop(intermediate::DelayType::BRANCH_DELAY));
+            branches.push_back(it);
+            if(auto cond = branch->getCondition().checkLocal())
+                branchConditions.emplace(cond);
         }
-        else if(it.get() != nullptr && it->setFlags == SetFlag::SET_FLAGS)
+        else
+            body.push_back(it);
+    }
+
+    // the calculation of the branch conditions is only removed if they are not used for anything else
+    for(auto it = branchConditions.begin(); it != branchConditions.end();)
+    {
+        bool onlyUsedForBranches = true;
+        (*it)->forUsers(LocalUse::Type::READER, [&](const LocalUser* reader) {
+            onlyUsedForBranches = onlyUsedForBranches && dynamic_cast<const intermediate::Branch*>(reader) != nullptr;
+        });
+        if(onlyUsedForBranches)
+            ++it;
+        else
+            it = branchConditions.erase(it);
+    }
+    auto isBranchCondition = [&](const InstructionWalker& it) -> bool {
+        auto out = it->checkOutputLocal();
+        return out && branchConditions.find(out) != branchConditions.end();
+    };
+
+    // an empty prefix together with all used locals mapped to themselves creates exact copies of the instructions
+    intermediate::InlineMapping mapping;
+    for(auto& it : body)
+    {
+        it->forUsedLocals([&](const Local* local, LocalUse::Type, const intermediate::IntermediateInstruction&) {
+            for(auto loc = local; loc != nullptr; loc = loc->reference.first)
+                mapping.emplace(loc, loc);
+        });
+    }
+
+    auto insertIt = block.walk().nextInBlock();
+    for(unsigned i = 1; i < factor; ++i)
+    {
+        for(auto& it : body)
         {
-            // any other instruction setting flags, need to re-set the branch-condition
-            lastSetFlags = std::make_pair(UNDEFINED_VALUE, intermediate::InstructionDecorations::NONE);
+            if(isBranchCondition(it))
+                continue;
+            insertIt.emplace(it->copyFor(method, "", mapping));
+            insertIt.nextInBlock();
         }
-        it.nextInMethod();
     }
-}
 
-static NODISCARD InstructionWalker loadVectorParameter(Parameter& param, Method& method, InstructionWalker it)
-{
+    if(!unrollCompletely)
+        return;
+
+    for(auto& it : branches)
+        it.erase();
+    for(auto& it : body)
+    {
+        if(isBranchCondition(it))
+            it.erase();
+    }
+
+    // the loop might have been left via an explicit branch to a block which is not the following block
+    auto blockIt =
+        std::find_if(method.begin(), method.end(), [&](const BasicBlock& b) -> bool { return &b == &block; });
+    ++blockIt;
+    if(blockIt == method.end() || &(*blockIt) != successor)
+        block.walkEnd().emplace(new intermediate::Branch(successor->getLabel()->getLabel(), COND_ALWAYS, BOOL_TRUE));
+}
+
+bool optimizations::unrollLoops(const Module& module, Method& method, const Configuration& config)
+{
+    auto& cfg = method.getCFG();
+    auto loops = cfg.findLoops(false);
+    bool hasChanged = false;
+
+    auto dependencyGraph = DataDependencyGraph::createDependencyGraph(method);
+    const unsigned maxInstructions = config.additionalOptions.maxUnrolledInstructions;
+    analysis::BlockFrequencies frequencies(method, config);
+
+    for(auto& loop : loops)
+    {
+        // only (tiny) inner loops consisting of a single block, which jumps back to itself, are unrolled
+        if(loop.size() != 1 || loop.isWorkGroupLoop())
+            continue;
+        auto& block = *loop.front()->key;
+        auto successor = loop.findSuccessor();
+        if(!successor)
+            continue;
+        if(frequencies.isNeverExecuted(block))
+        {
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Loop was never executed in the profiled execution, skipping unrolling: " << block.to_string()
+                    << logging::endl);
+            continue;
+        }
+
+        auto inductionVariable = extractLoopControl(loop, *dependencyGraph);
+        if(inductionVariable.local == nullptr)
+            continue;
+        auto iterations = determineConstantIterationCount(inductionVariable);
+        if(!iterations || *iterations < 2)
+        {
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Loop iteration count is not a compile-time constant, skipping unrolling: " << block.to_string()
+                    << logging::endl);
+            continue;
+        }
+
+        bool branchesAtEnd = true;
+        unsigned bodySize = 0;
+        for(auto it = block.walk().nextInBlock(); !it.isEndOfBlock(); it.nextInBlock())
+        {
+            if(!it.has())
+                continue;
+            if(it.get<intermediate::Branch>())
+                continue;
+            if(it.copy().previousInBlock().get<intermediate::Branch>())
+                branchesAtEnd = false;
+            ++bodySize;
+        }
+        if(!branchesAtEnd || bodySize == 0)
+            continue;
+
+        unsigned factor = 0;
+        bool unrollCompletely = false;
+        if(*iterations * bodySize <= maxInstructions)
+        {
+            factor = *iterations;
+            unrollCompletely = true;
+        }
+        else
+        {
+            // find the biggest factor dividing the number of iterations, so no check for leaving the loop is required
+            // within the unrolled iterations
+            factor = std::min(*iterations - 1, maxInstructions / bodySize);
+            while(factor > 1 && (*iterations % factor) != 0)
+                --factor;
+        }
+        if(factor < 2)
+            continue;
+
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << (unrollCompletely ? "Completely unrolling loop " : "Partially unrolling loop ") << block.to_string()
+                << " with " << *iterations << " iterations by factor " << factor << logging::endl);
+        unrollLoop(method, block, successor->key, factor, unrollCompletely);
+        hasChanged = true;
+        PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 336, "Unrolled loops", 1);
+        PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 337, "Unroll factors", factor);
+    }
+
+    return hasChanged;
+}
+
+void optimizations::extendBranches(const Module& module, Method& method, const Configuration& config)
+{
+    auto it = method.walkAllInstructions();
+    // we only need to set the same flag once
+    std::pair<Value, intermediate::InstructionDecorations> lastSetFlags =
+        std::make_pair(UNDEFINED_VALUE, intermediate::InstructionDecorations::NONE);
+    while(!it.isEndOfMethod())
+    {
+        if(auto branch = it.get<intermediate::Branch>())
+        {
+            CPPLOG_LAZY(logging::Level::DEBUG, log << "Extending branch: " << branch->to_string() << logging::endl);
+            if(branch->hasConditionalExecution() || !branch->getCondition().hasLiteral(Literal(true)))
+            {
+                /*
+                 * branch can only depend on scalar value
+                 * -> set any not used vector-element (all except element 0) to a value where it doesn't influence
+                 * the condition
+                 *
+                 * Using ELEMENT_NUMBER sets the vector-elements 1 to 15 to a non-zero value and 0 to either 0 (if
+                 * condition was false) or 1 (if condition was true)
+                 */
+                // TODO can be skipped, if it is checked/guaranteed, that the last instruction setting flags is the
+                // boolean-selection for the given condition  but we need to check more than the last instructions,
+                // since there could be moves inserted by phi
+
+                // skip setting of flags, if the previous setting wrote the same flags
+                if(lastSetFlags.first != branch->getCondition() ||
+                    branch->hasDecoration(intermediate::InstructionDecorations::BRANCH_ON_ALL_ELEMENTS) !=
+                        has_flag(lastSetFlags.second, intermediate::InstructionDecorations::BRANCH_ON_ALL_ELEMENTS))
+                {
+                    auto cond = branch->getCondition();
+                    if(auto lit = cond.getLiteralValue())
+                    {
+                        if(auto imm = normalization::toImmediate(*lit))
+                            cond = Value(*imm, cond.type);
+                        else
+                            throw CompilationError(CompilationStep::NORMALIZER,
+                                "Unhandled literal value in branch condition", branch->to_string());
+                    }
+                    if(branch->hasDecoration(intermediate::InstructionDecorations::BRANCH_ON_ALL_ELEMENTS))
+                        assign(it, NOP_REGISTER) = (branch->getCondition() | cond, SetFlag::SET_FLAGS);
+                    else
+                        assign(it, NOP_REGISTER) = (ELEMENT_NUMBER_REGISTER | cond, SetFlag::SET_FLAGS);
+                }
+                lastSetFlags.first = branch->getCondition();
+                lastSetFlags.second = branch->decoration;
+            }
+            // go to next instruction
+            it.nextInBlock();
+            // insert 3 NOPs before
+            it.emplace(new intermediate::Nop(intermediate::DelayType::BRANCH_DELAY));
+            it.emplace(new intermediate::Nop(intermediate::DelayType::BRANCH_DELAY));
+            it.emplace(new intermediate::Nop(intermediate::DelayType::BRANCH_DELAY));
+        }
+        else if(it.get() != nullptr && it->setFlags == SetFlag::SET_FLAGS)
+        {
+            // any other instruction setting flags, need to re-set the branch-condition
+            lastSetFlags = std::make_pair(UNDEFINED_VALUE, intermediate::InstructionDecorations::NONE);
+        }
+        it.nextInMethod();
+    }
+}
+
+/*
+ * Returns whether the given instruction can be moved into the delay slots of a branch.
+ *
+ * To not interfere with the hardware periphery or the already allocated registers, only simple unconditional
+ * operations on locals are moved.
+ */
+static bool canBeMovedIntoDelaySlot(const IntermediateInstruction* inst)
+{
+    if(inst == nullptr || !inst->mapsToASMInstruction())
+        return false;
+    if(!dynamic_cast<const Operation*>(inst) && !dynamic_cast<const LoadImmediate*>(inst) &&
+        (!dynamic_cast<const MoveOperation*>(inst) || dynamic_cast<const VectorRotation*>(inst)))
+        return false;
+    if(inst->hasSideEffects() || inst->hasConditionalExecution() || inst->signal != SIGNAL_NONE ||
+        inst->hasUnpackMode() || inst->hasPackMode() || inst->checkOutputLocal() == nullptr)
+        return false;
+    return std::none_of(inst->getArguments().begin(), inst->getArguments().end(),
+        [](const Value& arg) -> bool { return arg.checkRegister() != nullptr; });
+}
+
+static const IntermediateInstruction* findPreviousASMInstruction(InstructionWalker it)
+{
+    while(!it.isStartOfBlock())
+    {
+        it.previousInBlock();
+        if(!it.isStartOfBlock() && it.has() && it->mapsToASMInstruction())
+            return it.get();
+    }
+    return nullptr;
+}
+
+static const IntermediateInstruction* findNextASMInstruction(InstructionWalker it)
+{
+    while(!it.isEndOfMethod() && (it.isEndOfBlock() || !it.has() || !it->mapsToASMInstruction()))
+        it.nextInMethod();
+    return it.isEndOfMethod() ? nullptr : it.get();
+}
+
+bool optimizations::fillBranchDelaySlots(const Module& module, Method& method, const Configuration& config)
+{
+    std::size_t numDelaySlots = 0;
+    std::size_t numFilledSlots = 0;
+    for(auto& block : method)
+    {
+        // built lazily, since most blocks have no instruction which can be moved at all
+        std::unique_ptr<DependencyGraph> dependencies;
+        // instructions already moved into the delay slots of a previous branch must not be moved behind the next one
+        FastSet<const IntermediateInstruction*> movedInstructions;
+        auto it = block.walk().nextInBlock();
+        while(!it.isEndOfBlock())
+        {
+            auto branch = it.has() ? it.get<const Branch>() : nullptr;
+            if(branch == nullptr)
+            {
+                it.nextInBlock();
+                continue;
+            }
+
+            std::vector<InstructionWalker> delaySlots;
+            auto slotIt = it.copy().nextInBlock();
+            while(delaySlots.size() < 3 && !slotIt.isEndOfBlock() && slotIt.get<const Nop>() &&
+                slotIt.get<const Nop>()->type == DelayType::BRANCH_DELAY)
+            {
+                delaySlots.push_back(slotIt);
+                slotIt.nextInBlock();
+            }
+            numDelaySlots += delaySlots.size();
+
+            // the instruction setting the flags for the branch condition stays directly in front of the branch
+            const IntermediateInstruction* flagsSetter = findPreviousASMInstruction(it);
+            if(flagsSetter && flagsSetter->setFlags != SetFlag::SET_FLAGS)
+                flagsSetter = nullptr;
+            // Instructions can only be moved behind a flag setter which has no output. Since the register allocation
+            // already ran, the output of the flag setter could be mapped to the same register as the input of an
+            // instruction in front of it, even if they are different locals.
+            const bool isFlagsSetterWithoutOutput = flagsSetter &&
+                (!flagsSetter->getOutput() || flagsSetter->getOutput()->hasRegister(REG_NOP));
+
+            // collect the instructions directly preceding the branch (and the flag setter), which neither the branch
+            // nor the flag setter depend on
+            std::vector<InstructionWalker> candidates;
+            auto candidateIt = it.copy();
+            while(candidates.size() < delaySlots.size() && !candidateIt.isStartOfBlock())
+            {
+                candidateIt.previousInBlock();
+                if(candidateIt.isStartOfBlock())
+                    break;
+                if(!candidateIt.has())
+                    continue;
+                if(candidateIt.get() == flagsSetter)
+                {
+                    if(isFlagsSetterWithoutOutput)
+                        continue;
+                    break;
+                }
+                const IntermediateInstruction* inst = candidateIt.get();
+                if(!canBeMovedIntoDelaySlot(inst) || movedInstructions.find(inst) != movedInstructions.end())
+                    break;
+                if(!dependencies)
+                    dependencies = DependencyGraph::createGraph(block);
+                auto node = dependencies->findNode(inst);
+                if(node == nullptr)
+                    break;
+                bool isRequiredByBranch = false;
+                node->forAllOutgoingEdges([&](const DependencyNode& dependent, const DependencyEdge& edge) -> bool {
+                    if((dependent.key == branch || dependent.key == flagsSetter) &&
+                        remove_flag(edge.data.type, DependencyType::BRANCH_ORDER) != DependencyType{})
+                    {
+                        isRequiredByBranch = true;
+                        return false;
+                    }
+                    return true;
+                });
+                if(isRequiredByBranch)
+                    break;
+                candidates.push_back(candidateIt);
+            }
+
+            // The register allocation already made sure, there is a delay between writing a physical register and
+            // reading it. Since the moved instructions are not checked again, we need to retain these delays:
+            // - the last delay slot is directly followed by the branch target and the fall-through instruction
+            // - the flag setter is directly preceded by the instruction in front of the moved instructions
+            if(candidates.size() == 3)
+            {
+                auto output = candidates.front()->checkOutputLocal();
+                auto target = method.findBasicBlock(branch->getTarget());
+                auto targetInst = target ? findNextASMInstruction(target->walk()) : nullptr;
+                auto nextInst = findNextASMInstruction(slotIt);
+                if((targetInst && targetInst->readsLocal(output)) || (nextInst && nextInst->readsLocal(output)))
+                    candidates.pop_back();
+            }
+            while(flagsSetter != nullptr && !candidates.empty())
+            {
+                auto previous = findPreviousASMInstruction(candidates.back());
+                if(previous &&
+                    (previous->checkOutputLocal() == nullptr || !flagsSetter->readsLocal(previous->checkOutputLocal())))
+                    break;
+                // there might be a write to the condition in the preceding instruction (or block)
+                candidates.pop_back();
+            }
+
+            // move the instructions into the delay slots, retaining their order
+            std::reverse(candidates.begin(), candidates.end());
+            for(std::size_t i = 0; i < candidates.size(); ++i)
+            {
+                CPPLOG_LAZY(logging::Level::DEBUG,
+                    log << "Moving instruction into branch delay slot: " << candidates[i]->to_string()
+                        << logging::endl);
+                delaySlots[i].reset(candidates[i].release());
+                candidates[i].erase();
+                movedInstructions.emplace(delaySlots[i].get());
+            }
+            numFilledSlots += candidates.size();
+
+            it = slotIt;
+        }
+    }
+
+    CPPLOG_LAZY(logging::Level::INFO,
+        log << "Filled " << numFilledSlots << " of " << numDelaySlots
+            << " branch delay slots for kernel: " << method.name << logging::endl);
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 338, "Branch delay slots", numDelaySlots);
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 339, "Filled branch delay slots", numFilledSlots);
+    return numFilledSlots > 0;
+}
+
+static NODISCARD InstructionWalker loadVectorParameter(Parameter& param, Method& method, InstructionWalker it)
+{
     // we need to load a UNIFORM per vector element into the particular vector element
     for(uint8_t i = 0; i < param.type.getVectorWidth(); ++i)
     {
@@ -1387,6 +2157,515 @@ bool optimizations::removeConstantLoadInLoops(const Module& module, Method& meth
     return hasChanged;
 }
 
+/*
+ * Returns whether the instruction is a pure calculation which can be executed at any other position (e.g. in front of a
+ * loop) without changing the behavior of the program, as long as its operands have the same values there
+ */
+static bool isHoistableCalculation(const InstructionWalker& it)
+{
+    if(!it.has() || it->hasSideEffects() || it->hasConditionalExecution())
+        return false;
+    if(it->hasDecoration(InstructionDecorations::PHI_NODE))
+        // keep phi-nodes in place, they are required to determine the induction variables
+        return false;
+    if(!it.get<Operation>() && !it.get<MoveOperation>() && !it.get<LoadImmediate>())
+        return false;
+    if(it.get<VectorRotation>())
+        return false;
+    auto out = it->checkOutputLocal();
+    return out && out->getSingleWriter() == it.get();
+}
+
+/*
+ * Estimates the number of locals live throughout the whole loop (and therefore occupying a physical register for the
+ * whole loop), when the given instructions are moved out of the loop.
+ *
+ * These are all the locals read inside of the loop, which are not written by any of the instructions remaining in the
+ * loop.
+ */
+static std::size_t estimateLoopInvariantLocals(const FastAccessList<InstructionWalker>& loopInstructions,
+    const FastSet<const IntermediateInstruction*>& hoistedInstructions)
+{
+    FastSet<const Local*> writtenLocals;
+    FastSet<const Local*> readLocals;
+    for(const auto& it : loopInstructions)
+    {
+        if(hoistedInstructions.find(it.get()) != hoistedInstructions.end())
+            continue;
+        if(auto out = it->checkOutputLocal())
+            writtenLocals.emplace(out);
+        for(const auto& arg : it->getArguments())
+        {
+            auto loc = arg.checkLocal();
+            if(loc && !loc->type.isLabelType())
+                readLocals.emplace(loc);
+        }
+    }
+    return static_cast<std::size_t>(std::count_if(readLocals.begin(), readLocals.end(),
+        [&](const Local* loc) -> bool { return writtenLocals.find(loc) == writtenLocals.end(); }));
+}
+
+/*
+ * Returns the position in the preheader of the loop, where instructions moved out of the loop are inserted.
+ *
+ * If the loop has a single predecessor which only continues into the loop header, the instructions are inserted in
+ * front of its branches. Otherwise, a new preheader block is inserted in front of the loop header and all branches into
+ * the loop header from outside of the loop are redirected to this new block.
+ */
+static Optional<InstructionWalker> findOrCreatePreheader(
+    Method& method, const ControlFlowLoop& loop, const CFGNode& header, bool& createdBlock)
+{
+    auto predecessors = loop.findPredecessors();
+    if(predecessors.empty())
+        return {};
+    if(predecessors.size() == 1)
+    {
+        bool onlyEntersLoop = true;
+        predecessors.front()->forAllOutgoingEdges([&](const CFGNode& successor, const CFGEdge& edge) -> bool {
+            onlyEntersLoop = &successor == &header;
+            return onlyEntersLoop;
+        });
+        if(onlyEntersLoop)
+        {
+            auto it = predecessors.front()->key->walkEnd();
+            while(it.copy().previousInBlock().get<Branch>())
+                it.previousInBlock();
+            return it;
+        }
+    }
+
+    auto headerIt = std::find_if(
+        method.begin(), method.end(), [&](const BasicBlock& block) -> bool { return &block == header.key; });
+    if(headerIt == method.end())
+        return {};
+    if(headerIt != method.begin())
+    {
+        auto& previousBlock = *std::prev(headerIt);
+        auto isInLoop = std::any_of(
+            loop.begin(), loop.end(), [&](const CFGNode* node) -> bool { return node->key == &previousBlock; });
+        if(isInLoop && previousBlock.fallsThroughToNextBlock(false))
+            // the new block would be inserted into the (fall-through) back edge of the loop
+            return {};
+    }
+
+    auto& preheader =
+        method.createAndInsertNewBlock(headerIt, method.addNewLocal(TYPE_LABEL, "%loop_preheader").local()->name);
+    createdBlock = true;
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Inserted preheader for loop with header: " << header.key->to_string() << logging::endl);
+
+    // enter the loop via the preheader
+    for(auto predecessor : predecessors)
+    {
+        for(auto it = predecessor->key->walk(); !it.isEndOfBlock(); it.nextInBlock())
+        {
+            auto branch = it.get<Branch>();
+            if(branch && branch->getTarget() == header.key->getLabel()->getLabel())
+                it.reset((new Branch(preheader.getLabel()->getLabel(), branch->conditional, branch->getCondition()))
+                             ->copyExtrasFrom(branch));
+        }
+    }
+    return preheader.walkEnd();
+}
+
+bool optimizations::moveLoopInvariantCode(const Module& module, Method& method, const Configuration& config)
+{
+    const std::size_t maxInvariantLocals = config.useMultiThreading ?
+        config.additionalOptions.maxLoopInvariantLocals / 2 :
+        config.additionalOptions.maxLoopInvariantLocals;
+    bool hasChanged = false;
+    bool createdBlock = true;
+    while(createdBlock)
+    {
+        // inserting a new block invalidates the loops, so we need to start anew
+        createdBlock = false;
+        auto loops = method.getCFG().findLoops(true);
+        // handle inner loops first, so the instructions moved into their preheaders can then be moved out of the
+        // surrounding loops
+        std::stable_sort(loops.begin(), loops.end(),
+            [](const ControlFlowLoop& one, const ControlFlowLoop& other) -> bool { return one.size() < other.size(); });
+
+        for(auto& loop : loops)
+        {
+            auto header = loop.getHeader();
+            if(!header || loop.isWorkGroupLoop())
+                continue;
+
+            FastAccessList<InstructionWalker> loopInstructions;
+            FastSet<const IntermediateInstruction*> instructionsInLoop;
+            for(auto node : loop)
+            {
+                for(auto it = node->key->walk(); !it.isEndOfBlock(); it.nextInBlock())
+                {
+                    if(!it.has())
+                        continue;
+                    loopInstructions.emplace_back(it);
+                    instructionsInLoop.emplace(it.get());
+                }
+            }
+
+            // an operand is invariant, if it is a constant or all of its writers are outside of the loop or are moved
+            // out of the loop
+            FastAccessList<InstructionWalker> invariantInstructions;
+            FastSet<const IntermediateInstruction*> hoistedInstructions;
+            auto isInvariantOperand = [&](const Value& arg) -> bool {
+                if(auto loc = arg.checkLocal())
+                {
+                    bool writtenOutsideOfLoop = true;
+                    loc->forUsers(LocalUse::Type::WRITER, [&](const LocalUser* writer) {
+                        if(instructionsInLoop.find(writer) != instructionsInLoop.end() &&
+                            hoistedInstructions.find(writer) == hoistedInstructions.end())
+                            writtenOutsideOfLoop = false;
+                    });
+                    return writtenOutsideOfLoop;
+                }
+                if(arg.checkRegister())
+                    return arg.hasRegister(REG_ELEMENT_NUMBER) || arg.hasRegister(REG_QPU_NUMBER);
+                return true;
+            };
+            // repeat until no more invariant instructions are found, since an instruction can depend on invariant
+            // instructions found later in the loop (e.g. in a block placed after it)
+            bool foundInvariant = true;
+            while(foundInvariant)
+            {
+                foundInvariant = false;
+                for(auto& it : loopInstructions)
+                {
+                    if(hoistedInstructions.find(it.get()) == hoistedInstructions.end() &&
+                        isHoistableCalculation(it) &&
+                        std::all_of(it->getArguments().begin(), it->getArguments().end(), isInvariantOperand))
+                    {
+                        // NOTE: since operands are only invariant when their writers are already moved, the
+                        // instructions are inserted in an order satisfying their dependencies
+                        hoistedInstructions.emplace(it.get());
+                        invariantInstructions.emplace_back(it);
+                        foundInvariant = true;
+                    }
+                }
+            }
+
+            // do not move more values out of the loop than there are registers to hold them, otherwise the register
+            // allocation might fail. Drop the last found invariant instructions (which no other moved instruction
+            // depends on) until the number of locals live throughout the loop does not exceed the limit
+            const auto initialInvariantLocals = estimateLoopInvariantLocals(loopInstructions, {});
+            while(!invariantInstructions.empty())
+            {
+                auto numInvariantLocals = estimateLoopInvariantLocals(loopInstructions, hoistedInstructions);
+                if(numInvariantLocals <= maxInvariantLocals || numInvariantLocals <= initialInvariantLocals)
+                    break;
+                hoistedInstructions.erase(invariantInstructions.back().get());
+                invariantInstructions.pop_back();
+            }
+            if(invariantInstructions.empty())
+                continue;
+
+            auto insertIt = findOrCreatePreheader(method, loop, *header, createdBlock);
+            if(!insertIt)
+                continue;
+
+            for(auto& it : invariantInstructions)
+            {
+                CPPLOG_LAZY(logging::Level::DEBUG,
+                    log << "Moving loop invariant calculation out of loop: " << it->to_string() << logging::endl);
+                insertIt->emplace(it.release());
+                insertIt->nextInBlock();
+                it.erase();
+            }
+            hasChanged = true;
+            PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 341, "Loop invariant instructions moved",
+                invariantInstructions.size());
+
+            if(createdBlock)
+            {
+                PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 342, "Loop preheaders inserted", 1);
+                break;
+            }
+        }
+    }
+    return hasChanged;
+}
+
+/*
+ * A value calculated inside a loop which is a linear function of the loop's induction variable, i.e. a value of the
+ * form "factor * i + c" with some loop-invariant c
+ */
+struct LinearInductionValue
+{
+    // the factor of the induction variable (in modulo 2^32 arithmetic)
+    uint32_t factor;
+    // whether the calculation of the value contains a multiplication (or a shift) of the induction variable
+    bool hasMultiplication;
+    // the instructions calculating this value (from the induction variable and loop-invariant values), in order
+    FastAccessList<InstructionWalker> instructions;
+};
+
+/*
+ * Returns the linear factor of the given operand inside of the loop, if it is the induction variable, loop-invariant or
+ * a linear function of the induction variable calculated before in the same block
+ */
+static Optional<LinearInductionValue> getLinearOperand(const Value& arg, const Local* inductionVariable,
+    const FastSet<const IntermediateInstruction*>& loopInstructions,
+    const FastMap<const Local*, LinearInductionValue>& linearValues)
+{
+    if(arg.getLiteralValue())
+        return LinearInductionValue{0, false, {}};
+    if(arg.checkRegister())
+        return arg.hasRegister(REG_ELEMENT_NUMBER) || arg.hasRegister(REG_QPU_NUMBER) ?
+            LinearInductionValue{0, false, {}} :
+            Optional<LinearInductionValue>{};
+    auto loc = arg.checkLocal();
+    if(!loc)
+        return {};
+    if(loc == inductionVariable)
+        return LinearInductionValue{1, false, {}};
+    auto linearIt = linearValues.find(loc);
+    if(linearIt != linearValues.end())
+        return linearIt->second;
+    bool writtenInLoop = false;
+    loc->forUsers(LocalUse::Type::WRITER, [&](const LocalUser* writer) {
+        if(loopInstructions.find(writer) != loopInstructions.end())
+            writtenInLoop = true;
+    });
+    if(writtenInLoop)
+        // neither invariant nor a linear function of the induction variable
+        return {};
+    return LinearInductionValue{0, false, {}};
+}
+
+/*
+ * Determines whether the instruction calculates a linear function of the induction variable
+ */
+static Optional<LinearInductionValue> getLinearInductionValue(InstructionWalker it, const Local* inductionVariable,
+    const FastSet<const IntermediateInstruction*>& loopInstructions,
+    const FastMap<const Local*, LinearInductionValue>& linearValues)
+{
+    if(it->hasSideEffects() || it->hasConditionalExecution() || it->hasUnpackMode() || it->hasPackMode())
+        return {};
+    auto out = it->checkOutputLocal();
+    if(!out || out->getSingleWriter() != it.get())
+        return {};
+    auto op = it.get<Operation>();
+    auto move = it.get<MoveOperation>();
+    if((!op && !move) || it.get<VectorRotation>())
+        return {};
+
+    auto first = getLinearOperand(it->assertArgument(0), inductionVariable, loopInstructions, linearValues);
+    if(!first)
+        return {};
+    LinearInductionValue result = *first;
+    if(op && op->getSecondArg())
+    {
+        auto second = getLinearOperand(*op->getSecondArg(), inductionVariable, loopInstructions, linearValues);
+        if(!second)
+            return {};
+        auto firstLiteral = op->getFirstArg().getLiteralValue();
+        auto secondLiteral = op->getSecondArg()->getLiteralValue();
+        if(op->op == OP_ADD)
+            result.factor = first->factor + second->factor;
+        else if(op->op == OP_SUB)
+            result.factor = first->factor - second->factor;
+        else if(op->op == OP_SHL && secondLiteral && secondLiteral->unsignedInt() < 32)
+        {
+            result.factor = first->factor << secondLiteral->unsignedInt();
+            result.hasMultiplication = first->factor != 0;
+        }
+        // mul24 only multiplies the lower 24 bits, the other (non-constant) operand is known to fit into 24 bits,
+        // otherwise the multiplication would have been lowered to a full 32-bit multiplication
+        else if(op->op == OP_MUL24 && secondLiteral && secondLiteral->unsignedInt() < (1u << 24))
+        {
+            result.factor = first->factor * secondLiteral->unsignedInt();
+            result.hasMultiplication = first->factor != 0;
+        }
+        else if(op->op == OP_MUL24 && firstLiteral && firstLiteral->unsignedInt() < (1u << 24))
+        {
+            result.factor = second->factor * firstLiteral->unsignedInt();
+            result.hasMultiplication = second->factor != 0;
+        }
+        else
+            return {};
+        result.hasMultiplication = result.hasMultiplication || first->hasMultiplication || second->hasMultiplication;
+        for(const auto& inst : second->instructions)
+        {
+            if(std::find(result.instructions.begin(), result.instructions.end(), inst) == result.instructions.end())
+                result.instructions.emplace_back(inst);
+        }
+    }
+    else if(op)
+        // single-operand operations are not linear
+        return {};
+    result.instructions.emplace_back(it);
+    return result;
+}
+
+/*
+ * Clones the instructions calculating the linear value (with the current value of the induction variable) in front of
+ * the given position, writing the result into the given local
+ */
+static void insertLinearValueCalculation(
+    Method& method, InstructionWalker it, const LinearInductionValue& value, const Value& output)
+{
+    FastMap<const Local*, Value> mappedLocals;
+    auto mapArgument = [&](const Value& arg) -> Value {
+        auto loc = arg.checkLocal();
+        auto mappedIt = loc ? mappedLocals.find(loc) : mappedLocals.end();
+        return mappedIt != mappedLocals.end() ? mappedIt->second : arg;
+    };
+    for(const auto& inst : value.instructions)
+    {
+        const auto& origOutput = inst->getOutput().value();
+        auto newOutput = inst == value.instructions.back() ?
+            output :
+            method.addNewLocal(origOutput.type, "%strength_reduced_init");
+        IntermediateInstruction* newInst = nullptr;
+        if(auto op = inst.get<Operation>())
+            // only binary operations are linear, see above
+            newInst =
+                new Operation(op->op, newOutput, mapArgument(op->getFirstArg()), mapArgument(op->assertArgument(1)));
+        else
+            newInst = new MoveOperation(newOutput, mapArgument(inst->assertArgument(0)));
+        newInst->addDecorations(remove_flag(inst->decoration, InstructionDecorations::PHI_NODE));
+        it.emplace(newInst);
+        it.nextInBlock();
+        mappedLocals.emplace(origOutput.local(), newOutput);
+    }
+}
+
+bool optimizations::reduceInductionVariableStrength(const Module& module, Method& method, const Configuration& config)
+{
+    auto& cfg = method.getCFG();
+    auto loops = cfg.findLoops(true);
+    auto dependencyGraph = DataDependencyGraph::createDependencyGraph(method);
+    bool hasChanged = false;
+
+    for(auto& loop : loops)
+    {
+        if(loop.isWorkGroupLoop())
+            continue;
+        auto predecessor = loop.findPredecessor();
+        if(!predecessor)
+            continue;
+        for(auto& inductionVariable : loop.findInductionVariables(*dependencyGraph, false))
+        {
+            // the induction variable needs to be initialized in the block directly in front of the loop, so we can
+            // calculate the initial values of the derived values there
+            if(!predecessor->key->findWalkerForInstruction(
+                   inductionVariable.initialAssignment, predecessor->key->walkEnd()))
+                continue;
+
+            // determine the constant step
+            const auto* step = inductionVariable.inductionStep;
+            Optional<uint32_t> stepValue;
+            if(step->op == OP_ADD && step->getFirstArg().getLiteralValue())
+                stepValue = step->getFirstArg().getLiteralValue()->unsignedInt();
+            else if(step->op == OP_ADD && step->getSecondArg() && step->getSecondArg()->getLiteralValue())
+                stepValue = step->getSecondArg()->getLiteralValue()->unsignedInt();
+            else if(step->op == OP_SUB && step->getSecondArg() && step->getSecondArg()->getLiteralValue())
+                stepValue = 0u - step->getSecondArg()->getLiteralValue()->unsignedInt();
+            if(!stepValue)
+                continue;
+
+            // the single unconditional write of the induction variable inside of the loop (the phi-node)
+            FastAccessList<InstructionWalker> loopWriters;
+            inductionVariable.local->forUsers(LocalUse::Type::WRITER, [&](const LocalUser* writer) {
+                if(auto it = loop.findInLoop(writer))
+                    loopWriters.emplace_back(*it);
+            });
+            if(loopWriters.size() != 1 || loopWriters.front()->hasConditionalExecution())
+                continue;
+            auto updateIt = loopWriters.front();
+
+            FastSet<const IntermediateInstruction*> loopInstructions;
+            for(auto node : loop)
+            {
+                for(auto it = node->key->walk(); !it.isEndOfBlock(); it.nextInBlock())
+                {
+                    if(it.has())
+                        loopInstructions.emplace(it.get());
+                }
+            }
+
+            // find all values linear in the induction variable, which are not only used to calculate other linear
+            // values, e.g. the addresses calculated from the induction variable
+            FastAccessList<LinearInductionValue> candidates;
+            for(auto node : loop)
+            {
+                FastMap<const Local*, LinearInductionValue> linearValues;
+                FastSet<const IntermediateInstruction*> linearInstructions;
+                FastAccessList<LinearInductionValue> blockValues;
+                for(auto it = node->key->walk(); !it.isEndOfBlock(); it.nextInBlock())
+                {
+                    if(!it.has())
+                        continue;
+                    if(it == updateIt)
+                    {
+                        // the calculations after the update of the induction variable use the new value, so we cannot
+                        // combine them with the calculations before
+                        linearValues.clear();
+                        continue;
+                    }
+                    if(auto value =
+                            getLinearInductionValue(it, inductionVariable.local, loopInstructions, linearValues))
+                    {
+                        if(value->factor == 0)
+                            // loop-invariant, let the loop-invariant code motion handle this
+                            continue;
+                        linearValues.emplace(it->checkOutputLocal(), *value);
+                        linearInstructions.emplace(it.get());
+                        blockValues.emplace_back(*value);
+                    }
+                }
+                for(auto& value : blockValues)
+                {
+                    if(!value.hasMultiplication || value.instructions.size() < 2)
+                        continue;
+                    bool hasOtherReaders = false;
+                    value.instructions.back()->getOutput()->local()->forUsers(
+                        LocalUse::Type::READER, [&](const LocalUser* reader) {
+                            if(linearInstructions.find(reader) == linearInstructions.end())
+                                hasOtherReaders = true;
+                        });
+                    if(hasOtherReaders)
+                        candidates.emplace_back(std::move(value));
+                }
+            }
+            if(candidates.empty())
+                continue;
+
+            auto preheaderIt = predecessor->key->walkEnd();
+            while(preheaderIt.copy().previousInBlock().get<Branch>())
+                preheaderIt.previousInBlock();
+            auto incrementIt = updateIt.copy().nextInBlock();
+
+            // first insert all new calculations, since the candidates can share calculations with each other
+            FastAccessList<Value> newInductionVariables;
+            for(const auto& candidate : candidates)
+            {
+                const auto& output = candidate.instructions.back()->getOutput().value();
+                auto newInductionVariable = method.addNewLocal(output.type, "%strength_reduced");
+                insertLinearValueCalculation(method, preheaderIt, candidate, newInductionVariable);
+                preheaderIt.copy().previousInBlock()->addDecorations(InstructionDecorations::PHI_NODE);
+                const Value increment(Literal(candidate.factor * *stepValue), TYPE_INT32);
+                assign(incrementIt, newInductionVariable) =
+                    (newInductionVariable + increment, InstructionDecorations::PHI_NODE);
+                newInductionVariables.emplace_back(newInductionVariable);
+            }
+            for(std::size_t i = 0; i < candidates.size(); ++i)
+            {
+                auto it = candidates[i].instructions.back();
+                CPPLOG_LAZY(logging::Level::DEBUG,
+                    log << "Replacing calculation linear in induction variable '" << inductionVariable.local->name
+                        << "' with separate induction variable: " << it->to_string() << logging::endl);
+                it.reset((new MoveOperation(it->getOutput().value(), newInductionVariables[i]))
+                             ->addDecorations(it->decoration));
+            }
+            hasChanged = true;
+            PROFILE_COUNTER(
+                vc4c::profiler::COUNTER_OPTIMIZATION + 343, "Strength reduced induction values", candidates.size());
+        }
+    }
+    return hasChanged;
+}
+
 static const Local* findSourceBlock(const Local* label, const FastMap<const Local*, const Local*>& blockMap)
 {
     auto it = blockMap.find(label);
@@ -1488,8 +2767,90 @@ bool optimizations::mergeAdjacentBasicBlocks(const Module& module, Method& metho
     return !blocksToMerge.empty();
 }
 
+/*
+ * If the given block falls through to its successor, inserts an explicit branch to that successor, since the blocks
+ * might not be adjacent anymore after moving the block.
+ */
+static void insertExplicitFallThroughBranch(CFGNode& node)
+{
+    const CFGNode* fallThroughSuccessor = nullptr;
+    node.forAllOutgoingEdges([&](const CFGNode& successor, const CFGEdge& edge) -> bool {
+        if(edge.data.isImplicit(node.key))
+        {
+            if(fallThroughSuccessor)
+                throw CompilationError(
+                    CompilationStep::GENERAL, "Multiple implicit branches from basic block", node.key->to_string());
+            fallThroughSuccessor = &successor;
+        }
+        return true;
+    });
+    if(fallThroughSuccessor)
+    {
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Inserting explicit branch to previous fall-through successor for moved block '"
+                << node.key->to_string() << "' to '" << fallThroughSuccessor->key->to_string() << '\''
+                << logging::endl);
+        node.key->walkEnd().emplace(
+            new intermediate::Branch(fallThroughSuccessor->key->getLabel()->getLabel(), COND_ALWAYS, BOOL_TRUE));
+    }
+}
+
+/*
+ * Moves all blocks never executed in the profiled execution of the kernel behind the last block not falling through to
+ * its next block, so the executed blocks are placed next to each other.
+ *
+ * Only blocks not falling through from their previous block are moved, so no branches need to be inserted into any
+ * executed block.
+ */
+static void moveNeverExecutedBlocks(Method& method, const analysis::BlockFrequencies& frequencies)
+{
+    // find the insertion position, behind the last block not falling through
+    auto lastIt = method.end();
+    for(auto it = method.begin(); it != method.end(); ++it)
+    {
+        if(it->getLabel()->getLabel()->name != BasicBlock::LAST_BLOCK && !it->fallsThroughToNextBlock())
+            lastIt = it;
+    }
+    if(lastIt == method.end())
+        return;
+    auto destIt = lastIt;
+    ++destIt;
+
+    auto& cfg = method.getCFG();
+    auto prevIt = method.begin();
+    auto blockIt = method.begin();
+    ++blockIt;
+    // only blocks in front of the insertion position are moved, so every block is moved at most once
+    while(prevIt != lastIt && blockIt != lastIt)
+    {
+        if(blockIt->getLabel()->getLabel()->name != BasicBlock::LAST_BLOCK &&
+            frequencies.isNeverExecuted(*blockIt) && !prevIt->fallsThroughToNextBlock())
+        {
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Moving never executed block out of the way: " << blockIt->to_string() << logging::endl);
+            auto& node = cfg.assertNode(&(*blockIt));
+            auto nextIt = blockIt;
+            ++nextIt;
+            method.moveBlock(blockIt, destIt);
+            insertExplicitFallThroughBranch(node);
+            PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 348, "Never executed blocks moved", 1);
+            // prevIt stays the same, since it now is followed by the next block
+            blockIt = nextIt;
+        }
+        else
+        {
+            prevIt = blockIt;
+            ++blockIt;
+        }
+    }
+}
+
 bool optimizations::reorderBasicBlocks(const Module& module, Method& method, const Configuration& config)
 {
+    analysis::BlockFrequencies frequencies(method, config);
+    if(!frequencies.empty())
+        moveNeverExecutedBlocks(method, frequencies);
+
     auto& cfg = method.getCFG();
     auto blockIt = method.begin();
     auto prevIt = method.begin();
@@ -1499,8 +2860,10 @@ bool optimizations::reorderBasicBlocks(const Module& module, Method& method, con
         auto& node = cfg.assertNode(&(*blockIt));
         const auto predecessor = node.getSinglePredecessor();
         // Never re-order end-of-block. Though it should work, there could be trouble anyway
+        // Also never move blocks which were never executed back next to the executed blocks
         if(blockIt->getLabel()->getLabel()->name != BasicBlock::LAST_BLOCK && predecessor != nullptr &&
-            predecessor->key != &(*prevIt) && !prevIt->fallsThroughToNextBlock())
+            predecessor->key != &(*prevIt) && !prevIt->fallsThroughToNextBlock() &&
+            !frequencies.isNeverExecuted(*blockIt))
         {
             CPPLOG_LAZY(logging::Level::DEBUG,
                 log << "Reordering block with single predecessor not being the previous block: " << blockIt->to_string()
@@ -1527,26 +2890,7 @@ bool optimizations::reorderBasicBlocks(const Module& module, Method& method, con
 
             // if the now moved block did fall-through, we need to insert an explicit branch to its previous successor,
             // since they might now not longer be adjacent.
-            const CFGNode* fallThroughSuccessor = nullptr;
-            node.forAllOutgoingEdges([&](const CFGNode& successor, const CFGEdge& edge) -> bool {
-                if(edge.data.isImplicit(node.key))
-                {
-                    if(fallThroughSuccessor)
-                        throw CompilationError(CompilationStep::GENERAL, "Multiple implicit branches from basic block",
-                            node.key->to_string());
-                    fallThroughSuccessor = &successor;
-                }
-                return true;
-            });
-            if(fallThroughSuccessor)
-            {
-                CPPLOG_LAZY(logging::Level::DEBUG,
-                    log << "Inserting explicit branch to previous fall-through successor for moved block '"
-                        << node.key->to_string() << "' to '" << fallThroughSuccessor->key->to_string() << '\''
-                        << logging::endl);
-                node.key->walkEnd().emplace(new intermediate::Branch(
-                    fallThroughSuccessor->key->getLabel()->getLabel(), COND_ALWAYS, BOOL_TRUE));
-            }
+            insertExplicitFallThroughBranch(node);
         }
         else
         {
@@ -1700,10 +3044,44 @@ static FastAccessList<IfElseBlock> findIfElseBlocks(ControlFlowGraph& graph)
     return blocks;
 }
 
+/*
+ * Checks whether executing the instructions of all conditional blocks every time the predecessor is executed takes no
+ * more cycles than branching to (and back from) the blocks actually executed according to the block profile.
+ *
+ * If the execution counts of any of the involved blocks are unknown, the conversion is assumed to be profitable.
+ */
+static bool isConversionProfitable(const IfElseBlock& block, const analysis::BlockFrequencies& frequencies)
+{
+    // the branch to the conditional block and the branch to the successor, each with its 3 delay slots
+    static constexpr uint64_t BRANCH_CYCLES = 2 * 4;
+
+    auto predecessorCount = frequencies.getExecutionCount(*block.predecessor->key);
+    if(!predecessorCount)
+        return true;
+    uint64_t cyclesBefore = 0;
+    uint64_t numInstructions = 0;
+    for(auto succ : block.conditionalBlocks)
+    {
+        auto count = frequencies.getExecutionCount(*succ->key);
+        if(!count)
+            return true;
+        uint64_t blockSize = 0;
+        for(auto it = succ->key->walk().nextInBlock(); !it.isEndOfBlock(); it.nextInBlock())
+        {
+            if(it.has() && !it.get<intermediate::Branch>())
+                ++blockSize;
+        }
+        cyclesBefore += *count * (blockSize + BRANCH_CYCLES);
+        numInstructions += blockSize;
+    }
+    return *predecessorCount * numInstructions <= cyclesBefore;
+}
+
 bool optimizations::simplifyConditionalBlocks(const Module& module, Method& method, const Configuration& config)
 {
     // NOTE: boost-compute/test_binary_search.cl/calls to atomic_min are good test candidates!
     bool changedCode = false;
+    analysis::BlockFrequencies frequencies(method, config);
     for(const auto& block : findIfElseBlocks(method.getCFG()))
     {
         CPPLOG_LAZY_BLOCK(logging::Level::DEBUG, {
@@ -1714,6 +3092,14 @@ bool optimizations::simplifyConditionalBlocks(const Module& module, Method& meth
             logging::debug() << "Successor: " << block.successor->key->to_string() << logging::endl;
         });
 
+        if(!isConversionProfitable(block, frequencies))
+        {
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Skipping this candidate, since the profiled execution takes less cycles with branches"
+                    << logging::endl);
+            continue;
+        }
+
         bool hasSideEffects = false;
         FastSet<const Local*> nonlocalLocals;
         for(auto succ : block.conditionalBlocks)
@@ -2036,3 +3422,264 @@ bool optimizations::addWorkGroupLoop(const Module& module, Method& method, const
 
     return true;
 }
+
+/*
+ * Returns whether the instruction produces the same result in every repetition of the work-group loop, as long as its
+ * operands do. Unlike for other loop-invariant calculations, reading UNIFORMs and (conditionally) writing a local
+ * element-wise is allowed here, since the instructions are kept in their original order.
+ */
+static bool isRepetitionInvariantInstruction(const InstructionWalker& it)
+{
+    if(!it.get<Operation>() && !it.get<MoveOperation>() && !it.get<LoadImmediate>())
+        return false;
+    if(it.get<VectorRotation>() || it->hasDecoration(InstructionDecorations::PHI_NODE))
+        return false;
+    auto allowedSideEffects = add_flag(SideEffectType::REGISTER_READ, SideEffectType::FLAGS);
+    if(it->writesRegister(REG_TMU_NOSWAP))
+        // disabling the TMU swapping is a constant configuration which only needs to be written once
+        allowedSideEffects = add_flag(allowedSideEffects, SideEffectType::REGISTER_WRITE);
+    else if(it->checkOutputRegister() && !it->writesRegister(REG_NOP))
+        return false;
+    return !it->hasOtherSideEffects(allowedSideEffects);
+}
+
+/*
+ * Removes the reading and writing of the UNIFORM pointer value at the end of every work-group loop repetition and moves
+ * the remaining reads of the repetition block (the maximum group ids) into the given block.
+ *
+ * Returns whether the UNIFORM pointer value could be removed.
+ */
+static bool removeUniformAddressReset(Method& method, InstructionWalker resetIt, InstructionWalker& insertIt)
+{
+    auto& resetBlock = *resetIt.getBasicBlock();
+    auto resetMove = resetIt.get<MoveOperation>();
+    FastAccessList<InstructionWalker> uniformReads;
+    for(auto it = resetBlock.walk(); !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(it.has() && it->readsRegister(REG_UNIFORM))
+            uniformReads.emplace_back(it);
+    }
+    // the UNIFORM pointer value is the first UNIFORM read in the repetition block
+    if(uniformReads.empty())
+        return false;
+    auto addressRead = uniformReads.front();
+    if(addressRead.get() != resetMove)
+    {
+        auto tmp = resetMove->getSource().checkLocal();
+        if(!tmp || tmp->getSingleWriter() != addressRead.get() || tmp->getUsers(LocalUse::Type::READER).size() != 1)
+            return false;
+    }
+    for(auto it = uniformReads.begin() + 1; it != uniformReads.end(); ++it)
+    {
+        auto out = (*it)->checkOutputLocal();
+        if(!isRepetitionInvariantInstruction(*it) || (*it)->getArguments().size() != 1 || !out ||
+            out->getSingleWriter() != it->get())
+            return false;
+    }
+
+    for(auto it = uniformReads.begin() + 1; it != uniformReads.end(); ++it)
+    {
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Moving UNIFORM read out of work-group loop: " << (*it)->to_string() << logging::endl);
+        insertIt.emplace(it->release());
+        insertIt.nextInBlock();
+        it->erase();
+    }
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Removing reset of UNIFORM pointer, since no more UNIFORMs are read in work-group loop: "
+            << resetIt->to_string() << logging::endl);
+    if(addressRead.get() != resetMove)
+        addressRead.erase();
+    resetIt.erase();
+    method.metaData.uniformsUsed.setUniformAddressUsed(false);
+    return true;
+}
+
+bool optimizations::cacheWorkGroupUniforms(const Module& module, Method& method, const Configuration& config)
+{
+    // the work-group loop inserts a block in front of the actual kernel code which is only executed once
+    if(method.size() < 2 || !method.begin()->getLabel()->hasDecoration(InstructionDecorations::WORK_GROUP_LOOP))
+        return false;
+    auto& startBlock = *method.begin();
+    auto& headBlock = *std::next(method.begin());
+
+    // the instructions at the start of the head block need to be the first instructions executed in every repetition
+    bool onlyRepeatedByWorkGroupLoop = true;
+    headBlock.forPredecessors([&](InstructionWalker it) {
+        auto branch = it.get<Branch>();
+        if(it.getBasicBlock() != &startBlock &&
+            (!branch || !branch->hasDecoration(InstructionDecorations::WORK_GROUP_LOOP)))
+            onlyRepeatedByWorkGroupLoop = false;
+    });
+    if(!onlyRepeatedByWorkGroupLoop)
+        return false;
+
+    FastSet<const IntermediateInstruction*> startInstructions;
+    for(auto it = startBlock.walk(); !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(it.has())
+            startInstructions.emplace(it.get());
+    }
+    FastAccessList<InstructionWalker> loopInstructions;
+    Optional<InstructionWalker> resetIt;
+    for(auto blockIt = std::next(method.begin()); blockIt != method.end(); ++blockIt)
+    {
+        for(auto it = blockIt->walk(); !it.isEndOfBlock(); it.nextInBlock())
+        {
+            if(!it.has())
+                continue;
+            loopInstructions.emplace_back(it);
+            if(it->writesRegister(REG_UNIFORM_ADDRESS))
+            {
+                if(resetIt)
+                    // the UNIFORM pointer is also modified somewhere else, e.g. for image accesses
+                    return false;
+                resetIt = it;
+            }
+        }
+    }
+    if(!resetIt || !resetIt->get<MoveOperation>() || (*resetIt)->hasConditionalExecution())
+        return false;
+
+    // find the UNIFORMs read at the start of every repetition (i.e. the work-item info and the kernel parameters) which
+    // can be read once in front of the work-group loop
+    FastAccessList<InstructionWalker> cachedInstructions;
+    FastSet<const IntermediateInstruction*> hoistedInstructions;
+    auto isInvariantOperand = [&](const Value& arg) -> bool {
+        if(auto loc = arg.checkLocal())
+        {
+            bool invariant = true;
+            loc->forUsers(LocalUse::Type::WRITER, [&](const LocalUser* writer) {
+                if(startInstructions.find(writer) == startInstructions.end() &&
+                    hoistedInstructions.find(writer) == hoistedInstructions.end())
+                    invariant = false;
+            });
+            return invariant;
+        }
+        if(arg.checkRegister())
+            return arg.hasRegister(REG_UNIFORM) || arg.hasRegister(REG_ELEMENT_NUMBER) ||
+                arg.hasRegister(REG_QPU_NUMBER);
+        return true;
+    };
+    for(auto it = headBlock.walk().nextInBlock(); !it.isEndOfBlock(); it.nextInBlock())
+    {
+        if(!it.has())
+            continue;
+        // only take the instructions in order, so the UNIFORMs skipped at every repetition are the first ones
+        if(!isRepetitionInvariantInstruction(it) ||
+            !std::all_of(it->getArguments().begin(), it->getArguments().end(), isInvariantOperand))
+            break;
+        hoistedInstructions.emplace(it.get());
+        cachedInstructions.emplace_back(it);
+    }
+
+    auto truncate = [&](std::size_t newSize) {
+        while(cachedInstructions.size() > newSize)
+        {
+            hoistedInstructions.erase(cachedInstructions.back().get());
+            cachedInstructions.pop_back();
+        }
+    };
+    // with 2 hardware threads per QPU, every thread has only half of the physical registers available
+    const std::size_t maxInvariantLocals = config.useMultiThreading ?
+        config.additionalOptions.maxLoopInvariantLocals / 2 :
+        config.additionalOptions.maxLoopInvariantLocals;
+    const auto initialInvariantLocals = estimateLoopInvariantLocals(loopInstructions, {});
+    bool truncated = true;
+    while(truncated && !cachedInstructions.empty())
+    {
+        truncated = false;
+        // the values read once must not be (partially) overwritten by any instruction remaining in the loop
+        for(std::size_t i = 0; i < cachedInstructions.size() && !truncated; ++i)
+        {
+            if(auto out = cachedInstructions[i]->checkOutputLocal())
+            {
+                out->forUsers(LocalUse::Type::WRITER, [&](const LocalUser* writer) {
+                    if(hoistedInstructions.find(writer) == hoistedInstructions.end())
+                        truncated = true;
+                });
+                if(truncated)
+                    truncate(i);
+            }
+        }
+        if(truncated)
+            continue;
+
+        // flags set by the moved instructions must not be consumed by the instructions remaining in the loop
+        auto lastFlagIt = std::find_if(cachedInstructions.rbegin(), cachedInstructions.rend(),
+            [](const InstructionWalker& it) -> bool { return it->doesSetFlag(); });
+        if(lastFlagIt != cachedInstructions.rend())
+        {
+            for(auto it = cachedInstructions.back().copy().nextInBlock(); !it.isEndOfBlock(); it.nextInBlock())
+            {
+                if(!it.has())
+                    continue;
+                if(it->hasConditionalExecution())
+                {
+                    truncate(static_cast<std::size_t>(cachedInstructions.rend() - lastFlagIt) - 1);
+                    truncated = true;
+                    break;
+                }
+                if(it->doesSetFlag())
+                    break;
+            }
+            if(truncated)
+                continue;
+        }
+
+        // every value read only once occupies a physical register for the whole kernel execution, so only keep as
+        // many values as there are free registers
+        auto numInvariantLocals = estimateLoopInvariantLocals(loopInstructions, hoistedInstructions);
+        if(numInvariantLocals > maxInvariantLocals && numInvariantLocals > initialInvariantLocals)
+        {
+            truncate(cachedInstructions.size() - 1);
+            truncated = true;
+        }
+    }
+
+    const auto numCachedUniforms = static_cast<std::size_t>(std::count_if(cachedInstructions.begin(),
+        cachedInstructions.end(), [](const InstructionWalker& it) -> bool { return it->readsRegister(REG_UNIFORM); }));
+    if(numCachedUniforms == 0)
+        return false;
+
+    auto& resetBlock = *resetIt->getBasicBlock();
+    bool loopReadsOtherUniforms = std::any_of(loopInstructions.begin(), loopInstructions.end(),
+        [&](InstructionWalker& it) -> bool {
+            return hoistedInstructions.find(it.get()) == hoistedInstructions.end() &&
+                it.getBasicBlock() != &resetBlock && it->readsRegister(REG_UNIFORM);
+        });
+
+    auto insertIt = startBlock.walkEnd();
+    for(auto& it : cachedInstructions)
+    {
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Moving UNIFORM read out of work-group loop: " << it->to_string() << logging::endl);
+        insertIt.emplace(it.release());
+        insertIt.nextInBlock();
+        it.erase();
+    }
+
+    // if no more UNIFORMs are read within the loop, we do not need to reset the UNIFORM pointer (and therefore also do
+    // not need to pass its value), otherwise we skip the already read UNIFORMs when resetting the pointer
+    if(loopReadsOtherUniforms || !removeUniformAddressReset(method, *resetIt, insertIt))
+    {
+        auto resetMove = resetIt->get<MoveOperation>();
+        auto address = resetMove->getOutput().value();
+        auto base = resetMove->getSource();
+        if(base.hasRegister(REG_UNIFORM))
+            base = assign(*resetIt, TYPE_INT32, "%uniform_address") = UNIFORM_REGISTER;
+        assign(*resetIt, address) =
+            base + Value(Literal(static_cast<uint32_t>(numCachedUniforms * sizeof(uint32_t))), TYPE_INT32);
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Resetting UNIFORM pointer to skip cached UNIFORMs: "
+                << resetIt->copy().previousInBlock()->to_string() << logging::endl);
+        resetIt->erase();
+    }
+
+    CPPLOG_LAZY(logging::Level::INFO,
+        log << "Read " << numCachedUniforms << " UNIFORMs only once for all work-groups for kernel: " << method.name
+            << logging::endl);
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 349, "UNIFORM reads moved out of work-group loop",
+        numCachedUniforms);
+    return true;
+}
@@ -7,22 +7,47 @@
 #ifndef VC4C_OPTIMIZATION_CONTROLFLOW_H
 #define VC4C_OPTIMIZATION_CONTROLFLOW_H
 
+#include "Optional.h"
+
 namespace vc4c
 {
     class Method;
     class Module;
     struct Configuration;
+    struct InductionVariable;
 
     namespace optimizations
     {
         /*
          * Tries to find loops which then can be vectorized by combining multiple iterations into one.
          *
+         * Loops with an upper bound only known at run-time (e.g. a kernel parameter) are vectorized too, the remaining
+         * iterations not filling a whole vector are then executed by a scalar copy of the loop.
+         *
          * NOTE: Currently only works with "standard" for-range loops and needs to be enabled explicitly in the
          * Configuration
          */
         bool vectorizeLoops(const Module& module, Method& method, const Configuration& config);
 
+        /*
+         * Unrolls small loops consisting of a single basic block with a constant number of iterations.
+         *
+         * Loops where the unrolled body does not exceed the configured instruction threshold are completely unrolled,
+         * other loops are partially unrolled by the biggest factor fitting the threshold and dividing the number of
+         * iterations. This removes the branch (including its delay slots), the loop condition and the setting of
+         * flags for all removed iterations and gives the instruction scheduling more instructions to reorder.
+         *
+         * Loops never executed according to the block profile are not unrolled to not increase the code size for no
+         * gain.
+         */
+        bool unrollLoops(const Module& module, Method& method, const Configuration& config);
+
+        /*
+         * Returns the number of iterations of the loop controlled by the given induction variable, if the bounds and
+         * the step of the loop are compile-time constants
+         */
+        Optional<unsigned> determineConstantIterationCount(const InductionVariable& inductionVariable);
+
         /*
          * Extends the branches (up to now represented by a single instruction) by
          * inserting instructions setting the necessary flags (if required)
@@ -39,6 +64,32 @@ namespace vc4c
          */
         void extendBranches(const Module& module, Method& method, const Configuration& config);
 
+        /*
+         * Replaces the NOPs inserted into the delay slots of the branches with instructions preceding the branch,
+         * which neither the branch itself nor the setting of its condition depend on.
+         *
+         * Example:
+         *   %a = add %b, 1
+         *   - = or elem_num, %cond (setf)
+         *   br.ifzc %103
+         *   nop
+         *   nop
+         *   nop
+         *
+         * is converted to:
+         *   - = or elem_num, %cond (setf)
+         *   br.ifzc %103
+         *   %a = add %b, 1
+         *   nop
+         *   nop
+         *
+         * NOTE: Since the delay slots are executed regardless whether the branch is taken, this does not change the
+         * semantics of the program, but saves a cycle for every filled delay slot.
+         * This needs to run after the register allocation, since any instruction inserted by the register allocator
+         * between the branch and the delay slots would modify the program behavior.
+         */
+        bool fillBranchDelaySlots(const Module& module, Method& method, const Configuration& config);
+
         /*
          * Adds the start- and stop-segment to the kernel code
          *
@@ -54,6 +105,71 @@ namespace vc4c
          */
         bool removeConstantLoadInLoops(const Module& module, Method& method, const Configuration& config);
 
+        /*
+         * Loop-Invariant Code Motion (LICM)
+         *
+         * Moves all calculations without side-effects which produce the same value in every loop iteration (e.g.
+         * address calculations, calculations on parameters or values calculated in front of the loop) out of the loop
+         * into its preheader. If the loop has no block in front of it which only continues into the loop, a new
+         * preheader block is inserted.
+         *
+         * Since every value moved out of the loop stays live for the whole loop, values are only moved as long as the
+         * estimated number of locals live throughout the loop stays below the configured threshold.
+         *
+         * Example:
+         *   label: %loop
+         *   %a = add %param, 16
+         *   %b = shl %a, 2
+         *   %c = add %i, %b
+         *   [...]
+         *   br.ifzc %loop
+         *
+         * becomes:
+         *   label: %loop_preheader
+         *   %a = add %param, 16
+         *   %b = shl %a, 2
+         *   label: %loop
+         *   %c = add %i, %b
+         *   [...]
+         *   br.ifzc %loop
+         */
+        bool moveLoopInvariantCode(const Module& module, Method& method, const Configuration& config);
+
+        /*
+         * Induction variable strength reduction
+         *
+         * Replaces values calculated inside of a loop as linear function of the loop's induction variable (e.g. the
+         * addresses of the elements accessed via the loop index) with separate induction variables, which are
+         * initialized in front of the loop and incremented by a constant whenever the induction variable is updated.
+         * This removes the multiplications (or shifts) of the induction variable from the loop body.
+         *
+         * Example:
+         *   %i = 0 (phi)
+         *   label: %loop
+         *   %a = shl %i, 2
+         *   %b = add %base, %a
+         *   [...] (read %b)
+         *   %i.next = add %i, 1
+         *   %i = %i.next (phi)
+         *   br.ifzc %loop
+         *
+         * becomes:
+         *   %i = 0 (phi)
+         *   %a' = shl %i, 2
+         *   %p = add %base, %a' (phi)
+         *   label: %loop
+         *   %b = %p
+         *   [...] (read %b)
+         *   %i.next = add %i, 1
+         *   %i = %i.next (phi)
+         *   %p = add %p, 4 (phi)
+         *   br.ifzc %loop
+         *
+         * NOTE: Since this optimization runs after the intrinsics are lowered, only multiplications lowered to shifts,
+         * mul24 or sums/differences of shifts are recognized, but not the generic 32-bit multiplication.
+         */
+        bool reduceInductionVariableStrength(const Module& module, Method& method, const Configuration& config);
+
         /*
          * Concatenates "adjacent" basic blocks if the preceding block has only one successor and the succeeding block
          * has only one predecessor.
@@ -97,6 +213,9 @@ namespace vc4c
          *   [...]
          *   br %5
          *   label: %5
+         *
+         * If a block profile is available (see Configuration#blockProfile), blocks never executed are moved behind the
+         * executed blocks, so the executed blocks can be placed next to each other.
          */
         bool reorderBasicBlocks(const Module& module, Method& method, const Configuration& config);
 
@@ -136,6 +255,9 @@ namespace vc4c
          *   br %4
          *   [...]
          *   label: %4
+         *
+         * If a block profile is available, the conversion is only applied if the (conditionally executed) instructions
+         * of all cases take less cycles than the branches to and the execution of the actually taken cases.
          */
         bool simplifyConditionalBlocks(const Module& module, Method& method, const Configuration& config);
 
@@ -189,6 +311,20 @@ namespace vc4c
          */
         bool addWorkGroupLoop(const Module& module, Method& method, const Configuration& config);
 
+        /*
+         * Reads the UNIFORMs which have the same value for all work-groups (the work-item info and the kernel
+         * parameters) only once in front of the work-group loop and keeps their values in registers, instead of
+         * re-reading them at the start of every repetition.
+         *
+         * The UNIFORM pointer is then reset to the first UNIFORM still read inside of the loop. If no UNIFORMs are read
+         * inside of the loop anymore, the UNIFORM pointer is not reset at all and the UNIFORM for its value is removed
+         * from the kernel's UNIFORMs.
+         *
+         * NOTE: This optimization step increases register pressure, since the values are live for the whole kernel
+         * execution, and is therefore limited by the maximum number of loop-invariant locals.
+         */
+        bool cacheWorkGroupUniforms(const Module& module, Method& method, const Configuration& config);
+
     } /* namespace optimizations */
 } /* namespace vc4c */
 
@@ -9,6 +9,7 @@
 #include "../InstructionWalker.h"
 #include "../Profiler.h"
 #include "../analysis/AvailableExpressionAnalysis.h"
+#include "../analysis/DominatorTree.h"
 #include "../normalization/LiteralValues.h"
 #include "../periphery/SFU.h"
 #include "log.h"
@@ -1022,6 +1023,134 @@ bool optimizations::eliminateCommonSubexpressions(const Module& module, Method&
     return replacedSomething;
 }
 
+/*
+ * Returns whether the given operand has the same value at every point dominated by the current position.
+ *
+ * This is the case for constants, registers with fixed values, locals never written to (e.g. parameters) and locals
+ * with a single writer which dominates the current position.
+ */
+static bool isValueNumberingOperand(const Value& val, const FastSet<const Local*>& availableLocals)
+{
+    if(auto loc = val.checkLocal())
+        return availableLocals.find(loc) != availableLocals.end() || loc->getUsers(LocalUse::Type::WRITER).empty();
+    if(auto reg = val.checkRegister())
+        return *reg == REG_ELEMENT_NUMBER || *reg == REG_QPU_NUMBER;
+    return true;
+}
+
+bool optimizations::eliminateCommonSubexpressionsGlobally(
+    const Module& module, Method& method, const Configuration& config)
+{
+    analysis::DominatorTree dominators(method.getCFG());
+
+    // the scoped value numbering state, the entries added while processing a block are removed again after its sub-tree
+    // in the dominator tree has been processed
+    FastMap<Expression, Value> leaders;
+    FastSet<const Local*> availableLocals;
+    FastAccessList<Expression> addedExpressions;
+    FastAccessList<const Local*> addedLocals;
+    // the locals which were replaced with a move of the (equal) leader value. Since the leaders dominate the replaced
+    // locals, this does not need to be scoped, as long as the replaced local itself is available.
+    FastMap<const Local*, Value> replacedLocals;
+    bool replacedSomething = false;
+
+    auto processBlock = [&](BasicBlock& block) {
+        for(auto it = block.walk(); !it.isEndOfBlock(); it.nextInBlock())
+        {
+            if(!it.has())
+                continue;
+            auto out = it->checkOutputLocal();
+            bool isSingleWriter = out && out->getSingleWriter() == it.get();
+            if(auto expr = Expression::createExpression(*it.get()))
+            {
+                // read the leaders instead of locals known to be equal to them to find more equal expressions
+                bool rewroteArguments = false;
+                auto arguments = it->getArguments();
+                for(const auto& arg : arguments)
+                {
+                    auto loc = arg.checkLocal();
+                    auto replacementIt = loc ? replacedLocals.find(loc) : replacedLocals.end();
+                    if(replacementIt != replacedLocals.end() && availableLocals.find(loc) != availableLocals.end())
+                        rewroteArguments =
+                            it->replaceValue(arg, replacementIt->second, LocalUse::Type::READER) || rewroteArguments;
+                }
+                if(rewroteArguments)
+                {
+                    replacedSomething = true;
+                    expr = Expression::createExpression(*it.get());
+                }
+
+                // no use replacing loading of constants or simple moves with copies of other locals
+                if(expr && isSingleWriter && !expr->getConstantExpression() && !expr->isMoveExpression() &&
+                    std::all_of(it->getArguments().begin(), it->getArguments().end(),
+                        [&](const Value& arg) -> bool { return isValueNumberingOperand(arg, availableLocals); }))
+                {
+                    auto leaderIt = leaders.find(*expr);
+                    if(leaderIt == leaders.end())
+                    {
+                        leaders.emplace(*expr, it->getOutput().value());
+                        addedExpressions.emplace_back(*expr);
+                    }
+                    else if(leaderIt->second.type == it->getOutput()->type)
+                    {
+                        CPPLOG_LAZY(logging::Level::DEBUG,
+                            log << "Found global common subexpression: " << it->to_string() << " is the same as "
+                                << leaderIt->second.to_string() << logging::endl);
+                        auto leader = leaderIt->second;
+                        it.reset((new intermediate::MoveOperation(it->getOutput().value(), leader))
+                                     ->addDecorations(it->decoration));
+                        replacedLocals.emplace(out, leader);
+                        replacedSomething = true;
+                    }
+                }
+            }
+            if(isSingleWriter)
+            {
+                availableLocals.emplace(out);
+                addedLocals.emplace_back(out);
+            }
+        }
+    };
+
+    // walk the dominator tree in pre-order, so every block is processed after all of its dominators
+    struct Scope
+    {
+        const CFGNode* node;
+        std::size_t nextChild;
+        std::size_t numExpressions;
+        std::size_t numLocals;
+    };
+    FastAccessList<Scope> scopes;
+    auto enterScope = [&](const CFGNode& node) {
+        scopes.emplace_back(Scope{&node, 0, addedExpressions.size(), addedLocals.size()});
+        processBlock(*node.key);
+    };
+    enterScope(dominators.getRoot());
+    while(!scopes.empty())
+    {
+        auto& scope = scopes.back();
+        const auto& children = dominators.getImmediatelyDominated(*scope.node);
+        if(scope.nextChild < children.size())
+        {
+            // NOTE: this invalidates the scope reference!
+            enterScope(*children[scope.nextChild++]);
+            continue;
+        }
+        while(addedExpressions.size() > scope.numExpressions)
+        {
+            leaders.erase(addedExpressions.back());
+            addedExpressions.pop_back();
+        }
+        while(addedLocals.size() > scope.numLocals)
+        {
+            availableLocals.erase(addedLocals.back());
+            addedLocals.pop_back();
+        }
+        scopes.pop_back();
+    }
+    return replacedSomething;
+}
+
 InstructionWalker optimizations::rewriteConstantSFUCall(
     const Module& module, Method& method, InstructionWalker it, const Configuration& config)
 {
@@ -201,6 +201,33 @@ namespace vc4c
          */
         bool eliminateCommonSubexpressions(const Module& module, Method& method, const Configuration& config);
 
+        /*
+         * Global Value Numbering (GVN)
+         *
+         * Walks the dominator tree of the method and replaces calculations of expressions already calculated in a
+         * dominating position (the same or a dominating basic block) with a copy of the previous result. In contrast to
+         * the CSE above, this works across basic blocks (e.g. for address calculations repeated in loop bodies) and is
+         * not limited to a maximum distance.
+         *
+         * To guarantee that both calculations produce the same value, only expressions writing locals with a single
+         * writer and reading constants or locals with a single (dominating) writer are considered.
+         *
+         * Example:
+         *   label: %a
+         *   %b = add %c, %d
+         *   [...]
+         *   label: %e (dominated by %a)
+         *   %f = add %c, %d
+         *
+         * becomes:
+         *   label: %a
+         *   %b = add %c, %d
+         *   [...]
+         *   label: %e
+         *   %f = %b
+         */
+        bool eliminateCommonSubexpressionsGlobally(const Module& module, Method& method, const Configuration& config);
+
         /*
          * Replaces calls to the SFU registers with constant input to a move of the result
          *
@@ -8,10 +8,16 @@
 
 #include "../InstructionWalker.h"
 #include "../Profiler.h"
+#include "../analysis/BlockFrequencies.h"
+#include "../analysis/ControlFlowGraph.h"
 #include "../analysis/DependencyGraph.h"
+#include "../analysis/LivenessAnalysis.h"
 #include "../intermediate/IntermediateInstruction.h"
+#include "config.h"
 #include "log.h"
 
+#include <limits>
+
 using namespace vc4c;
 using namespace vc4c::optimizations;
 
@@ -210,12 +216,144 @@ static int checkDependenciesMet(DependencyNode& entry, BasicBlock& block, OpenSe
     return schedulingPriority;
 }
 
+/*
+ * Tracks the locals live at the current end of the basic block while it is re-filled with the scheduled instructions.
+ *
+ * Scheduling an instruction ends the live-range of every local read for the last time within the block (unless the
+ * local is still live after the block) and begins the live-range of the local written (unless it is already live).
+ */
+class RegisterPressure
+{
+public:
+    RegisterPressure(FastSet<const Local*>&& liveInLocals, FastSet<const Local*>&& liveOutLocals) :
+        liveLocals(std::move(liveInLocals)), liveOutLocals(std::move(liveOutLocals))
+    {
+    }
+
+    /*
+     * Registers the reads of the given not yet scheduled instruction
+     */
+    void addOpenInstruction(const intermediate::IntermediateInstruction& inst)
+    {
+        forUsedLocals(inst, [&](const Local* loc, bool isRead) {
+            if(isRead)
+                ++remainingReaders[loc];
+        });
+    }
+
+    /*
+     * Returns the number of locals which start being live minus the number of locals which stop being live when
+     * scheduling the given instruction next
+     */
+    int calculateChange(const intermediate::IntermediateInstruction& inst) const
+    {
+        int change = 0;
+        forLivenessChanges(inst, [&](const Local* loc, bool becomesLive) { change += becomesLive ? 1 : -1; });
+        return change;
+    }
+
+    /*
+     * Updates the live locals for the given instruction being scheduled next
+     */
+    void update(const intermediate::IntermediateInstruction& inst)
+    {
+        FastAccessList<std::pair<const Local*, bool>> changes;
+        forLivenessChanges(inst, [&](const Local* loc, bool becomesLive) { changes.emplace_back(loc, becomesLive); });
+        for(const auto& change : changes)
+        {
+            if(change.second)
+                liveLocals.emplace(change.first);
+            else
+                liveLocals.erase(change.first);
+        }
+        forUsedLocals(inst, [&](const Local* loc, bool isRead) {
+            auto it = remainingReaders.find(loc);
+            if(isRead && it != remainingReaders.end() && it->second > 0)
+                --it->second;
+        });
+    }
+
+    std::size_t getNumLiveLocals() const
+    {
+        return liveLocals.size();
+    }
+
+private:
+    FastSet<const Local*> liveLocals;
+    FastSet<const Local*> liveOutLocals;
+    // the number of not yet scheduled instructions reading the local
+    FastMap<const Local*, unsigned> remainingReaders;
+
+    template <typename Func>
+    static void forUsedLocals(const intermediate::IntermediateInstruction& inst, Func&& consumer)
+    {
+        FastAccessList<const Local*> readLocals;
+        inst.forUsedLocals([&](const Local* loc, LocalUse::Type type, const intermediate::IntermediateInstruction&) {
+            if(loc->type.isLabelType())
+                return;
+            // a local can be read by several operands, but only counts as a single reader
+            if(has_flag(type, LocalUse::Type::READER) &&
+                std::find(readLocals.begin(), readLocals.end(), loc) == readLocals.end())
+            {
+                readLocals.emplace_back(loc);
+                consumer(loc, true);
+            }
+            if(has_flag(type, LocalUse::Type::WRITER))
+                consumer(loc, false);
+        });
+    }
+
+    unsigned getRemainingReaders(const Local* loc) const
+    {
+        auto it = remainingReaders.find(loc);
+        return it == remainingReaders.end() ? 0 : it->second;
+    }
+
+    template <typename Func>
+    void forLivenessChanges(const intermediate::IntermediateInstruction& inst, Func&& consumer) const
+    {
+        const Local* writtenLocal = nullptr;
+        bool readsWrittenLocal = false;
+        bool writtenLocalDies = false;
+        FastAccessList<const Local*> readLocals;
+        forUsedLocals(inst, [&](const Local* loc, bool isRead) {
+            if(isRead)
+                readLocals.emplace_back(loc);
+            else
+                writtenLocal = loc;
+        });
+        for(auto loc : readLocals)
+        {
+            if(loc == writtenLocal)
+                readsWrittenLocal = true;
+            if(liveLocals.find(loc) != liveLocals.end() && getRemainingReaders(loc) == 1 &&
+                liveOutLocals.find(loc) == liveOutLocals.end())
+            {
+                // this is the last read of the local
+                consumer(loc, false);
+                writtenLocalDies = writtenLocalDies || loc == writtenLocal;
+            }
+        }
+        if(writtenLocal)
+        {
+            auto readersLeft = getRemainingReaders(writtenLocal) - (readsWrittenLocal ? 1 : 0);
+            bool isLive = liveLocals.find(writtenLocal) != liveLocals.end() && !writtenLocalDies;
+            // writing a local which is never read afterwards does not start its live-range
+            if(!isLive && (readersLeft > 0 || liveOutLocals.find(writtenLocal) != liveOutLocals.end()))
+                consumer(writtenLocal, true);
+        }
+    }
+};
+
 static OpenSet::const_iterator selectInstruction(OpenSet& openNodes, DependencyGraph& graph, BasicBlock& block,
-    const DelaysMap& successiveMandatoryDelays, const DelaysMap& successiveDelays)
+    const DelaysMap& successiveMandatoryDelays, const DelaysMap& successiveDelays, const RegisterPressure& pressure,
+    bool reducePressure)
 {
     // iterate open-set until entry with no more dependencies
     auto it = openNodes.begin();
     std::pair<OpenSet::const_iterator, int> selected = std::make_pair(openNodes.end(), DEFAULT_PRIORITY);
+    // when reducing the register pressure, the change in live locals takes precedence over the latency
+    int selectedPressureChange = reducePressure ? std::numeric_limits<int>::max() : 0;
     auto lastInstruction = block.walkEnd().previousInBlock();
     PROFILE_START(SelectInstruction);
     while(it != openNodes.end())
@@ -230,6 +368,25 @@ static OpenSet::const_iterator selectInstruction(OpenSet& openNodes, DependencyG
         // TODO need to combine more instructions!
         // TODO success rate (i.e. emulation tests) is good, need to optimize performance
         // TODO is putting too much pressure on mutex lock (15% more than before)
+        int pressureChange = 0;
+        if(reducePressure && priority < DEFAULT_PRIORITY)
+        {
+            pressureChange = pressure.calculateChange(**it);
+            if(pressureChange < selectedPressureChange)
+            {
+                std::get<0>(selected) = it;
+                std::get<1>(selected) = priority;
+                selectedPressureChange = pressureChange;
+                ++it;
+                continue;
+            }
+        }
+        if(pressureChange != selectedPressureChange)
+        {
+            // either increases the register pressure more than the selected instruction or cannot be scheduled yet
+            ++it;
+            continue;
+        }
         if(priority < std::get<1>(selected) ||
             // keep instructions writing the same local together to be combined more easily
             // TODO make better/check result
@@ -256,14 +413,15 @@ static OpenSet::const_iterator selectInstruction(OpenSet& openNodes, DependencyG
     {
         CPPLOG_LAZY(logging::Level::DEBUG,
             log << "Selected '" << (*std::get<0>(selected))->to_string()
-                << "' as next instruction with remaining latency of " << std::get<1>(selected) << logging::endl);
+                << "' as next instruction with remaining latency of " << std::get<1>(selected)
+                << (reducePressure ? " and change in live locals of " + std::to_string(selectedPressureChange) : "")
+                << logging::endl);
         return std::get<0>(selected);
     }
 
     return openNodes.end();
 }
 
-// FIXME largely extends usage-ranges and increases pressure on registers
 // FIXME increases mutex-ranges!!
 // TODO make sure no more than 4(8?) TMU requests/responds are queued at any time (per TMU?)
 // - Specification documents 8 entries of single row (for general memory query), but does not specify whether one queue
@@ -275,7 +433,7 @@ static OpenSet::const_iterator selectInstruction(OpenSet& openNodes, DependencyG
  * basic block
  */
 static void selectInstructions(DependencyGraph& graph, BasicBlock& block, const DelaysMap& successiveMandatoryDelays,
-    const DelaysMap& successiveDelays)
+    const DelaysMap& successiveDelays, RegisterPressure& pressure, std::size_t maxLiveLocals)
 {
     // 1. "empty" basic block without deleting the instructions, skipping the label
     auto it = block.walk().nextInBlock();
@@ -285,15 +443,32 @@ static void selectInstructions(DependencyGraph& graph, BasicBlock& block, const
         if(it.has() &&
             !(it.get<intermediate::Nop>() && !it->hasSideEffects() &&
                 it.get<const intermediate::Nop>()->type != intermediate::DelayType::THREAD_END))
+        {
             // remove all non side-effect NOPs
+            pressure.addOpenInstruction(*it.get());
             openNodes.emplace(it.release());
+        }
         it.erase();
     }
 
     // 2. fill again with reordered instructions
+    bool reducePressure = false;
     while(!openNodes.empty())
     {
-        auto inst = selectInstruction(openNodes, graph, block, successiveMandatoryDelays, successiveDelays);
+        /*
+         * Optimizing for latency tends to schedule independent calculations early and thus to extend the live-ranges
+         * of their results. Once too many locals are live, prefer instructions ending live-ranges until the pressure
+         * drops again, to not force the register allocator to spill or to fail.
+         */
+        if(reducePressure != (pressure.getNumLiveLocals() >= maxLiveLocals))
+        {
+            reducePressure = !reducePressure;
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << (reducePressure ? "Reducing" : "Stopped reducing") << " register pressure with "
+                    << pressure.getNumLiveLocals() << " live locals" << logging::endl);
+        }
+        auto inst = selectInstruction(
+            openNodes, graph, block, successiveMandatoryDelays, successiveDelays, pressure, reducePressure);
         if(inst == openNodes.end())
         {
             // no instruction could be scheduled not violating the fixed latency, insert NOPs
@@ -303,6 +478,7 @@ static void selectInstructions(DependencyGraph& graph, BasicBlock& block, const
         }
         else
         {
+            pressure.update(**inst);
             block.walkEnd().emplace(*inst);
             openNodes.erase(inst);
         }
@@ -311,8 +487,24 @@ static void selectInstructions(DependencyGraph& graph, BasicBlock& block, const
 
 bool optimizations::reorderInstructions(const Module& module, Method& kernel, const Configuration& config)
 {
+    // with 2 hardware threads per QPU, every thread has only half of the physical registers available
+    const std::size_t maxLiveLocals = config.useMultiThreading ?
+        config.additionalOptions.maxSchedulerRegisterPressure / 2 :
+        config.additionalOptions.maxSchedulerRegisterPressure;
+    analysis::GlobalLivenessAnalysis livenessAnalysis;
+    livenessAnalysis(kernel);
+    auto& cfg = kernel.getCFG();
     for(BasicBlock& bb : kernel)
     {
+        FastSet<const Local*> liveOutLocals;
+        cfg.assertNode(&bb).forAllOutgoingEdges([&](const CFGNode& successor, const CFGEdge&) -> bool {
+            const auto& liveInSuccessor = livenessAnalysis.getLocalAnalysis(*successor.key).getStartResult();
+            liveOutLocals.insert(liveInSuccessor.begin(), liveInSuccessor.end());
+            return true;
+        });
+        RegisterPressure pressure(
+            FastSet<const Local*>{livenessAnalysis.getLocalAnalysis(bb).getStartResult()}, std::move(liveOutLocals));
+
         auto dependencies = DependencyGraph::createGraph(bb);
         // calculate required and recommended successive delays for all instructions
         DelaysMap successiveMandatoryDelays;
@@ -325,7 +517,317 @@ bool optimizations::reorderInstructions(const Module& module, Method& kernel, co
             node.second.calculateSucceedingCriticalPathLength(false, &successiveDelays);
         }
         PROFILE_END(CalculateCriticalPath);
-        selectInstructions(*dependencies, bb, successiveMandatoryDelays, successiveDelays);
+        selectInstructions(*dependencies, bb, successiveMandatoryDelays, successiveDelays, pressure, maxLiveLocals);
     }
     return false;
 }
+
+/*
+ * Returns whether the given instruction can be executed speculatively, i.e. whether it only calculates a value from
+ * locals and constants without accessing any register, flags or other hardware periphery.
+ */
+static bool isSpeculatable(const intermediate::IntermediateInstruction* inst)
+{
+    if(inst == nullptr || !inst->mapsToASMInstruction() || inst->checkOutputLocal() == nullptr)
+        return false;
+    if(!dynamic_cast<const intermediate::Operation*>(inst) && !dynamic_cast<const intermediate::LoadImmediate*>(inst) &&
+        (!dynamic_cast<const intermediate::MoveOperation*>(inst) ||
+            dynamic_cast<const intermediate::VectorRotation*>(inst)))
+        return false;
+    if(inst->hasSideEffects() || inst->hasConditionalExecution() || inst->signal != SIGNAL_NONE)
+        return false;
+    return std::none_of(inst->getArguments().begin(), inst->getArguments().end(),
+        [](const Value& arg) -> bool { return arg.checkRegister() != nullptr; });
+}
+
+/*
+ * Returns whether the second instruction depends on the first one or vice versa via any local they access
+ */
+static bool hasLocalDependency(
+    const intermediate::IntermediateInstruction& first, const intermediate::IntermediateInstruction& second)
+{
+    bool hasDependency = false;
+    first.forUsedLocals([&](const Local* loc, LocalUse::Type type, const intermediate::IntermediateInstruction&) {
+        // read-after-write, write-after-read and write-after-write
+        if(has_flag(type, LocalUse::Type::WRITER) && (second.readsLocal(loc) || second.writesLocal(loc)))
+            hasDependency = true;
+        if(has_flag(type, LocalUse::Type::READER) && second.writesLocal(loc))
+            hasDependency = true;
+    });
+    return hasDependency;
+}
+
+/*
+ * Returns whether the instruction at the given position reads the given local.
+ *
+ * Since the local registers were already split up, this is used to not create new reads of a local directly after
+ * the write.
+ */
+static bool isReadAt(const InstructionWalker& it, const Local* local)
+{
+    return !it.isStartOfBlock() && !it.isEndOfBlock() && it.has() && it->readsLocal(local);
+}
+
+/*
+ * Returns the number of NOPs within the given block which only wait for some delay and can therefore be replaced by
+ * other instructions
+ */
+static std::size_t countStallNops(const BasicBlock& block)
+{
+    return static_cast<std::size_t>(std::count_if(block.begin(), block.end(), [](const intermediate::IL& inst) {
+        auto nop = dynamic_cast<const intermediate::Nop*>(inst.get());
+        return nop && !nop->hasSideEffects() && nop->type != intermediate::DelayType::BRANCH_DELAY &&
+            nop->type != intermediate::DelayType::THREAD_END;
+    }));
+}
+
+/*
+ * Returns the position of the first branch of the branches ending the given block (or the end of the block)
+ */
+static InstructionWalker findBranchesAtEnd(BasicBlock& block)
+{
+    auto it = block.walkEnd();
+    while(!it.isStartOfBlock())
+    {
+        auto prev = it.copy().previousInBlock();
+        if(prev.isStartOfBlock() || (prev.has() && !prev.get<const intermediate::Branch>()))
+            break;
+        it = prev;
+    }
+    return it;
+}
+
+/*
+ * Splits the control flow into superblocks, chains of basic blocks with a single entry (the first block) and possibly
+ * multiple exits (the side exits of every block of the chain).
+ *
+ * A block is appended to the superblock of the block directly in front of it, if that block is its only predecessor.
+ * Since the blocks were already ordered to make the most likely successor the fall-through block, this chains the
+ * blocks along the most likely path through the kernel. If a block profile is available, chains are also ended at
+ * branches which were rarely taken.
+ */
+static FastAccessList<FastAccessList<BasicBlock*>> findSuperblocks(
+    Method& method, const analysis::BlockFrequencies& frequencies)
+{
+    // with a block profile, only follow branches taken at least this often
+    static constexpr double MIN_BRANCH_PROBABILITY = 0.5;
+    auto& cfg = method.getCFG();
+    FastAccessList<FastAccessList<BasicBlock*>> superblocks;
+    FastAccessList<BasicBlock*> currentBlocks;
+    for(auto it = method.begin(); it != method.end(); ++it)
+    {
+        if(!currentBlocks.empty())
+        {
+            auto& node = cfg.assertNode(&*it);
+            auto predecessor = node.getSinglePredecessor();
+            auto edge = predecessor ? predecessor->getEdge(&node) : nullptr;
+            auto probability = frequencies.getBranchProbability(*currentBlocks.back(), *it);
+            if(predecessor && predecessor->key == currentBlocks.back() && edge && !edge->data.isWorkGroupLoop &&
+                (!probability || *probability >= MIN_BRANCH_PROBABILITY))
+            {
+                currentBlocks.emplace_back(&*it);
+                continue;
+            }
+            if(currentBlocks.size() > 1)
+                superblocks.emplace_back(std::move(currentBlocks));
+            currentBlocks.clear();
+        }
+        currentBlocks.emplace_back(&*it);
+    }
+    if(currentBlocks.size() > 1)
+        superblocks.emplace_back(std::move(currentBlocks));
+    return superblocks;
+}
+
+using LiveLocalsMap = FastMap<const BasicBlock*, FastSet<const Local*>>;
+
+/*
+ * Moves instructions from the beginning of the next block to the end of the previous block of a superblock.
+ *
+ * Since the instructions are then also executed when leaving the superblock via a side exit of the previous block,
+ * only instructions writing locals not live at any of these side exits are moved.
+ */
+static std::size_t hoistInstructions(BasicBlock& previous, BasicBlock& next, const FastAccessList<BasicBlock*>& exits,
+    LiveLocalsMap& liveInLocals, std::size_t maxInstructions)
+{
+    // instructions within this distance of the start of the block are considered
+    static constexpr std::size_t MAX_SEARCH_DISTANCE = 16;
+
+    auto insertIt = findBranchesAtEnd(previous);
+    std::size_t numMoved = 0;
+    FastAccessList<const intermediate::IntermediateInstruction*> skippedInstructions;
+    auto it = next.walk().nextInBlock();
+    while(!it.isEndOfBlock() && numMoved < maxInstructions && skippedInstructions.size() < MAX_SEARCH_DISTANCE)
+    {
+        if(!it.has())
+        {
+            it.nextInBlock();
+            continue;
+        }
+        if(it.get<const intermediate::Branch>())
+            break;
+        auto output = it->checkOutputLocal();
+        bool canBeMoved = isSpeculatable(it.get()) &&
+            std::none_of(skippedInstructions.begin(), skippedInstructions.end(),
+                [&](const intermediate::IntermediateInstruction* skipped) -> bool {
+                    return hasLocalDependency(*skipped, *it.get());
+                }) &&
+            std::none_of(exits.begin(), exits.end(),
+                [&](const BasicBlock* exit) -> bool { return liveInLocals.at(exit).count(output) != 0; });
+        for(auto branchIt = insertIt.copy(); canBeMoved && !branchIt.isEndOfBlock(); branchIt.nextInBlock())
+        {
+            if(branchIt.has() && branchIt->readsLocal(output))
+                canBeMoved = false;
+        }
+        auto lastIt = insertIt.copy().previousInBlock();
+        if(canBeMoved && !lastIt.isStartOfBlock() && lastIt.has() && lastIt->checkOutputLocal() &&
+            it->readsLocal(lastIt->checkOutputLocal()))
+            canBeMoved = false;
+        if(!canBeMoved)
+        {
+            skippedInstructions.emplace_back(it.get());
+            it.nextInBlock();
+            continue;
+        }
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Moving instruction into previous block of superblock: " << it->to_string() << logging::endl);
+        insertIt.emplace(it.release());
+        insertIt.nextInBlock();
+        it.erase();
+        liveInLocals[&next].emplace(output);
+        ++numMoved;
+    }
+    return numMoved;
+}
+
+/*
+ * Moves instructions from the end of the previous block to the beginning of the next block of a superblock.
+ *
+ * If the value calculated is required when leaving the superblock via a side exit of the previous block, a copy of
+ * the instruction is inserted as compensation code at the start of the side exit. Since we cannot insert code on the
+ * edge itself, this is only done for side exits which can only be reached from the previous block.
+ */
+static std::size_t sinkInstructions(Method& method, BasicBlock& previous, BasicBlock& next,
+    const FastAccessList<BasicBlock*>& exits, LiveLocalsMap& liveInLocals, std::size_t maxInstructions)
+{
+    // instructions within this distance of the end of the block are considered
+    static constexpr std::size_t MAX_SEARCH_DISTANCE = 16;
+
+    auto& cfg = method.getCFG();
+    std::size_t numMoved = 0;
+    // the branches as well as the instructions not moved
+    FastAccessList<const intermediate::IntermediateInstruction*> skippedInstructions;
+    auto it = findBranchesAtEnd(previous);
+    for(auto branchIt = it.copy(); !branchIt.isEndOfBlock(); branchIt.nextInBlock())
+    {
+        if(branchIt.has())
+            skippedInstructions.emplace_back(branchIt.get());
+    }
+    while(!it.isStartOfBlock() && numMoved < maxInstructions && skippedInstructions.size() < MAX_SEARCH_DISTANCE)
+    {
+        it.previousInBlock();
+        if(it.isStartOfBlock())
+            break;
+        if(!it.has())
+            continue;
+        auto output = it->checkOutputLocal();
+        bool canBeMoved = isSpeculatable(it.get()) &&
+            std::none_of(skippedInstructions.begin(), skippedInstructions.end(),
+                [&](const intermediate::IntermediateInstruction* skipped) -> bool {
+                    return hasLocalDependency(*it.get(), *skipped);
+                }) &&
+            !isReadAt(next.walk().nextInBlock(), output) &&
+            std::all_of(exits.begin(), exits.end(), [&](BasicBlock* exit) -> bool {
+                if(liveInLocals.at(exit).count(output) == 0)
+                    return true;
+                // compensation code can only be inserted, if the side exit has no other predecessor
+                auto& node = cfg.assertNode(exit);
+                auto predecessor = node.getSinglePredecessor();
+                return predecessor != nullptr && !predecessor->getEdge(&node)->data.isWorkGroupLoop &&
+                    exit != cfg.getStartOfControlFlow().key && !isReadAt(exit->walk().nextInBlock(), output);
+            });
+        if(!canBeMoved)
+        {
+            skippedInstructions.emplace_back(it.get());
+            continue;
+        }
+        for(auto exit : exits)
+        {
+            auto& exitLiveLocals = liveInLocals.at(exit);
+            if(exitLiveLocals.count(output) == 0)
+                continue;
+            CPPLOG_LAZY(logging::Level::DEBUG,
+                log << "Inserting compensation code for instruction moved out of superblock side exit: "
+                    << it->to_string() << logging::endl);
+            intermediate::InlineMapping mapping;
+            it->forUsedLocals([&](const Local* local, LocalUse::Type, const intermediate::IntermediateInstruction&) {
+                for(auto loc = local; loc != nullptr; loc = loc->reference.first)
+                    mapping.emplace(loc, loc);
+            });
+            exit->walk().nextInBlock().emplace(it->copyFor(method, "", mapping));
+            it->forUsedLocals([&](const Local* loc, LocalUse::Type type, const intermediate::IntermediateInstruction&) {
+                if(has_flag(type, LocalUse::Type::READER))
+                    exitLiveLocals.emplace(loc);
+            });
+        }
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Moving instruction into next block of superblock: " << it->to_string() << logging::endl);
+        auto& nextLiveLocals = liveInLocals[&next];
+        it->forUsedLocals([&](const Local* loc, LocalUse::Type type, const intermediate::IntermediateInstruction&) {
+            if(has_flag(type, LocalUse::Type::READER))
+                nextLiveLocals.emplace(loc);
+        });
+        next.walk().nextInBlock().emplace(it.release());
+        it.erase();
+        ++numMoved;
+    }
+    return numMoved;
+}
+
+bool optimizations::scheduleSuperblocks(const Module& module, Method& kernel, const Configuration& config)
+{
+    auto superblocks = findSuperblocks(kernel, analysis::BlockFrequencies{kernel, config});
+    if(superblocks.empty())
+        return false;
+
+    analysis::GlobalLivenessAnalysis livenessAnalysis;
+    livenessAnalysis(kernel);
+    LiveLocalsMap liveInLocals;
+    for(const auto& block : kernel)
+        liveInLocals.emplace(&block, livenessAnalysis.getLocalAnalysis(block).getStartResult());
+
+    auto& cfg = kernel.getCFG();
+    std::size_t numMoved = 0;
+    for(const auto& superblock : superblocks)
+    {
+        CPPLOG_LAZY(logging::Level::DEBUG,
+            log << "Scheduling superblock of " << superblock.size() << " blocks starting at: "
+                << superblock.front()->to_string() << logging::endl);
+        for(std::size_t i = 1; i < superblock.size(); ++i)
+        {
+            auto& previous = *superblock[i - 1];
+            auto& next = *superblock[i];
+            FastAccessList<BasicBlock*> exits;
+            cfg.assertNode(&previous).forAllOutgoingEdges([&](CFGNode& successor, CFGEdge&) -> bool {
+                if(successor.key != &next)
+                    exits.emplace_back(successor.key);
+                return true;
+            });
+
+            // Only fill delays which are executed anyway, to not add any cycles to neither of the paths. Any
+            // instruction moved to a block with stall NOPs can be rescheduled into these NOPs by the following
+            // (block-local) scheduling steps.
+            if(auto numPreviousNops = countStallNops(previous))
+                numMoved += hoistInstructions(previous, next, exits, liveInLocals, numPreviousNops);
+            else if(auto numNextNops = countStallNops(next))
+                numMoved += sinkInstructions(kernel, previous, next, exits, liveInLocals, numNextNops);
+        }
+    }
+
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Moved " << numMoved << " instructions across block boundaries within " << superblocks.size()
+            << " superblocks" << logging::endl);
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 344, "Superblocks", superblocks.size());
+    PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 345, "Instructions moved across blocks", numMoved);
+    return numMoved > 0;
+}
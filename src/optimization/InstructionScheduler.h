@@ -17,6 +17,21 @@ namespace vc4c
     {
         bool reorderInstructions(const Module& module, Method& kernel, const Configuration& config);
 
+        /*
+         * Moves instructions across the boundaries of basic blocks within superblocks (chains of basic blocks where
+         * every block but the first can only be entered from the block in front of it) to fill the delays of the
+         * blocks, which otherwise would be filled with NOPs.
+         *
+         * Instructions are moved from the beginning of a block into its predecessor, if their results are not used by
+         * any other successor of the predecessor. Instructions are moved from the end of a block into its successor,
+         * if their results are not used by any other successor or the code calculating the result can be copied into
+         * the other successor (compensation code). Only simple calculations without side-effects are moved.
+         *
+         * NOTE: This optimization only moves the instructions into the neighboring blocks, the actual scheduling of
+         * the instructions to fill the delays is done by the following block-local optimizations.
+         */
+        bool scheduleSuperblocks(const Module& module, Method& kernel, const Configuration& config);
+
     } /* namespace optimizations */
 } /* namespace vc4c */
 
@@ -98,7 +98,8 @@ static bool runSingleSteps(const Module& module, Method& method, const Configura
 }
 
 static void addToPasses(const OptimizationPass& pass, std::vector<const OptimizationPass*>& initialPasses,
-    std::vector<const OptimizationPass*>& repeatingPasses, std::vector<const OptimizationPass*>& finalPasses)
+    std::vector<const OptimizationPass*>& repeatingPasses, std::vector<const OptimizationPass*>& finalPasses,
+    std::vector<const OptimizationPass*>& postAllocationPasses)
 {
     switch(pass.type)
     {
@@ -111,6 +112,9 @@ static void addToPasses(const OptimizationPass& pass, std::vector<const Optimiza
     case OptimizationType::FINAL:
         finalPasses.emplace_back(&pass);
         break;
+    case OptimizationType::POST_ALLOCATION:
+        postAllocationPasses.emplace_back(&pass);
+        break;
     default:
         throw CompilationError(CompilationStep::OPTIMIZER, "Unhandled optimization type for pass", pass.name);
     }
@@ -126,10 +130,10 @@ Optimizer::Optimizer(const Configuration& config) : config(config)
             continue;
         if(config.additionalEnabledOptimizations.find(pass.parameterName) !=
             config.additionalEnabledOptimizations.end())
-            addToPasses(pass, initialPasses, repeatingPasses, finalPasses);
+            addToPasses(pass, initialPasses, repeatingPasses, finalPasses, postAllocationPasses);
         // don't add a pass twice if it is manually enabled and in the list of enabled passed via the optimization level
         else if(enabledPasses.find(pass.parameterName) != enabledPasses.end())
-            addToPasses(pass, initialPasses, repeatingPasses, finalPasses);
+            addToPasses(pass, initialPasses, repeatingPasses, finalPasses, postAllocationPasses);
     }
 }
 
@@ -229,12 +233,26 @@ static void runOptimizationPasses(const Module& module, Method& method, const Co
 void Optimizer::optimize(Module& module) const
 {
     auto kernels = module.getKernels();
-    const auto f = [&](Method* kernelFunc) {
-        runOptimizationPasses(module, *kernelFunc, config, initialPasses, repeatingPasses, finalPasses);
-    };
+    const auto f = [&](Method* kernelFunc) { optimizeKernel(module, *kernelFunc); };
     ThreadPool{"Optimizer"}.scheduleAll<Method*>(kernels, f);
 }
 
+void Optimizer::optimizeKernel(Module& module, Method& kernel) const
+{
+    runOptimizationPasses(module, kernel, config, initialPasses, repeatingPasses, finalPasses);
+}
+
+void Optimizer::optimizeAllocatedKernel(const Module& module, Method& kernel) const
+{
+    // use indices behind the ones of the other passes for the profiling counters
+    std::size_t index = ALL_PASSES.size() * 100;
+    for(const OptimizationPass* pass : postAllocationPasses)
+    {
+        runPass(*pass, index, module, kernel, config);
+        index += 100;
+    }
+}
+
 const std::vector<OptimizationPass> Optimizer::ALL_PASSES = {
     /*
      * The first optimizations run modify the control-flow of the method.
@@ -254,6 +272,19 @@ const std::vector<OptimizationPass> Optimizer::ALL_PASSES = {
         "merges adjacent basic blocks if there are no other conflicting transitions", OptimizationType::INITIAL),
     OptimizationPass("VectorizeLoops", "vectorize-loops", vectorizeLoops, "vectorizes supported types of loops",
         OptimizationType::INITIAL),
+    OptimizationPass("UnrollLoops", "unroll-loops", unrollLoops,
+        "unrolls small loops with a constant number of iterations", OptimizationType::INITIAL),
+    OptimizationPass("PipelineTMULoads", "pipeline-tmu-loads", pipelineTMULoads,
+        "issues TMU reads before the results of previous reads are consumed", OptimizationType::INITIAL),
+    OptimizationPass("CombineDMAAccesses", "combine-dma", combineDMAAccesses,
+        "combines DMA accesses to memory with a constant stride, e.g. of unrolled loop iterations",
+        OptimizationType::INITIAL),
+    OptimizationPass("StrengthReduction", "reduce-strength", reduceInductionVariableStrength,
+        "replaces multiplications of induction variables in loops with separately incremented induction variables",
+        OptimizationType::INITIAL),
+    OptimizationPass("LoopInvariantCodeMotion", "move-loop-invariants", moveLoopInvariantCode,
+        "moves calculations producing the same value in every loop iteration in front of the loop",
+        OptimizationType::INITIAL),
     /*
      * The second block executes optimizations only within a single basic block.
      * These optimizations may be executed in a loop until there are not more changes to the instructions
@@ -270,6 +301,10 @@ const std::vector<OptimizationPass> Optimizer::ALL_PASSES = {
     OptimizationPass("CommonSubexpressionElimination", "eliminate-common-subexpressions", eliminateCommonSubexpressions,
         "eliminates repetitive calculations of common expressions by re-using previous results (WIP, slow)",
         OptimizationType::REPEAT),
+    OptimizationPass("GlobalValueNumbering", "global-value-numbering", eliminateCommonSubexpressionsGlobally,
+        "eliminates repetitive calculations of common expressions across basic blocks by re-using the results "
+        "calculated in dominating blocks",
+        OptimizationType::REPEAT),
     OptimizationPass("EliminateBitOperations", "eliminate-bit-operations", eliminateRedundantBitOp,
         "Rewrites redundant bit operations", OptimizationType::REPEAT),
     OptimizationPass("PropagateMoves", "copy-propagation", propagateMoves,
@@ -286,6 +321,9 @@ const std::vector<OptimizationPass> Optimizer::ALL_PASSES = {
     // XXX not enabled with any optimization level for now. TODO also move before repeated optimizations?
     OptimizationPass("CompressWorkGroupInfo", "compress-work-group-info", compressWorkGroupLocals,
         "compresses work-group info into single local", OptimizationType::FINAL),
+    OptimizationPass("CacheWorkGroupUniforms", "cache-uniforms", cacheWorkGroupUniforms,
+        "reads UNIFORMs which are the same for all work-groups only once instead of for every work-group",
+        OptimizationType::FINAL),
     OptimizationPass("SplitReadAfterWrites", "split-read-write", splitReadAfterWrites,
         "splits read-after-writes (except if the local is used only very locally), so the reordering and "
         "register-allocation have an easier job",
@@ -297,13 +335,22 @@ const std::vector<OptimizationPass> Optimizer::ALL_PASSES = {
     OptimizationPass("CacheAcrossWorkGroup", "work-group-cache", cacheWorkGroupDMAAccess,
         "finds memory access across the work-group which can be cached in VPM to combine the DMA operation (WIP)",
         OptimizationType::FINAL),
+    OptimizationPass("SuperblockScheduler", "schedule-superblocks", scheduleSuperblocks,
+        "moves instructions across basic blocks within chains of blocks with a single entry to fill delays",
+        OptimizationType::FINAL),
     OptimizationPass("InstructionScheduler", "schedule-instructions", reorderInstructions,
         "schedule instructions according to their dependencies within basic blocks (WIP, slow)",
         OptimizationType::FINAL),
     OptimizationPass("ReorderInstructions", "reorder", reorderWithinBasicBlocks,
         "re-order instructions to eliminate more NOPs and stall cycles", OptimizationType::FINAL),
     OptimizationPass("CombineALUIinstructions", "combine", combineOperations,
-        "run peep-hole optimization to combine ALU-operations", OptimizationType::FINAL)};
+        "run peep-hole optimization to combine ALU-operations", OptimizationType::FINAL),
+    /*
+     * The last block of optimizations is executed by the code generator after the register allocation, since the
+     * register allocation may still insert instructions.
+     */
+    OptimizationPass("FillBranchDelaySlots", "fill-delay-slots", fillBranchDelaySlots,
+        "moves instructions preceding the branches into their delay slots", OptimizationType::POST_ALLOCATION)};
 
 std::set<std::string> Optimizer::getPasses(OptimizationLevel level)
 {
@@ -312,11 +359,19 @@ std::set<std::string> Optimizer::getPasses(OptimizationLevel level)
     {
     case OptimizationLevel::FULL:
         passes.emplace("vectorize-loops");
+        passes.emplace("unroll-loops");
+        passes.emplace("pipeline-tmu-loads");
+        passes.emplace("combine-dma");
+        passes.emplace("reduce-strength");
+        passes.emplace("move-loop-invariants");
         passes.emplace("extract-loads-from-loops");
+        passes.emplace("schedule-superblocks");
         passes.emplace("schedule-instructions");
         passes.emplace("work-group-cache");
+        passes.emplace("cache-uniforms");
         // XXX move CSE to medium? Need to profile performance and re-check all emulation tests with CSE enabled
         passes.emplace("eliminate-common-subexpressions");
+        passes.emplace("global-value-numbering");
         // XXX if tested enough, move to full
         passes.emplace("simplify-conditionals");
         FALL_THROUGH
@@ -335,6 +390,7 @@ std::set<std::string> Optimizer::getPasses(OptimizationLevel level)
         passes.emplace("single-steps");
         passes.emplace("reorder");
         passes.emplace("combine");
+        passes.emplace("fill-delay-slots");
         passes.emplace("remove-unused-flags");
         passes.emplace("loop-work-groups");
         FALL_THROUGH
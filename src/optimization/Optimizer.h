@@ -39,7 +39,13 @@ namespace vc4c
             /*
              * Run this optimization once at the end of the optimization passes
              */
-            FINAL
+            FINAL,
+            /*
+             * Run this optimization once after the register allocation, right before the machine code is generated.
+             *
+             * NOTE: These passes are not run by #optimizeKernel(), but by the code generator.
+             */
+            POST_ALLOCATION
         };
 
         /*
@@ -100,6 +106,19 @@ namespace vc4c
             explicit Optimizer(const Configuration& config);
 
             void optimize(Module& module) const;
+            /*
+             * Runs the enabled optimization passes on the given kernel only.
+             *
+             * This can be called for different kernels of the same module in parallel.
+             */
+            void optimizeKernel(Module& module, Method& kernel) const;
+            /*
+             * Runs the enabled optimization passes which need to be executed after the register allocation on the given
+             * kernel.
+             *
+             * This can be called for different kernels of the same module in parallel.
+             */
+            void optimizeAllocatedKernel(const Module& module, Method& kernel) const;
 
             /*
              * The complete list of all optimization passes available to be used
@@ -118,6 +137,7 @@ namespace vc4c
             std::vector<const OptimizationPass*> initialPasses;
             std::vector<const OptimizationPass*> repeatingPasses;
             std::vector<const OptimizationPass*> finalPasses;
+            std::vector<const OptimizationPass*> postAllocationPasses;
         };
 
     } // namespace optimizations
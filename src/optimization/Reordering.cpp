@@ -8,8 +8,12 @@
 
 #include "../Profiler.h"
 #include "../intermediate/Helper.h"
+#include "../periphery/TMU.h"
 #include "log.h"
 
+#include <algorithm>
+#include <set>
+
 using namespace vc4c;
 using namespace vc4c::optimizations;
 using namespace vc4c::intermediate;
@@ -474,3 +478,282 @@ InstructionWalker optimizations::moveRotationSourcesToAccumulators(
     }
     return it;
 }
+
+/*
+ * A memory read via the TMU consisting of the TMU request (writing the address), the instruction triggering the load
+ * of the response (the ldtmu signal) and the instruction reading the response from r4.
+ *
+ * The loads are identified by their instructions, since the positions change when requests are moved.
+ */
+struct TMULoad
+{
+    IntermediateInstruction* request;
+    IntermediateInstruction* trigger;
+    const IntermediateInstruction* result;
+};
+
+/*
+ * The instructions of a basic block in their current order together with the reverse mapping to their positions.
+ */
+struct BlockInstructions
+{
+    std::vector<InstructionWalker> walkers;
+    FastMap<const IntermediateInstruction*, std::size_t> positions;
+
+    void updatePositions(std::size_t start, std::size_t end)
+    {
+        for(auto i = start; i < end; ++i)
+            positions[walkers[i].get()] = i;
+    }
+
+    std::size_t getPosition(const IntermediateInstruction* inst) const
+    {
+        return positions.at(inst);
+    }
+};
+
+static Optional<Register> getTMUAddressRegister(const IntermediateInstruction* inst)
+{
+    auto reg = inst->checkOutputRegister();
+    if(reg && (*reg == REG_TMU0_ADDRESS || *reg == REG_TMU1_ADDRESS) && inst->signal == SIGNAL_NONE &&
+        !inst->hasConditionalExecution() && dynamic_cast<const MoveOperation*>(inst) &&
+        !dynamic_cast<const VectorRotation*>(inst))
+        return reg;
+    return {};
+}
+
+static bool accessesTMU(const IntermediateInstruction* inst)
+{
+    if(inst->signal == SIGNAL_LOAD_TMU0 || inst->signal == SIGNAL_LOAD_TMU1)
+        return true;
+    if(inst->checkOutputRegister() && inst->checkOutputRegister()->isTextureMemoryUnit())
+        return true;
+    return inst->readsRegister(REG_TMU_OUT) || inst->readsRegister(REG_TMU_NOSWAP);
+}
+
+/*
+ * Lists all simple TMU loads (request directly followed by the trigger, directly followed by reading the result) of
+ * the given instructions. All other instructions accessing the TMU (e.g. reading 64-bit values or images) are marked
+ * as barriers, since they would need special handling.
+ */
+static std::vector<TMULoad> findTMULoads(
+    const std::vector<InstructionWalker>& instructions, FastSet<const IntermediateInstruction*>& barriers)
+{
+    std::vector<TMULoad> loads;
+    for(std::size_t i = 0; i < instructions.size(); ++i)
+    {
+        if(auto reg = getTMUAddressRegister(instructions[i].get()))
+        {
+            auto signal = *reg == REG_TMU0_ADDRESS ? periphery::TMU0.signal : periphery::TMU1.signal;
+            if(i + 2 < instructions.size())
+            {
+                auto nop = instructions[i + 1].get<const Nop>();
+                auto result = instructions[i + 2].get();
+                if(nop && nop->type == DelayType::WAIT_TMU && nop->signal == signal &&
+                    !result->hasConditionalExecution() && result->readsRegister(REG_TMU_OUT) &&
+                    result->checkOutputLocal() && !result->checkOutputRegister())
+                {
+                    loads.push_back(TMULoad{instructions[i].copy().get(), instructions[i + 1].copy().get(), result});
+                    i += 2;
+                    continue;
+                }
+            }
+        }
+        if(accessesTMU(instructions[i].get()) || instructions[i]->hasSideEffects())
+            barriers.emplace(instructions[i].get());
+    }
+    return loads;
+}
+
+/*
+ * Whether the instruction only calculates a value (e.g. a part of the address to load from) and therefore can be
+ * moved freely, as long as its operands are available.
+ */
+static bool isPureCalculation(const IntermediateInstruction* inst)
+{
+    if(!dynamic_cast<const Operation*>(inst) && !dynamic_cast<const LoadImmediate*>(inst) &&
+        (!dynamic_cast<const MoveOperation*>(inst) || dynamic_cast<const VectorRotation*>(inst)))
+        return false;
+    if(inst->hasSideEffects() || inst->hasConditionalExecution() || inst->hasPackMode() || inst->hasUnpackMode())
+        return false;
+    auto out = inst->checkOutputLocal();
+    if(!out || out->getUsers(LocalUse::Type::WRITER).size() != 1)
+        return false;
+    return std::all_of(inst->getArguments().begin(), inst->getArguments().end(), [](const Value& arg) -> bool {
+        return !arg.checkRegister() || (!arg.reg().isAccumulator() && !arg.reg().hasSideEffectsOnRead());
+    });
+}
+
+/*
+ * Collects the positions of all instructions in the range [newPosition, position) which calculate the operands of the
+ * instruction at the given position and therefore need to be moved together with it.
+ *
+ * Returns false, if the operands cannot be calculated before the new position (e.g. because they depend on the result
+ * of a TMU load consumed after the new position).
+ */
+static bool collectOperandCalculations(const BlockInstructions& instructions, std::size_t newPosition,
+    std::size_t position, std::set<std::size_t>& calculations)
+{
+    bool canBeMoved = true;
+    instructions.walkers[position]->forUsedLocals(
+        [&](const Local* local, LocalUse::Type type, const IntermediateInstruction& inst) {
+            if(!canBeMoved || !has_flag(type, LocalUse::Type::READER))
+                return;
+            for(auto writer : local->getUsers(LocalUse::Type::WRITER))
+            {
+                auto writerIt = instructions.positions.find(writer);
+                if(writerIt == instructions.positions.end() || writerIt->second < newPosition ||
+                    writerIt->second >= position)
+                    continue;
+                if(calculations.find(writerIt->second) != calculations.end())
+                    continue;
+                if(!isPureCalculation(writer))
+                {
+                    canBeMoved = false;
+                    return;
+                }
+                // the calculated value must not be read in between by an instruction expecting the previous value
+                for(auto reader : local->getUsers(LocalUse::Type::READER))
+                {
+                    auto readerIt = instructions.positions.find(reader);
+                    if(readerIt != instructions.positions.end() && readerIt->second >= newPosition &&
+                        readerIt->second < writerIt->second)
+                    {
+                        canBeMoved = false;
+                        return;
+                    }
+                }
+                calculations.emplace(writerIt->second);
+                if(!collectOperandCalculations(instructions, newPosition, writerIt->second, calculations))
+                {
+                    canBeMoved = false;
+                    return;
+                }
+            }
+        });
+    return canBeMoved;
+}
+
+/*
+ * Tries to issue the request of the TMU load with the given index before the response of one or more previous loads
+ * is consumed, so the loads are processed by the TMUs concurrently.
+ *
+ * The request can be moved in front of the responses of all previous loads whose requests are already issued before,
+ * as long as the TMU it is assigned to has space in its FIFO for all the requests in flight.
+ */
+static bool hoistTMURequest(BlockInstructions& instructions, const FastSet<const IntermediateInstruction*>& barriers,
+    const std::vector<TMULoad>& loads, std::size_t index)
+{
+    const auto& load = loads[index];
+    const auto requestPosition = instructions.getPosition(load.request);
+    // the requests are not reordered, since the responses of a TMU are returned in the order of the requests
+    std::size_t lowerBound = instructions.getPosition(loads[index - 1].request) + 1;
+    for(auto pos = requestPosition; pos > lowerBound; --pos)
+    {
+        if(barriers.find(instructions.walkers[pos - 1].get()) != barriers.end())
+        {
+            lowerBound = pos;
+            break;
+        }
+    }
+
+    Optional<std::size_t> target;
+    std::set<std::size_t> targetCalculations;
+    bool useTMU1 = getTMUAddressRegister(load.request) == REG_TMU1_ADDRESS;
+    for(auto previous = index; previous > 0; --previous)
+    {
+        auto newPosition = instructions.getPosition(loads[previous - 1].trigger);
+        if(newPosition < lowerBound)
+            break;
+        std::set<std::size_t> calculations;
+        if(!collectOperandCalculations(instructions, newPosition, requestPosition, calculations))
+            break;
+
+        // the number of requests queued to the single TMUs when inserting the request at the new position
+        unsigned numTMU0Requests = 0;
+        unsigned numTMU1Requests = 0;
+        for(std::size_t i = 0; i < index; ++i)
+        {
+            if(instructions.getPosition(loads[i].request) < newPosition &&
+                instructions.getPosition(loads[i].trigger) >= newPosition)
+            {
+                if(getTMUAddressRegister(loads[i].request) == REG_TMU1_ADDRESS)
+                    ++numTMU1Requests;
+                else
+                    ++numTMU0Requests;
+            }
+        }
+        if(numTMU0Requests >= periphery::TMU_FIFO_DEPTH && numTMU1Requests >= periphery::TMU_FIFO_DEPTH)
+            break;
+
+        target = newPosition;
+        targetCalculations = std::move(calculations);
+        // distribute the concurrent requests to both TMUs
+        useTMU1 = numTMU1Requests < numTMU0Requests || (numTMU1Requests == numTMU0Requests && useTMU1);
+    }
+
+    if(!target)
+        return false;
+
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Issuing TMU request " << load.request->to_string() << " before consuming response of "
+            << instructions.walkers[*target + 1]->to_string() << logging::endl);
+
+    const auto& tmu = useTMU1 ? periphery::TMU1 : periphery::TMU0;
+    load.request->setOutput(tmu.getAddress(load.request->getOutput()->type));
+    load.trigger->setSignaling(tmu.signal);
+
+    // move the instructions and update the tracked order for the range [target, request]
+    std::vector<InstructionWalker> reordered;
+    reordered.reserve(requestPosition + 1 - *target);
+    auto insertIt = instructions.walkers[*target].copy();
+    targetCalculations.emplace(requestPosition);
+    for(auto pos : targetCalculations)
+    {
+        auto it = instructions.walkers[pos].copy();
+        insertIt.emplace(it.release());
+        reordered.push_back(insertIt);
+        insertIt.nextInBlock();
+        it.erase();
+    }
+    for(auto pos = *target; pos <= requestPosition; ++pos)
+    {
+        if(targetCalculations.find(pos) == targetCalculations.end())
+            reordered.push_back(instructions.walkers[pos]);
+    }
+    std::copy(reordered.begin(), reordered.end(), instructions.walkers.begin() + static_cast<std::ptrdiff_t>(*target));
+    instructions.updatePositions(*target, requestPosition + 1);
+    return true;
+}
+
+bool optimizations::pipelineTMULoads(const Module& module, Method& method, const Configuration& config)
+{
+    if(method.metaData.isMultiThreaded)
+        // the thread switch already hides the latency of the TMU loads
+        return false;
+
+    bool hasChanged = false;
+    for(BasicBlock& block : method)
+    {
+        BlockInstructions instructions;
+        for(auto it = block.walk(); !it.isEndOfBlock(); it.nextInBlock())
+        {
+            if(it.has())
+                instructions.walkers.push_back(it);
+        }
+        instructions.updatePositions(0, instructions.walkers.size());
+
+        // the loads are only collected once, since moved requests are no longer directly followed by their responses
+        FastSet<const IntermediateInstruction*> barriers;
+        auto loads = findTMULoads(instructions.walkers, barriers);
+        for(std::size_t index = 1; index < loads.size(); ++index)
+        {
+            if(hoistTMURequest(instructions, barriers, loads, index))
+            {
+                hasChanged = true;
+                PROFILE_COUNTER(vc4c::profiler::COUNTER_OPTIMIZATION + 340, "Pipelined TMU loads", 1);
+            }
+        }
+    }
+    return hasChanged;
+}
@@ -44,6 +44,34 @@ namespace vc4c
          */
         bool reorderWithinBasicBlocks(const Module& module, Method& method, const Configuration& config);
 
+        /*
+         * Issues the requests of memory reads via the TMU before the responses of previous reads within the same basic
+         * block are consumed, so the TMUs can process multiple reads at once instead of stalling the QPU for every
+         * single read. The concurrent reads are distributed across both TMUs, up to the depth of their request queues.
+         *
+         * Example:
+         *   tmu0_s = %addr0
+         *   nop.load_tmu0
+         *   %val0 = r4
+         *   %addr1 = add %addr0, 64
+         *   tmu0_s = %addr1
+         *   nop.load_tmu0
+         *   %val1 = r4
+         *
+         * is converted to:
+         *   tmu0_s = %addr0
+         *   %addr1 = add %addr0, 64
+         *   tmu1_s = %addr1
+         *   nop.load_tmu0
+         *   %val0 = r4
+         *   nop.load_tmu1
+         *   %val1 = r4
+         *
+         * Together with the unrolling of loops, this issues the reads of following iterations before the value read in
+         * the current iteration is used.
+         */
+        bool pipelineTMULoads(const Module& module, Method& method, const Configuration& config);
+
         /*
          * Prevents register-mapping errors by guaranteeing the source of a vector-rotation to be mappable to an
          * accumulator. To do this, long-living used in a vector-rotation are moved to a temporary local which then can
@@ -8,10 +8,13 @@
 
 #include "../GlobalValues.h"
 #include "../InstructionWalker.h"
+#include "../analysis/ControlFlowGraph.h"
 #include "../intermediate/VectorHelper.h"
 #include "../intermediate/operators.h"
 #include "log.h"
 
+#include <algorithm>
+
 using namespace vc4c;
 using namespace vc4c::periphery;
 using namespace vc4c::operators;
@@ -255,3 +258,226 @@ InstructionWalker periphery::insertReadTMU(Method& method, InstructionWalker it,
     // 6. TODO reset UNIFORM pointer? for next work-group iteration, or disable when used with images?
     return it;
 }
+
+static bool hasSignal(const intermediate::IntermediateInstruction* inst)
+{
+    if(auto combined = dynamic_cast<const intermediate::CombinedOperation*>(inst))
+        return (combined->op1 && hasSignal(combined->op1.get())) || (combined->op2 && hasSignal(combined->op2.get()));
+    return inst->signal.hasSideEffects();
+}
+
+/*
+ * Whether the instruction triggers a SFU calculation or TMU load whose result is written to the accumulator r4
+ */
+static bool producesR4(const intermediate::IntermediateInstruction* inst)
+{
+    if(auto combined = dynamic_cast<const intermediate::CombinedOperation*>(inst))
+        return (combined->op1 && producesR4(combined->op1.get())) || (combined->op2 && producesR4(combined->op2.get()));
+    return inst->signal.triggersReadOfR4() || (inst->checkOutputRegister() & &Register::triggersReadOfR4);
+}
+
+static bool readsR4(const intermediate::IntermediateInstruction* inst)
+{
+    if(auto combined = dynamic_cast<const intermediate::CombinedOperation*>(inst))
+        return (combined->op1 && readsR4(combined->op1.get())) || (combined->op2 && readsR4(combined->op2.get()));
+    return inst->readsRegister(REG_SFU_OUT);
+}
+
+/*
+ * Whether the thread switch signal can be set on the given instruction
+ */
+static bool canCarryThreadSwitch(const intermediate::IntermediateInstruction* inst)
+{
+    if(inst->signal != SIGNAL_NONE || !inst->mapsToASMInstruction())
+        return false;
+    bool isSimpleInstruction = dynamic_cast<const intermediate::Operation*>(inst) ||
+        dynamic_cast<const intermediate::Nop*>(inst) ||
+        (dynamic_cast<const intermediate::MoveOperation*>(inst) &&
+            !dynamic_cast<const intermediate::VectorRotation*>(inst));
+    // small immediate values are encoded in the signal field
+    return isSimpleInstruction &&
+        std::none_of(inst->getArguments().begin(), inst->getArguments().end(),
+            [](const Value& arg) -> bool { return arg.checkImmediate(); });
+}
+
+/*
+ * Whether the given instruction can be executed in one of the two delay slots of a thread switch
+ */
+static bool isValidThreadSwitchDelaySlot(const intermediate::IntermediateInstruction* inst)
+{
+    return !hasSignal(inst) && !producesR4(inst) && !readsR4(inst) && !dynamic_cast<const intermediate::Branch*>(inst);
+}
+
+/*
+ * Determines for every position of the block whether the flags set before are read at or after the position. The flags
+ * are not preserved across thread switches.
+ */
+static std::vector<bool> findLiveFlags(const std::vector<InstructionWalker>& instructions)
+{
+    std::vector<bool> areFlagsLive(instructions.size() + 1, false);
+    for(auto pos = instructions.size(); pos-- > 0;)
+    {
+        const auto* inst = instructions[pos].get();
+        auto branch = dynamic_cast<const intermediate::Branch*>(inst);
+        if(inst->hasConditionalExecution() || (branch && !branch->isUnconditional()))
+            areFlagsLive[pos] = true;
+        else if(inst->setFlags == SetFlag::SET_FLAGS)
+            areFlagsLive[pos] = false;
+        else
+            areFlagsLive[pos] = areFlagsLive[pos + 1];
+    }
+    return areFlagsLive;
+}
+
+/*
+ * Inserts a thread switch with the given signal taking effect after the instruction at the start position and before
+ * the instruction at the end position. The instructions from the given begin position on are checked for values which
+ * need to be preserved across the switch.
+ *
+ * The signal is preferably set on an existing instruction followed by two other instructions, which then execute in
+ * the delay slots of the thread switch. NOPs are only inserted if there are not enough such instructions.
+ *
+ * Returns false if no thread switch can be inserted, since the flags or a value in r4 would need to be preserved.
+ */
+static bool insertThreadSwitch(const std::vector<InstructionWalker>& instructions,
+    const std::vector<bool>& areFlagsLive, std::size_t begin, std::size_t start, std::size_t end, Signaling signal,
+    intermediate::DelayType delayType)
+{
+    // whether a SFU/TMU result is not yet read from r4 at the given position
+    std::vector<bool> isR4Pending(end + 1 - begin, false);
+    for(auto pos = begin; pos < end; ++pos)
+    {
+        const auto* inst = instructions[pos].get();
+        isR4Pending[pos + 1 - begin] = producesR4(inst) || (isR4Pending[pos - begin] && !readsR4(inst));
+    }
+
+    // checks whether the switch can be signaled by the given instruction and takes effect at the given position
+    auto canSwitchAt = [&](Optional<std::size_t> carrier, std::size_t switchPosition) -> bool {
+        if(carrier &&
+            (!canCarryThreadSwitch(instructions[*carrier].get()) ||
+                !std::all_of(instructions.begin() + static_cast<std::ptrdiff_t>(*carrier + 1),
+                    instructions.begin() + static_cast<std::ptrdiff_t>(switchPosition),
+                    [](const InstructionWalker& it) -> bool { return isValidThreadSwitchDelaySlot(it.get()); })))
+            return false;
+        return !isR4Pending[switchPosition - begin] && !areFlagsLive[switchPosition];
+    };
+
+    Optional<std::size_t> carrier;
+    // prefer instructions followed by two instructions usable as delay slots, then the ones requiring fewer NOPs
+    for(auto pos = end; !carrier && pos-- > start;)
+    {
+        if(pos + 3 <= end && canSwitchAt(pos, pos + 3))
+            carrier = pos;
+    }
+    for(auto pos = std::max(start, end - std::min(end, std::size_t{2})); !carrier && pos < end; ++pos)
+    {
+        if(canSwitchAt(pos, end))
+            carrier = pos;
+    }
+    if(!carrier && !canSwitchAt({}, end))
+        return false;
+
+    auto endIt = instructions[end].copy();
+    std::size_t numDelaySlots = 0;
+    if(carrier)
+    {
+        instructions[*carrier].copy()->setSignaling(signal);
+        numDelaySlots = std::min(end - *carrier - 1, std::size_t{2});
+    }
+    else
+        nop(endIt, delayType, signal);
+    // the thread switch needs to take effect before the instruction at the end
+    for(; numDelaySlots < 2; ++numDelaySlots)
+        nop(endIt, delayType);
+    return true;
+}
+
+bool periphery::hasUniformTMUAccesses(Method& method)
+{
+    // the number of TMU loads executed before entering the block
+    FastMap<const BasicBlock*, std::size_t> numPrecedingLoads;
+    std::vector<BasicBlock*> openBlocks{&*method.begin()};
+    numPrecedingLoads.emplace(openBlocks.front(), 0);
+    auto& cfg = method.getCFG();
+    while(!openBlocks.empty())
+    {
+        auto block = openBlocks.back();
+        openBlocks.pop_back();
+        auto numLoads = numPrecedingLoads.at(block) +
+            static_cast<std::size_t>(std::count_if(block->begin(), block->end(), [](const intermediate::IL& inst) {
+                return inst && (inst->signal == SIGNAL_LOAD_TMU0 || inst->signal == SIGNAL_LOAD_TMU1);
+            }));
+        bool isUniform = true;
+        cfg.assertNode(block).forAllOutgoingEdges([&](CFGNode& successor, CFGEdge&) -> bool {
+            auto it = numPrecedingLoads.find(successor.key);
+            if(it == numPrecedingLoads.end())
+            {
+                numPrecedingLoads.emplace(successor.key, numLoads);
+                openBlocks.push_back(successor.key);
+            }
+            else if(it->second != numLoads)
+                // the paths (or loop iterations) leading to the block execute a different number of TMU loads
+                isUniform = false;
+            return isUniform;
+        });
+        if(!isUniform)
+            return false;
+    }
+    return true;
+}
+
+void periphery::insertThreadSwitches(Method& method)
+{
+    if(!method.metaData.isMultiThreaded)
+        return;
+    for(auto& block : method)
+    {
+        // the instructions are only inserted directly in front of the current position, so the walkers of all
+        // following instructions stay valid
+        std::vector<InstructionWalker> instructions;
+        for(auto it = block.walk().nextInBlock(); !it.isEndOfBlock(); it.nextInBlock())
+        {
+            if(it.has())
+                instructions.push_back(it);
+        }
+
+        // the position after the last TMU load, a thread switch cannot be inserted before
+        auto areFlagsLive = findLiveFlags(instructions);
+        std::size_t begin = 0;
+        bool isMutexLocked = false;
+        for(std::size_t pos = 0; pos < instructions.size(); ++pos)
+        {
+            const auto* inst = instructions[pos].get();
+            if(inst->writesRegister(REG_MUTEX) || inst->readsRegister(REG_MUTEX))
+                isMutexLocked = inst->readsRegister(REG_MUTEX);
+            if(auto mutex = dynamic_cast<const intermediate::MutexLock*>(inst))
+                isMutexLocked = mutex->locksMutex();
+            if(inst->signal == SIGNAL_LOAD_TMU0 || inst->signal == SIGNAL_LOAD_TMU1)
+            {
+                // switch to the other thread after writing the TMU request and before waiting for the response
+                auto request = pos;
+                while(request > begin &&
+                    !(instructions[request - 1]->checkOutputRegister() & &Register::isTextureMemoryUnit))
+                    --request;
+                // Since all threads execute the same TMU loads, not switching threads for a load keeps the number of
+                // thread switches the same for all threads. The other thread cannot acquire a locked mutex.
+                if(request == begin || isMutexLocked ||
+                    !insertThreadSwitch(instructions, areFlagsLive, begin, request - 1, pos, SIGNAL_SWITCH_THREAD,
+                        intermediate::DelayType::WAIT_TMU))
+                    CPPLOG_LAZY(logging::Level::DEBUG,
+                        log << "Cannot switch threads while waiting for TMU load: " << inst->to_string()
+                            << logging::endl);
+                begin = pos + 1;
+            }
+            else if(inst->signal == SIGNAL_END_PROGRAM)
+            {
+                // the last thread switch hands over to the other thread for the rest of its execution
+                if(!insertThreadSwitch(instructions, areFlagsLive, begin, begin, pos, SIGNAL_THREAD_SWITCH_LAST,
+                       intermediate::DelayType::THREAD_END))
+                    throw CompilationError(CompilationStep::GENERAL,
+                        "Failed to insert the last thread switch before the end of the program", inst->to_string());
+                begin = pos + 1;
+            }
+        }
+    }
+}
@@ -43,6 +43,11 @@ namespace vc4c
         extern const TMU TMU0;
         extern const TMU TMU1;
 
+        /*
+         * The number of requests every QPU can queue up to each of the TMUs
+         */
+        constexpr unsigned TMU_FIFO_DEPTH = 4;
+
         /*
          * TMU
          *
@@ -68,6 +73,24 @@ namespace vc4c
         NODISCARD InstructionWalker insertReadTMU(Method& method, InstructionWalker it, const Value& image,
             const Value& dest, const Value& xCoord, const Optional<Value>& yCoord = NO_VALUE, const TMU& tmu = TMU0);
 
+        /*
+         * Returns whether every execution of the kernel executes the same number of TMU loads, independent of the
+         * control-flow taken (e.g. the number of loop iterations).
+         *
+         * Both hardware threads on a QPU need to execute the same number of thread switches, which are inserted for the
+         * TMU loads.
+         */
+        bool hasUniformTMUAccesses(Method& method);
+
+        /*
+         * For kernels running two hardware threads per QPU, inserts the thread switches to the other thread while
+         * waiting for the TMU loads and the last thread switch before the end of the program.
+         *
+         * The thread switch takes effect after two delay slots, which are filled with the instructions between the TMU
+         * request and loading its response, where possible.
+         */
+        void insertThreadSwitches(Method& method);
+
     } /* namespace periphery */
 } /* namespace vc4c */
 
@@ -49,7 +49,7 @@ SPIRVBuiltin spirv::BUILTIN_GROUP_ID{
 SPIRVBuiltin spirv::BUILTIN_GLOBAL_OFFSET{
     spv::BuiltIn::GlobalOffset, TYPE_INT32.toVectorType(3), "%builtin_global_offset", "vc4cl_global_offset", true};
 
-std::string spirv::BUILTIN_INTRINSIC{"load_builtin"};
+Symbol spirv::BUILTIN_INTRINSIC{"load_builtin"};
 
 static Optional<Value> getDimensionalArgument(const intermediate::IntrinsicOperation& intrinsicOp)
 {
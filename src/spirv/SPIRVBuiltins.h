@@ -9,6 +9,7 @@
 #ifdef SPIRV_FRONTEND
 
 #include "../Locals.h"
+#include "../Symbol.h"
 
 #include "spirv/unified1/spirv.hpp11"
 
@@ -66,7 +67,7 @@ namespace vc4c
         extern SPIRVBuiltin BUILTIN_GLOBAL_OFFSET;
 
         // The magic constant indicating an intermediate::IntrinsicOperation which for reading a built-in value
-        extern std::string BUILTIN_INTRINSIC;
+        extern Symbol BUILTIN_INTRINSIC;
 
         /**
          * Lowers the "loading" of OpenCL C work-item functions from SPIR-V constant memory into the "normal" intrinsic
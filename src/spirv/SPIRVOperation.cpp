@@ -678,7 +678,7 @@ void SPIRVCopy::mapInstruction(TypeMapping& types, ConstantMapping& constants, L
         CPPLOG_LAZY(logging::Level::DEBUG,
             log << "Generating reading of " << builtin->to_string() << " into " << dest.to_string() << logging::endl);
         method.method->appendToEnd(
-            (new intermediate::IntrinsicOperation(std::string{BUILTIN_INTRINSIC}, std::move(dest), std::move(source)))
+            (new intermediate::IntrinsicOperation(BUILTIN_INTRINSIC, std::move(dest), std::move(source)))
                 ->addDecorations(decorations));
     }
     else if(memoryAccess != MemoryAccess::NONE)
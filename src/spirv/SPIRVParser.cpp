@@ -104,61 +104,6 @@ void SPIRVParser::parse(Module& module)
     CPPLOG_LAZY(logging::Level::DEBUG, log << "SPIR-V binary successfully parsed" << logging::endl);
     spvContextDestroy(context);
 
-    // resolve method parameters
-    // set names, e.g. for methods, parameters
-    for(auto& m : methods)
-    {
-        auto it = names.find(m.first);
-        if(it != names.end())
-            m.second.method->name = it->second;
-        m.second.method->parameters.reserve(m.second.parameters.size());
-        std::istringstream parameterTypeNames{};
-        {
-            // This is e.g. used to specify the original kernel parameter names, at least for more recent clang/SPIR-V
-            // compilers, see
-            // https://github.com/KhronosGroup/SPIRV-LLVM-Translator/blob/5de39350b76246609a2b233e9453e54f48f0a9c6/lib/SPIRV/SPIRVWriter.cpp#L1910
-            // this is in the format "kernel_arg_type.%kernel_name%.typename0,typename1,..."
-            auto searchText = "kernel_arg_type." + m.second.method->name;
-            auto it = std::find_if(
-                strings.begin(), strings.end(), [&](const auto& s) -> bool { return s.find(searchText) == 0; });
-            if(it != strings.end() && it->find('.') != std::string::npos)
-                parameterTypeNames.str(it->substr(it->find_last_of('.') + 1));
-        }
-        for(const auto& pair : m.second.parameters)
-        {
-            auto type = typeMappings.at(pair.second);
-            Parameter param(std::string("%") + std::to_string(pair.first), type);
-            auto it2 = decorationMappings.find(pair.first);
-            if(it2 != decorationMappings.end())
-                setParameterDecorations(param, it2->second);
-            it = names.find(pair.first);
-            if(it != names.end())
-                // parameters are referenced by their IDs, not their names, but for meta-data the names are better
-                param.parameterName = it->second;
-
-            if(param.type.getImageType())
-                intermediate::reserveImageConfiguration(module, param);
-
-            std::string parameterType{};
-            if(parameterTypeNames && std::getline(parameterTypeNames, parameterType, ','))
-                param.origTypeName = parameterType;
-
-            auto& ptr = m.second.method->addParameter(std::move(param));
-            memoryAllocatedData.emplace(pair.first, &ptr);
-        }
-
-        // to support OpenCL built-in operations, we need to demangle all VC4CL std-lib definitions of the OpenCL C
-        // standard functions to be able to map them correctly.
-        m.second.method->name = demangleFunctionName(m.second.method->name);
-    }
-
-    // map SPIRVOperations to IntermediateInstructions
-    CPPLOG_LAZY(logging::Level::DEBUG, log << "Mapping instructions to intermediate..." << logging::endl);
-    for(const auto& op : instructions)
-    {
-        op->mapInstruction(typeMappings, constantMappings, localTypes, methods, memoryAllocatedData);
-    }
-
     // apply kernel meta-data, decorations, ...
     for(const auto& pair : metadataMappings)
     {
@@ -209,15 +154,70 @@ void SPIRVParser::parse(Module& module)
 spv_result_t SPIRVParser::parseHeader(
     spv_endianness_t endian, uint32_t magic, uint32_t version, uint32_t generator, uint32_t id_bound, uint32_t reserved)
 {
-    // see:
-    // https://www.khronos.org/registry/spir-v/specs/1.2/SPIRV.html#_a_id_physicallayout_a_physical_layout_of_a_spir_v_module_and_instruction
-    // not completely true, since the header is not mapped to instructions, but still better than increasing every X new
-    // instruction
-    instructions.reserve(id_bound);
-
     return SPV_SUCCESS;
 }
 
+void SPIRVParser::finishMethod(SPIRVMethod& method)
+{
+    // resolve method parameters
+    // set names, e.g. for parameters
+    auto nameIt = names.find(method.id);
+    const std::string& functionName = nameIt != names.end() ? nameIt->second : method.method->name;
+    method.method->parameters.reserve(method.parameters.size());
+    std::istringstream parameterTypeNames{};
+    {
+        // This is e.g. used to specify the original kernel parameter names, at least for more recent clang/SPIR-V
+        // compilers, see
+        // https://github.com/KhronosGroup/SPIRV-LLVM-Translator/blob/5de39350b76246609a2b233e9453e54f48f0a9c6/lib/SPIRV/SPIRVWriter.cpp#L1910
+        // this is in the format "kernel_arg_type.%kernel_name%.typename0,typename1,..."
+        auto searchText = "kernel_arg_type." + functionName;
+        auto it = std::find_if(
+            strings.begin(), strings.end(), [&](const auto& s) -> bool { return s.find(searchText) == 0; });
+        if(it != strings.end() && it->find('.') != std::string::npos)
+            parameterTypeNames.str(it->substr(it->find_last_of('.') + 1));
+    }
+    for(const auto& pair : method.parameters)
+    {
+        auto type = typeMappings.at(pair.second);
+        Parameter param(std::string("%") + std::to_string(pair.first), type);
+        auto it2 = decorationMappings.find(pair.first);
+        if(it2 != decorationMappings.end())
+            setParameterDecorations(param, it2->second);
+        auto it = names.find(pair.first);
+        if(it != names.end())
+            // parameters are referenced by their IDs, not their names, but for meta-data the names are better
+            param.parameterName = it->second;
+
+        std::string parameterType{};
+        if(parameterTypeNames && std::getline(parameterTypeNames, parameterType, ','))
+            param.origTypeName = parameterType;
+
+        auto& ptr = method.method->addParameter(std::move(param));
+        memoryAllocatedData.emplace(pair.first, &ptr);
+    }
+
+    // map SPIRVOperations to IntermediateInstructions
+    CPPLOG_LAZY(logging::Level::DEBUG,
+        log << "Mapping " << instructions.size() << " instructions of function " << method.method->name
+            << " to intermediate..." << logging::endl);
+    for(const auto& op : instructions)
+    {
+        op->mapInstruction(typeMappings, constantMappings, localTypes, methods, memoryAllocatedData);
+    }
+
+    // release the parse state, which is only valid within this function
+    instructions.clear();
+    for(auto id : currentFunctionIDs)
+    {
+        localTypes.erase(id);
+        memoryAllocatedData.erase(id);
+        sampledImages.erase(id);
+        decorationMappings.erase(id);
+        names.erase(id);
+    }
+    currentFunctionIDs.clear();
+}
+
 intermediate::InstructionDecorations toInstructionDecoration(const spv::FPFastMathModeMask mode)
 {
     intermediate::InstructionDecorations decorations = intermediate::InstructionDecorations::NONE;
@@ -406,6 +406,8 @@ static CompoundConstant parseConstantComposite(const spv_parsed_instruction_t* i
 {
     DataType containerType = typeMappings.at(getWord(instruction, 1));
     std::vector<CompoundConstant> constants;
+    constants.reserve(instruction->num_words - 3);
+    // NOTE: homogeneous arrays are converted to the compact flat representation by the constructor of the constant
     for(std::size_t i = 3; i < instruction->num_words; ++i)
     {
         //"Result Type must be a composite type, whose top-level members/elements/components/columns have the same type
@@ -436,6 +438,21 @@ static SPIRVMethod& getOrCreateMethod(Module& module, MethodMapping& methods, co
     return methods.at(id);
 }
 
+/*
+ * Sets the final name of the given function.
+ *
+ * Since the debug names are all known before the first function is defined, the name can already be set when the
+ * function is first referenced, which is required to map calls to this function.
+ *
+ * To support OpenCL built-in operations, we need to demangle all VC4CL std-lib definitions of the OpenCL C standard
+ * functions to be able to map them correctly.
+ */
+static void setMethodName(SPIRVMethod& method, const FastMap<uint32_t, std::string>& names)
+{
+    auto it = names.find(method.id);
+    method.method->name = demangleFunctionName(it != names.end() ? it->second : method.method->name);
+}
+
 static std::string toScalarType(uint16_t vectorType)
 {
     switch(vectorType)
@@ -468,12 +485,16 @@ spv_result_t SPIRVParser::parseInstruction(const spv_parsed_instruction_t* parse
     if(parsed_instruction == nullptr)
         return SPV_ERROR_INTERNAL;
 
+    if(currentMethod != nullptr && parsed_instruction->result_id != UNDEFINED_ID)
+        // remember all IDs defined within the current function to release their parse state after the function
+        currentFunctionIDs.push_back(parsed_instruction->result_id);
+
     /*
      * Type instructions are resolved immediately
      * Constants are resolved immediately
      * Specializations are immediately mapped to constants
      * Names are resolved immediately
-     * All instructions are enqueued to be mapped later
+     * All instructions are enqueued to be mapped as soon as their function is complete
      *
      * Only opcodes for supported capabilities (or standard-opcodes) are listed here
      */
@@ -892,10 +913,10 @@ spv_result_t SPIRVParser::parseInstruction(const spv_parsed_instruction_t* parse
     {
         currentMethod = &getOrCreateMethod(*module, methods, parsed_instruction->result_id);
         currentMethod->method->returnType = typeMappings.at(parsed_instruction->type_id);
-        auto it = names.find(parsed_instruction->result_id);
+        setMethodName(*currentMethod, names);
         CPPLOG_LAZY(logging::Level::DEBUG,
-            log << "Reading function: %" << parsed_instruction->result_id << " ("
-                << (it != names.end() ? it->second : currentMethod->method->name) << ")" << logging::endl);
+            log << "Reading function: %" << parsed_instruction->result_id << " (" << currentMethod->method->name << ")"
+                << logging::endl);
         return SPV_SUCCESS;
     }
     case spv::Op::OpFunctionParameter:
@@ -906,9 +927,13 @@ spv_result_t SPIRVParser::parseInstruction(const spv_parsed_instruction_t* parse
                 << parsed_instruction->result_id << logging::endl);
         return SPV_SUCCESS;
     case spv::Op::OpFunctionEnd:
+        // all instructions of the function are known, so we can already map them
+        finishMethod(*currentMethod);
         currentMethod = nullptr;
         return SPV_SUCCESS;
     case spv::Op::OpFunctionCall:
+        // the called function might not yet be defined, but its name is required when mapping the call
+        setMethodName(getOrCreateMethod(*module, methods, getWord(parsed_instruction, 3)), names);
         localTypes[parsed_instruction->result_id] = parsed_instruction->type_id;
         instructions.emplace_back(new SPIRVCallSite(parsed_instruction->result_id, *currentMethod,
             getWord(parsed_instruction, 3), parsed_instruction->type_id, parseArguments(parsed_instruction, 4)));
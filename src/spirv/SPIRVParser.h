@@ -72,8 +72,10 @@ namespace vc4c
             FastMap<uint32_t, std::vector<Decoration>> decorationMappings;
             // mapping of locals to their types
             LocalTypeMapping localTypes;
-            // the global list of instructions, each instruction stores its own reference to the method it is in
+            // the instructions of the currently processed method, mapped and released as soon as the method is complete
             std::vector<std::unique_ptr<SPIRVOperation>> instructions;
+            // the IDs defined within the currently processed method, their mappings are released with the method
+            std::vector<uint32_t> currentFunctionIDs;
             // the global mapping of kernel ID -> meta-data
             FastMap<uint32_t, std::map<MetaDataType, std::array<uint32_t, 3>>> metadataMappings;
             // the global list of custom strings (e.g. kernel original parameter type names)
@@ -85,6 +87,15 @@ namespace vc4c
 
             std::pair<spv_result_t, Optional<Value>> calculateConstantOperation(
                 const spv_parsed_instruction_t* instruction);
+
+            /*
+             * Maps the instructions of the given method, once the definition of the method is complete.
+             *
+             * Since SPIR-V requires all types, constants and global data to be defined before the first function, all
+             * required information is already available. Afterwards, the parse state only required for this method is
+             * released, which limits the memory usage for large modules.
+             */
+            void finishMethod(SPIRVMethod& method);
         };
     } // namespace spirv
 } // namespace vc4c
@@ -1169,6 +1169,7 @@ bool QPU::execute(std::vector<qpu_asm::Instruction>::const_iterator firstInstruc
         log << "QPU " << static_cast<unsigned>(ID) << " (0x" << std::hex << pc << std::dec
             << "): " << inst->toASMString() << logging::endl);
     ProgramCounter nextPC = pc;
+    const bool isBranchDelaySlot = remainingDelaySlots > 0;
     if(inst->getSig() == SIGNAL_END_PROGRAM)
         // end program
         return false;
@@ -1191,7 +1192,10 @@ bool QPU::execute(std::vector<qpu_asm::Instruction>::const_iterator firstInstruc
                     br->getBranchRelative() == BranchRel::BRANCH_ABSOLUTE)
                     throw CompilationError(
                         CompilationStep::GENERAL, "This kind of branch is not yet implemented", br->toASMString());
-                nextPC += static_cast<ProgramCounter>(offset);
+                // the 3 instructions following the branch are executed before the branch takes effect
+                branchTarget = pc + static_cast<ProgramCounter>(offset);
+                remainingDelaySlots = 3;
+                ++nextPC;
 
                 // see Broadcom specification, page 34
                 registers.writeRegister(toRegister(br->getAddOut(), br->getWriteSwap() == WriteSwap::SWAP),
@@ -1275,6 +1279,14 @@ bool QPU::execute(std::vector<qpu_asm::Instruction>::const_iterator firstInstruc
     // clear cache for registers already read this instruction
     registers.clearReadCache();
 
+    if(isBranchDelaySlot && nextPC != pc)
+    {
+        // the instruction in the branch delay slot was completely executed (did not stall)
+        --remainingDelaySlots;
+        if(remainingDelaySlots == 0)
+            nextPC = branchTarget;
+    }
+
     ++currentCycle;
     pc = nextPC;
     return true;
@@ -1648,6 +1660,9 @@ bool QPU::executeSignal(Signaling signal)
         signal == SIGNAL_NONE)
         // ignore
         return true;
+    if(signal == SIGNAL_SWITCH_THREAD || signal == SIGNAL_THREAD_SWITCH_LAST)
+        // every QPU is emulated to run a single thread, so there is no other thread to switch to
+        return true;
     if(signal == SIGNAL_LOAD_TMU0)
         return tmus.triggerTMURead(0);
     else if(signal == SIGNAL_LOAD_TMU1)
@@ -1773,7 +1788,8 @@ static void emulateStep(std::vector<qpu_asm::Instruction>::const_iterator firstI
 }
 
 bool tools::emulate(std::vector<qpu_asm::Instruction>::const_iterator firstInstruction, Memory& memory,
-    const std::vector<MemoryAddress>& uniformAddresses, InstrumentationResults& instrumentation, uint32_t maxCycles)
+    const std::vector<MemoryAddress>& uniformAddresses, InstrumentationResults& instrumentation, uint32_t maxCycles,
+    uint32_t* numCycles)
 {
     if(uniformAddresses.size() > NUM_QPUS)
         throw CompilationError(CompilationStep::GENERAL, "Cannot use more than 12 QPUs!");
@@ -1832,6 +1848,8 @@ bool tools::emulate(std::vector<qpu_asm::Instruction>::const_iterator firstInstr
         log << "Emulation " << (success ? "finished" : "timed out") << " for " << uniformAddresses.size()
             << " QPUs after " << cycle << " cycles" << logging::endl);
 
+    if(numCycles)
+        *numCycles = cycle;
     vpm.dumpContents();
     return success;
 }
@@ -2031,16 +2049,16 @@ EmulationResult tools::emulate(const EmulationData& data)
     if(!data.memoryDump.empty())
         dumpMemory(mem, data.memoryDump, uniformAddress, true);
 
+    EmulationResult result{data};
     InstrumentationResults instrumentation;
     bool status = emulate(instructions.begin() +
             static_cast<std::vector<qpu_asm::Instruction>::difference_type>(
                 (kernelInfo->getOffset() - module.kernelInfos.front().getOffset()).getValue()),
-        mem, uniformAddresses, instrumentation, data.maxEmulationCycles);
+        mem, uniformAddresses, instrumentation, data.maxEmulationCycles, &result.numCycles);
 
     if(!data.memoryDump.empty())
         dumpMemory(mem, data.memoryDump, uniformAddress, false);
 
-    EmulationResult result{data};
     result.executionSuccessful = status;
 
     result.results.reserve(data.parameter.size());
@@ -2078,6 +2096,21 @@ EmulationResult tools::emulate(const EmulationData& data)
     return result;
 }
 
+std::unordered_map<std::string, uint32_t> tools::createBlockProfile(
+    const EmulationResult& result, const std::unordered_map<std::string, std::size_t>& blockLayout)
+{
+    std::unordered_map<std::string, uint32_t> profile;
+    profile.reserve(blockLayout.size());
+    for(const auto& block : blockLayout)
+    {
+        // empty blocks (e.g. at the end of the kernel) have no instruction of their own
+        if(block.second >= result.instrumentation.size())
+            continue;
+        profile.emplace(block.first, result.instrumentation[block.second].numExecutions);
+    }
+    return profile;
+}
+
 static std::vector<qpu_asm::Instruction> extractInstructions(const uint64_t* start, uint32_t numInstructions)
 {
     std::vector<qpu_asm::Instruction> res;
@@ -2102,10 +2135,11 @@ LowLevelEmulationResult tools::emulate(const LowLevelEmulationData& data)
     auto instructions = extractInstructions(data.kernelAddress, data.numInstructions);
     Memory mem(data.buffers);
 
+    LowLevelEmulationResult result{data};
     InstrumentationResults instrumentation;
-    bool status = emulate(instructions.begin(), mem, data.uniformAddresses, instrumentation, data.maxEmulationCycles);
+    bool status = emulate(instructions.begin(), mem, data.uniformAddresses, instrumentation, data.maxEmulationCycles,
+        &result.numCycles);
 
-    LowLevelEmulationResult result{data};
     result.executionSuccessful = status;
 
     // Map and dump instrumentation results
@@ -243,7 +243,8 @@ namespace vc4c
                 MemoryAddress uniformAddress, InstrumentationResults& instrumentation) :
                 ID(id),
                 mutex(mutex), registers(*this), uniforms(*this, memory, uniformAddress), tmus(*this, memory), sfu(sfu),
-                vpm(vpm), semaphores(semaphores), currentCycle(0), pc(0), instrumentation(instrumentation)
+                vpm(vpm), semaphores(semaphores), currentCycle(0), pc(0), branchTarget(0), remainingDelaySlots(0),
+                instrumentation(instrumentation)
             {
             }
 
@@ -268,6 +269,9 @@ namespace vc4c
             uint32_t currentCycle;
             VectorFlags flags;
             ProgramCounter pc;
+            // the target of the last branch taken, which is jumped to after the branch delay slots were executed
+            ProgramCounter branchTarget;
+            uint8_t remainingDelaySlots;
             InstrumentationResults& instrumentation;
 
             friend class Registers;
@@ -289,7 +293,7 @@ namespace vc4c
             const KernelUniforms& uniformsUsed);
         bool emulate(std::vector<qpu_asm::Instruction>::const_iterator firstInstruction, Memory& memory,
             const std::vector<MemoryAddress>& uniformAddresses, InstrumentationResults& instrumentation,
-            uint32_t maxCycles = std::numeric_limits<uint32_t>::max());
+            uint32_t maxCycles = std::numeric_limits<uint32_t>::max(), uint32_t* numCycles = nullptr);
         bool emulateTask(std::vector<qpu_asm::Instruction>::const_iterator firstInstruction,
             const std::vector<MemoryAddress>& parameter, Memory& memory, MemoryAddress uniformBaseAddress,
             MemoryAddress globalData, const KernelUniforms& uniformsUsed, InstrumentationResults& instrumentation,
@@ -12,6 +12,8 @@
 #include "../optimization/Optimizer.h"
 #include "log.h"
 
+#include <fstream>
+#include <sstream>
 #include <stdexcept>
 
 using namespace vc4c;
@@ -25,6 +27,42 @@ static std::set<std::string> createAvailableOptimizations()
     return opts;
 }
 
+void tools::writeBlockProfile(std::ostream& stream,
+    const std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>>& blockProfile)
+{
+    // sort the entries to write the same output for the same profile
+    std::map<std::string, std::map<std::string, uint32_t>> sortedProfile;
+    for(const auto& kernel : blockProfile)
+        sortedProfile[kernel.first].insert(kernel.second.begin(), kernel.second.end());
+    stream << "# kernel\tblock\texecutions" << std::endl;
+    for(const auto& kernel : sortedProfile)
+    {
+        for(const auto& block : kernel.second)
+            stream << kernel.first << '\t' << block.first << '\t' << block.second << std::endl;
+    }
+}
+
+bool tools::readBlockProfile(std::istream& stream, Configuration& config)
+{
+    std::string line;
+    while(std::getline(stream, line))
+    {
+        if(line.empty() || line[0] == '#')
+            continue;
+        std::istringstream ss(line);
+        std::string kernelName;
+        std::string blockName;
+        uint32_t numExecutions = 0;
+        if(!std::getline(ss, kernelName, '\t') || !std::getline(ss, blockName, '\t') || !(ss >> numExecutions))
+        {
+            std::cerr << "Invalid line in block profile: " << line << std::endl;
+            return false;
+        }
+        config.blockProfile[kernelName][blockName] = numExecutions;
+    }
+    return true;
+}
+
 bool tools::parseConfigurationParameter(Configuration& config, const std::string& arg)
 {
     static auto availableOptimizations = createAvailableOptimizations();
@@ -139,6 +177,62 @@ bool tools::parseConfigurationParameter(Configuration& config, const std::string
         config.stopWhenVerificationFailed = false;
         return true;
     }
+    if(arg == "--multi-threading")
+    {
+        config.useMultiThreading = true;
+        return true;
+    }
+    if(arg == "--no-multi-threading")
+    {
+        config.useMultiThreading = false;
+        return true;
+    }
+    if(arg == "--vpm-cache")
+    {
+        config.cacheMemoryInVPM = true;
+        return true;
+    }
+    if(arg == "--no-vpm-cache")
+    {
+        config.cacheMemoryInVPM = false;
+        return true;
+    }
+
+    if(arg.find("--profile=") == 0)
+    {
+        const std::string fileName = arg.substr(std::string("--profile=").size());
+        std::ifstream f(fileName);
+        if(!f.is_open())
+        {
+            std::cerr << "Cannot open block profile: " << fileName << std::endl;
+            return false;
+        }
+        return readBlockProfile(f, config);
+    }
+
+    if(arg.find("--options=") == 0)
+    {
+        // a file containing one option per line, e.g. written by the tuner
+        const std::string fileName = arg.substr(std::string("--options=").size());
+        std::ifstream f(fileName);
+        if(!f.is_open())
+        {
+            std::cerr << "Cannot open options file: " << fileName << std::endl;
+            return false;
+        }
+        std::string line;
+        while(std::getline(f, line))
+        {
+            if(line.empty() || line[0] == '#')
+                continue;
+            if(!parseConfigurationParameter(config, line))
+            {
+                std::cerr << "Invalid option in options file: " << line << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
 
     std::string passName;
     if(arg.find("--fno-") == 0)
@@ -187,6 +281,14 @@ bool tools::parseConfigurationParameter(Configuration& config, const std::string
                 config.additionalOptions.maxOptimizationIterations = static_cast<unsigned>(intValue);
             else if(paramName == "common-subexpression-threshold")
                 config.additionalOptions.maxCommonExpressionDinstance = static_cast<unsigned>(intValue);
+            else if(paramName == "unroll-threshold")
+                config.additionalOptions.maxUnrolledInstructions = static_cast<unsigned>(intValue);
+            else if(paramName == "loop-invariant-threshold")
+                config.additionalOptions.maxLoopInvariantLocals = static_cast<unsigned>(intValue);
+            else if(paramName == "scheduler-pressure-threshold")
+                config.additionalOptions.maxSchedulerRegisterPressure = static_cast<unsigned>(intValue);
+            else if(paramName == "combine-distance-threshold")
+                config.additionalOptions.maxCombinationDistance = static_cast<unsigned>(intValue);
             else
             {
                 std::cerr << "Cannot set unknown optimization parameter: " << paramName << " to " << value << std::endl;
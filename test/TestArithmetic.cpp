@@ -63,6 +63,20 @@ __kernel void test(__global OUT* out, const __global IN* in0, const __global IN*
 }
 )";
 
+static const std::string CONSTANT_OPERATION = R"(
+__kernel void test(__global TYPE* out, const __global TYPE* in) {
+  size_t gid = get_global_id(0);
+  out[gid] = in[gid] OP CONSTANT;
+}
+)";
+
+static const std::string CONVERTED_BINARY_OPERATION = R"(
+__kernel void test(__global OUT* out, const __global IN* in0, const __global IN* in1) {
+  size_t gid = get_global_id(0);
+  out[gid] = CONVERT(in0[gid]) OP CONVERT(in1[gid]);
+}
+)";
+
 TestArithmetic::TestArithmetic(const vc4c::Configuration& config) : config(config)
 {
     TEST_ADD(TestArithmetic::testSignedIntUnaryPlus);
@@ -104,6 +118,8 @@ TestArithmetic::TestArithmetic(const vc4c::Configuration& config) : config(confi
     TEST_ADD(TestArithmetic::testFloatSubtraction);
     TEST_ADD(TestArithmetic::testSignedLongSubtraction);
     TEST_ADD(TestArithmetic::testUnsignedLongSubtraction);
+    TEST_ADD(TestArithmetic::testSignedLongConstantSubtraction);
+    TEST_ADD(TestArithmetic::testUnsignedLongConstantSubtraction);
 
     TEST_ADD(TestArithmetic::testSignedIntMultiplication);
     TEST_ADD(TestArithmetic::testSignedShortMultiplication);
@@ -112,6 +128,9 @@ TestArithmetic::TestArithmetic(const vc4c::Configuration& config) : config(confi
     TEST_ADD(TestArithmetic::testUnsignedShortMultiplication);
     TEST_ADD(TestArithmetic::testUnsignedCharMultiplication);
     TEST_ADD(TestArithmetic::testFloatingPointMultiplication);
+    TEST_ADD(TestArithmetic::testSignedLongMultiplication);
+    TEST_ADD(TestArithmetic::testUnsignedLongMultiplication);
+    TEST_ADD(TestArithmetic::testUnsignedLongSmallMultiplication);
 
     TEST_ADD(TestArithmetic::testSignedIntDivision);
     TEST_ADD(TestArithmetic::testSignedShortDivision);
@@ -289,6 +308,8 @@ TestArithmetic::TestArithmetic(const vc4c::Configuration& config) : config(confi
     TEST_ADD(TestArithmetic::testUnsignedCharBitShiftLeft);
     TEST_ADD(TestArithmetic::testSignedLongBitShiftLeft);
     TEST_ADD(TestArithmetic::testUnsignedLongBitShiftLeft);
+    TEST_ADD(TestArithmetic::testSignedLongConstantShiftLeft);
+    TEST_ADD(TestArithmetic::testUnsignedLongConstantShiftLeft);
 
     TEST_ADD(TestArithmetic::testSignedIntBitShiftRight);
     TEST_ADD(TestArithmetic::testUnsignedIntBitShiftRight);
@@ -298,6 +319,8 @@ TestArithmetic::TestArithmetic(const vc4c::Configuration& config) : config(confi
     TEST_ADD(TestArithmetic::testUnsignedCharBitShiftRight);
     TEST_ADD(TestArithmetic::testSignedLongBitShiftRight);
     TEST_ADD(TestArithmetic::testUnsignedLongBitShiftRight);
+    TEST_ADD(TestArithmetic::testSignedLongConstantShiftRight);
+    TEST_ADD(TestArithmetic::testUnsignedLongConstantShiftRight);
 
     TEST_ADD(TestArithmetic::testSignedIntTrinaryScalar);
     TEST_ADD(TestArithmetic::testSignedIntTrinaryVector);
@@ -355,6 +378,41 @@ static void testBinaryOperation(vc4c::Configuration& config, const std::string&
         in0, in1, out, op, options.substr(pos, options.find(' ', pos) - pos), onError);
 }
 
+template <typename T>
+static void testConstantOperation(vc4c::Configuration& config, const std::string& options,
+    const std::function<T(T)>& op, const std::function<void(const std::string&, const std::string&)>& onError)
+{
+    std::stringstream code;
+    compileBuffer(config, code, CONSTANT_OPERATION, options);
+
+    auto in = generateInput<T, 16 * 12>(true);
+
+    auto out = runEmulation<T, T, 16, 12>(code, {in});
+    auto pos = options.find("-DOP=") + std::string("-DOP=").size();
+    auto constantPos = options.find("-DCONSTANT=") + std::string("-DCONSTANT=").size();
+    checkUnaryResults<T, T>(in, out, op,
+        options.substr(pos, options.find(' ', pos) - pos) +
+            options.substr(constantPos, options.find(' ', constantPos) - constantPos),
+        onError);
+}
+
+template <typename Result, typename Input>
+static void testConvertedBinaryOperation(vc4c::Configuration& config, const std::string& options,
+    const std::function<Result(Input, Input)>& op,
+    const std::function<void(const std::string&, const std::string&)>& onError)
+{
+    std::stringstream code;
+    compileBuffer(config, code, CONVERTED_BINARY_OPERATION, options);
+
+    auto in0 = generateInput<Input, 16 * 12>(true);
+    auto in1 = generateInput<Input, 16 * 12>(true);
+
+    auto out = runEmulation<Input, Result, 16, 12>(code, {in0, in1});
+    auto pos = options.find("-DOP=") + std::string("-DOP=").size();
+    checkBinaryResults<Result, Input, 16 * 12>(
+        in0, in1, out, op, options.substr(pos, options.find(' ', pos) - pos), onError);
+}
+
 template <typename T, std::size_t N, typename Comparison = CompareEqual<T>>
 static void testTernaryOperator(vc4c::Configuration& config, const std::string& options,
     const std::function<T(T, T)>& op, const std::function<void(const std::string&, const std::string&)>& onError)
@@ -682,6 +740,20 @@ void TestArithmetic::testUnsignedLongSubtraction()
         std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
 }
 
+void TestArithmetic::testSignedLongConstantSubtraction()
+{
+    testConstantOperation<int64_t>(
+        config, "-DTYPE=long16 -DOP=- -DCONSTANT=5L", [](int64_t i) -> int64_t { return i - 5; },
+        std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
+}
+
+void TestArithmetic::testUnsignedLongConstantSubtraction()
+{
+    testConstantOperation<uint64_t>(
+        config, "-DTYPE=ulong16 -DOP=- -DCONSTANT=5UL", [](uint64_t i) -> uint64_t { return i - 5; },
+        std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
+}
+
 void TestArithmetic::testSignedIntMultiplication()
 {
     testBinaryOperation<int>(config, "-DTYPE=int16 -DOP=*", std::multiplies<int>{},
@@ -724,6 +796,27 @@ void TestArithmetic::testFloatingPointMultiplication()
         std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
 }
 
+void TestArithmetic::testSignedLongMultiplication()
+{
+    testBinaryOperation<int64_t>(config, "-DTYPE=long16 -DOP=*", std::multiplies<int64_t>{},
+        std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
+}
+
+void TestArithmetic::testUnsignedLongMultiplication()
+{
+    testBinaryOperation<uint64_t>(config, "-DTYPE=ulong16 -DOP=*", std::multiplies<uint64_t>{},
+        std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
+}
+
+void TestArithmetic::testUnsignedLongSmallMultiplication()
+{
+    // the value range of the zero-extended operands allows to calculate the product with a single mul24
+    testConvertedBinaryOperation<uint64_t, uint16_t>(config,
+        "-DIN=ushort16 -DOUT=ulong16 -DCONVERT=convert_ulong16 -DOP=*",
+        [](uint16_t a, uint16_t b) -> uint64_t { return static_cast<uint64_t>(a) * b; },
+        std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
+}
+
 void TestArithmetic::testSignedIntDivision()
 {
     testBinaryOperation<int>(config, "-DTYPE=int16 -DOP=/", std::divides<int>{},
@@ -1637,6 +1730,21 @@ void TestArithmetic::testUnsignedLongBitShiftLeft()
         std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
 }
 
+void TestArithmetic::testSignedLongConstantShiftLeft()
+{
+    testConstantOperation<int64_t>(
+        config, "-DTYPE=long16 -DOP=<< -DCONSTANT=40",
+        [](int64_t i) -> int64_t { return vc4c::bit_cast<uint64_t, int64_t>(static_cast<uint64_t>(i) << 40); },
+        std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
+}
+
+void TestArithmetic::testUnsignedLongConstantShiftLeft()
+{
+    testConstantOperation<uint64_t>(
+        config, "-DTYPE=ulong16 -DOP=<< -DCONSTANT=40", [](uint64_t i) -> uint64_t { return i << 40; },
+        std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
+}
+
 void TestArithmetic::testSignedIntBitShiftRight()
 {
     testBinaryOperation<int>(config, "-DTYPE=int16 -DOP=>>", checkShiftRight<int>,
@@ -1678,6 +1786,27 @@ void TestArithmetic::testUnsignedLongBitShiftRight()
         std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
 }
 
+void TestArithmetic::testSignedLongConstantShiftRight()
+{
+    // offsets below 32 combine bits of both words, offsets of 32 and above only read the upper word
+    testConstantOperation<int64_t>(
+        config, "-DTYPE=long16 -DOP=>> -DCONSTANT=7", [](int64_t i) -> int64_t { return i >> 7; },
+        std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
+    testConstantOperation<int64_t>(
+        config, "-DTYPE=long16 -DOP=>> -DCONSTANT=32", [](int64_t i) -> int64_t { return i >> 32; },
+        std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
+}
+
+void TestArithmetic::testUnsignedLongConstantShiftRight()
+{
+    testConstantOperation<uint64_t>(
+        config, "-DTYPE=ulong16 -DOP=>> -DCONSTANT=7", [](uint64_t i) -> uint64_t { return i >> 7; },
+        std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
+    testConstantOperation<uint64_t>(
+        config, "-DTYPE=ulong16 -DOP=>> -DCONSTANT=32", [](uint64_t i) -> uint64_t { return i >> 32; },
+        std::bind(&TestArithmetic::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
+}
+
 void TestArithmetic::testSignedIntTrinaryScalar()
 {
     testTernaryOperator<int, 1>(config, "-DTYPE=int -DOP=<", checkTrinaryScalar<int>,
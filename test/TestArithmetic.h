@@ -57,6 +57,8 @@ public:
     void testFloatSubtraction();
     void testSignedLongSubtraction();
     void testUnsignedLongSubtraction();
+    void testSignedLongConstantSubtraction();
+    void testUnsignedLongConstantSubtraction();
 
     void testSignedIntMultiplication();
     void testSignedShortMultiplication();
@@ -65,7 +67,9 @@ public:
     void testUnsignedShortMultiplication();
     void testUnsignedCharMultiplication();
     void testFloatingPointMultiplication();
-    // TODO (u)long
+    void testSignedLongMultiplication();
+    void testUnsignedLongMultiplication();
+    void testUnsignedLongSmallMultiplication();
 
     void testSignedIntDivision();
     void testSignedShortDivision();
@@ -259,6 +263,8 @@ public:
     // section 6.3.j
     void testSignedLongBitShiftLeft();
     void testUnsignedLongBitShiftLeft();
+    void testSignedLongConstantShiftLeft();
+    void testUnsignedLongConstantShiftLeft();
 
     void testSignedIntBitShiftRight();
     void testUnsignedIntBitShiftRight();
@@ -270,6 +276,8 @@ public:
     // section 6.3.j
     void testSignedLongBitShiftRight();
     void testUnsignedLongBitShiftRight();
+    void testSignedLongConstantShiftRight();
+    void testUnsignedLongConstantShiftRight();
 
     void testSignedIntTrinaryScalar();
     void testSignedIntTrinaryVector();
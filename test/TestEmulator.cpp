@@ -8,13 +8,16 @@
 
 #include "../src/Profiler.h"
 #include "Compiler.h"
+#include "GlobalValues.h"
 #include "Locals.h"
+#include "asm/BranchInstruction.h"
 #include "asm/Instruction.h"
 #include "asm/KernelInfo.h"
 #include "helper.h"
 
 #include "test_cases.h"
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <sstream>
@@ -29,10 +32,15 @@
 using namespace vc4c;
 using namespace vc4c::tools;
 
+extern void extractBinary(std::istream& binary, qpu_asm::ModuleInfo& moduleInfo, StableList<Global>& globals,
+    std::vector<qpu_asm::Instruction>& instructions);
+
 TestEmulator::TestEmulator(const vc4c::Configuration& config) : config(config), cachePrecompilation(false)
 {
     TEST_ADD(TestEmulator::testHelloWorld);
     TEST_ADD(TestEmulator::testHelloWorldVector);
+    TEST_ADD(TestEmulator::testMultiThreading);
+    TEST_ADD(TestEmulator::testVPMCache);
     TEST_ADD(TestEmulator::testPrime);
     TEST_ADD(TestEmulator::testBarrier);
     TEST_ADD(TestEmulator::testBranches);
@@ -102,6 +110,7 @@ void TestEmulator::testHelloWorld()
 
     const auto result = emulate(data);
     TEST_ASSERT(result.executionSuccessful)
+    TEST_ASSERT(result.numCycles > 0)
     TEST_ASSERT_EQUALS(1u, result.results.size())
 
     const auto& out = *result.results.front().second;
@@ -142,6 +151,99 @@ void TestEmulator::testHelloWorldVector()
     TEST_ASSERT_EQUALS(0, strncmp("Hello World!", reinterpret_cast<const char*>(out.data()), 16))
 }
 
+void TestEmulator::testMultiThreading()
+{
+    std::stringstream buffer;
+    const bool previousMode = config.useMultiThreading;
+    config.useMultiThreading = true;
+    compileFile(buffer, "./example/hello_world_vector.cl", "", cachePrecompilation);
+    config.useMultiThreading = previousMode;
+
+    EmulationData data;
+    data.kernelName = "hello_world";
+    data.maxEmulationCycles = vc4c::test::maxExecutionCycles;
+    data.module = std::make_pair("", &buffer);
+    // 16 characters input
+    data.parameter.emplace_back(0u, std::vector<uint32_t>(16 / sizeof(uint32_t)));
+    memcpy(data.parameter[0].second->data(), "Hello World!", strlen("Hello World!"));
+    // 16 characters output
+    data.parameter.emplace_back(0u, std::vector<uint32_t>(16 / sizeof(uint32_t)));
+
+    const auto result = emulate(data);
+    TEST_ASSERT(result.executionSuccessful)
+    TEST_ASSERT_EQUALS(2u, result.results.size())
+
+    const auto& out = *result.results.back().second;
+    TEST_ASSERT_EQUALS(0, strncmp("Hello World!", reinterpret_cast<const char*>(out.data()), 16))
+}
+
+/*
+ * Counts the number of DMA loads and stores executed by the given emulation of the given (single kernel) binary
+ */
+static unsigned countExecutedDMAAccesses(const std::string& binary, const EmulationResult& result)
+{
+    std::stringstream ss(binary);
+    qpu_asm::ModuleInfo module;
+    StableList<Global> globals;
+    std::vector<qpu_asm::Instruction> instructions;
+    extractBinary(ss, module, globals, instructions);
+
+    unsigned numAccesses = 0;
+    for(std::size_t i = 0; i < std::min(instructions.size(), result.instrumentation.size()); ++i)
+    {
+        const auto& inst = instructions[i];
+        const auto isDMAAddress = [](Register reg) -> bool {
+            return reg == REG_VPM_DMA_LOAD_ADDR || reg == REG_VPM_DMA_STORE_ADDR;
+        };
+        if(inst.as<qpu_asm::BranchInstruction>())
+            continue;
+        if(isDMAAddress(inst.getAddOutput()) || isDMAAddress(inst.getMulOutput()))
+            numAccesses += result.instrumentation[i].numExecutions;
+    }
+    return numAccesses;
+}
+
+void TestEmulator::testVPMCache()
+{
+    std::stringstream buffer;
+    std::stringstream uncachedBuffer;
+    const bool previousMode = config.cacheMemoryInVPM;
+    config.cacheMemoryInVPM = true;
+    compileFile(buffer, "./testing/test_vpm_cache.cl", "", cachePrecompilation);
+    config.cacheMemoryInVPM = false;
+    compileFile(uncachedBuffer, "./testing/test_vpm_cache.cl", "", cachePrecompilation);
+    config.cacheMemoryInVPM = previousMode;
+    const auto binary = buffer.str();
+    const auto uncachedBinary = uncachedBuffer.str();
+
+    EmulationData data;
+    data.kernelName = "test_vpm_cache";
+    data.maxEmulationCycles = vc4c::test::maxExecutionCycles;
+    data.module = std::make_pair("", &buffer);
+    data.parameter.emplace_back(0u, std::vector<uint32_t>{1, 2, 3, 4});
+    data.parameter.emplace_back(0u, std::vector<uint32_t>(8));
+    data.parameter.emplace_back(0u, std::vector<uint32_t>(1));
+
+    const auto result = emulate(data);
+    TEST_ASSERT(result.executionSuccessful)
+    TEST_ASSERT_EQUALS(3u, result.results.size())
+
+    const auto& out = *result.results.at(1).second;
+    TEST_ASSERT_EQUALS(0u, out[3])
+    TEST_ASSERT_EQUALS(2u, out[4])
+    TEST_ASSERT_EQUALS(5u, out[5])
+    TEST_ASSERT_EQUALS(8u, out[6])
+    TEST_ASSERT_EQUALS(11u, out[7])
+    TEST_ASSERT_EQUALS(26u, result.results.at(2).second->at(0))
+
+    // make sure the loops are actually cached, i.e. the memory is accessed with fewer DMA operations
+    data.module = std::make_pair("", &uncachedBuffer);
+    const auto uncachedResult = emulate(data);
+    TEST_ASSERT(uncachedResult.executionSuccessful)
+    TEST_ASSERT_EQUALS(26u, uncachedResult.results.at(2).second->at(0))
+    TEST_ASSERT(countExecutedDMAAccesses(binary, result) < countExecutedDMAAccesses(uncachedBinary, uncachedResult))
+}
+
 void TestEmulator::testPrime()
 {
     std::stringstream buffer;
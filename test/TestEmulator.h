@@ -32,6 +32,8 @@ public:
 
     void testHelloWorld();
     void testHelloWorldVector();
+    void testMultiThreading();
+    void testVPMCache();
     void testPrime();
     void testBarrier();
     void testBranches();
@@ -10,6 +10,7 @@
 #include "GlobalValues.h"
 #include "HalfType.h"
 #include "Module.h"
+#include "Symbol.h"
 #include "Values.h"
 #include "analysis/ValueRange.h"
 #include "asm/ALUInstruction.h"
@@ -48,6 +49,7 @@ TestInstructions::TestInstructions()
     TEST_ADD(TestInstructions::testLoadInstruction);
     TEST_ADD(TestInstructions::testValueRanges);
     TEST_ADD(TestInstructions::testInstructionEquality);
+    TEST_ADD(TestInstructions::testSymbols);
 }
 
 // out-of-line virtual destructor
@@ -1551,6 +1553,73 @@ void TestInstructions::testCompoundConstants()
         SIMDVector vec({Literal(42), Literal(42), Literal(42), Literal(42), Literal(42)});
         TEST_ASSERT_EQUALS(Value(&vec, TYPE_INT16.toVectorType(5)), constant.toValue())
     }
+
+    // flat array
+    {
+        DataType type(GLOBAL_TYPE_HOLDER.createArrayType(TYPE_INT16, 3));
+        TEST_ASSERT(CompoundConstant::isFlatStorageSupported(type))
+        CompoundConstant constant{type,
+            {CompoundConstant{TYPE_INT16, Literal(17u)}, CompoundConstant{TYPE_INT16, Literal(0x1234u)},
+                CompoundConstant{TYPE_INT16, Literal(17u)}}};
+        TEST_ASSERT(constant.getFlatData() != nullptr)
+        TEST_ASSERT_EQUALS(6u, constant.getFlatData()->size())
+        TEST_ASSERT_EQUALS(0x34u, constant.getFlatData()->at(2))
+        TEST_ASSERT_EQUALS(0x12u, constant.getFlatData()->at(3))
+        TEST_ASSERT(!constant.isAllSame())
+        TEST_ASSERT(!constant.isUndefined())
+        TEST_ASSERT(!constant.isZeroInitializer())
+        TEST_ASSERT_EQUALS(3u, constant.getCompound()->size())
+        TEST_ASSERT_EQUALS(Literal(0x1234u), constant.getElement(1)->getScalar())
+        TEST_ASSERT(!constant.getElement(3))
+
+        CompoundConstant raw{type, std::vector<uint8_t>{0, 0, 0, 0, 0, 0}};
+        TEST_ASSERT(raw.isAllSame())
+        TEST_ASSERT(raw.isZeroInitializer())
+        TEST_THROWS(CompoundConstant(type, std::vector<uint8_t>{0, 0}), CompilationError)
+
+        // sub-word values with the MSB set are restored the way they were extended
+        CompoundConstant negative{type,
+            {CompoundConstant{TYPE_INT16, Literal(-1)}, CompoundConstant{TYPE_INT16, Literal(1u)},
+                CompoundConstant{TYPE_INT16, Literal(-32768)}}};
+        TEST_ASSERT(negative.getFlatData() != nullptr)
+        TEST_ASSERT_EQUALS(0xFFu, negative.getFlatData()->at(1))
+        TEST_ASSERT_EQUALS(Literal(-1), negative.getElement(0)->getScalar())
+        TEST_ASSERT_EQUALS(Literal(1u), negative.getElement(1)->getScalar())
+        TEST_ASSERT_EQUALS(Literal(-32768), negative.getElement(2)->getScalar())
+
+        CompoundConstant unsignedValues{type,
+            {CompoundConstant{TYPE_INT16, Literal(0xFFFFu)}, CompoundConstant{TYPE_INT16, Literal(1u)},
+                CompoundConstant{TYPE_INT16, Literal(0x8000u)}}};
+        TEST_ASSERT(unsignedValues.getFlatData() != nullptr)
+        TEST_ASSERT_EQUALS(Literal(0xFFFFu), unsignedValues.getElement(0)->getScalar())
+        TEST_ASSERT_EQUALS(Literal(0x8000u), unsignedValues.getElement(2)->getScalar())
+
+        CompoundConstant rawSigned{type, std::vector<uint8_t>{0x80, 0x00, 0xFF, 0x7F, 0x00, 0x80}, true};
+        TEST_ASSERT_EQUALS(Literal(0x80u), rawSigned.getElement(0)->getScalar())
+        TEST_ASSERT_EQUALS(Literal(0x7FFFu), rawSigned.getElement(1)->getScalar())
+        TEST_ASSERT_EQUALS(Literal(-32768), rawSigned.getElement(2)->getScalar())
+
+        // values which are neither zero- nor sign-extended or mixed extensions can't be restored
+        CompoundConstant mixed{type,
+            {CompoundConstant{TYPE_INT16, Literal(-1)}, CompoundConstant{TYPE_INT16, Literal(0x8000u)},
+                CompoundConstant{TYPE_INT16, Literal(2u)}}};
+        TEST_ASSERT(mixed.getFlatData() == nullptr)
+        TEST_ASSERT_EQUALS(Literal(0x8000u), mixed.getElement(1)->getScalar())
+        CompoundConstant truncated{type,
+            {CompoundConstant{TYPE_INT16, Literal(0x10000u)}, CompoundConstant{TYPE_INT16, Literal(1u)},
+                CompoundConstant{TYPE_INT16, Literal(2u)}}};
+        TEST_ASSERT(truncated.getFlatData() == nullptr)
+
+        DataType floatType(GLOBAL_TYPE_HOLDER.createArrayType(TYPE_FLOAT.toVectorType(2), 1));
+        CompoundConstant floats{floatType,
+            {CompoundConstant{TYPE_FLOAT.toVectorType(2),
+                {CompoundConstant{TYPE_FLOAT, Literal(1.5f)}, CompoundConstant{TYPE_FLOAT, Literal(-2.0f)}}}}};
+        TEST_ASSERT(floats.getFlatData() != nullptr)
+        TEST_ASSERT_EQUALS(Literal(-2.0f), floats.getElement(0)->getElement(1)->getScalar())
+        TEST_ASSERT(!CompoundConstant::isFlatStorageSupported(TYPE_INT32.toVectorType(4)))
+        TEST_ASSERT(!CompoundConstant::isFlatStorageSupported(
+            DataType(GLOBAL_TYPE_HOLDER.createArrayType(TYPE_INT32.toVectorType(3), 4))))
+    }
 }
 
 void TestInstructions::testALUInstructions()
@@ -1934,3 +2003,35 @@ void TestInstructions::testInstructionEquality()
         TEST_ASSERT_EQUALS(inst, *op2)
     }
 }
+
+void TestInstructions::testSymbols()
+{
+    Symbol empty;
+    TEST_ASSERT(empty.empty())
+    TEST_ASSERT_EQUALS(empty, Symbol{""})
+
+    Symbol foo{"foo"};
+    Symbol bar{std::string{"bar"}};
+    TEST_ASSERT(!foo.empty())
+    TEST_ASSERT(foo != bar)
+    TEST_ASSERT_EQUALS(foo, Symbol{std::string{"foo"}})
+    TEST_ASSERT_EQUALS(foo.getID(), Symbol{"foo"}.getID())
+    TEST_ASSERT(foo.getID() != bar.getID())
+    TEST_ASSERT_EQUALS(std::string{"foo"}, foo.to_string())
+    TEST_ASSERT(foo == "foo")
+    TEST_ASSERT(foo != "bar")
+    TEST_ASSERT(std::string{"bar"} == bar)
+
+    // symbols are interned, so the underlying strings are shared
+    TEST_ASSERT(&foo.to_string() == &Symbol{"foo"}.to_string())
+
+    TEST_ASSERT_EQUALS(OP_FADD, OpCode::findOpCode(Symbol{"fadd"}))
+    TEST_ASSERT_EQUALS(OP_NOP, OpCode::findOpCode(Symbol{"udiv"}))
+    TEST_ASSERT_EQUALS(OP_MUL24, OpCode::toOpCode(Symbol{"mul24"}))
+    TEST_THROWS(OpCode::toOpCode(Symbol{"udiv"}), CompilationError)
+
+    intermediate::MethodCall call("foo");
+    TEST_ASSERT_EQUALS(foo, call.methodName)
+    call.methodName = "bar";
+    TEST_ASSERT_EQUALS(bar, call.methodName)
+}
@@ -42,6 +42,7 @@ public:
     void testValueRanges();
     
     void testInstructionEquality();
+    void testSymbols();
 };
 
 #endif /* TEST_INSTRUCTIONS_H */
@@ -99,6 +99,8 @@ TestMemoryAccess::TestMemoryAccess(const Configuration& config) : TestEmulator(f
 
     TEST_ADD(TestMemoryAccess::testVPMWrites);
     TEST_ADD(TestMemoryAccess::testVPMReads);
+    TEST_ADD(TestMemoryAccess::testCombinedStridedVPMWrites);
+    TEST_ADD(TestMemoryAccess::testRewrittenIndexVPMWrites);
 
     TEST_ADD(TestMemoryAccess::testVectorLoadStoreCharPrivate);
     TEST_ADD(TestMemoryAccess::testVectorLoadStoreCharLocal);
@@ -387,6 +389,76 @@ void TestMemoryAccess::testVPMReads()
     }
 }
 
+void TestMemoryAccess::testCombinedStridedVPMWrites()
+{
+    // the unrolled writes are merged into a single block and then combined with a stride of 2 vectors
+    config.additionalEnabledOptimizations = {"unroll-loops", "merge-blocks", "combine-dma"};
+    std::stringstream buffer;
+    compileFile(buffer, "./testing/test_vpm_write.cl");
+    config.additionalEnabledOptimizations.clear();
+
+    EmulationData data;
+    data.kernelName = "test_vpm_write_strided";
+    data.maxEmulationCycles = vc4c::test::maxExecutionCycles;
+    data.module = std::make_pair("", &buffer);
+
+    // parameter 0 is input
+    data.parameter.emplace_back(0, vc4c::test::toRange<uint32_t>(0, 16));
+    // parameter 1 is output
+    data.parameter.emplace_back(0, std::vector<uint32_t>(20 * 16));
+    // parameter 2 is the offset (in vectors)
+    data.parameter.emplace_back(vc4c::test::toScalarParameter(3));
+
+    const auto result = emulate(data);
+    TEST_ASSERT(result.executionSuccessful)
+    TEST_ASSERT_EQUALS(3u, result.results.size())
+
+    auto& res = result.results[1].second.value();
+    for(unsigned i = 0; i < 20; ++i)
+    {
+        bool isWritten = i >= 3 && (i - 3) % 2 == 0 && (i - 3) / 2 < 8;
+        for(unsigned k = 0; k < 16; ++k)
+            TEST_ASSERT_EQUALS(isWritten ? k + (i - 3) / 2 : 0u, res.at(i * 16 + k))
+    }
+}
+
+void TestMemoryAccess::testRewrittenIndexVPMWrites()
+{
+    // the index is re-written in the unrolled block, which must not be confused with its value at the block entry
+    config.additionalEnabledOptimizations = {"unroll-loops", "merge-blocks", "combine-dma"};
+    std::stringstream buffer;
+    compileFile(buffer, "./testing/test_vpm_write.cl");
+    config.additionalEnabledOptimizations.clear();
+
+    EmulationData data;
+    data.kernelName = "test_vpm_write_rewritten";
+    data.maxEmulationCycles = vc4c::test::maxExecutionCycles;
+    data.module = std::make_pair("", &buffer);
+
+    // parameter 0 is input
+    data.parameter.emplace_back(0, vc4c::test::toRange<uint32_t>(0, 16));
+    // parameter 1 is output
+    data.parameter.emplace_back(0, std::vector<uint32_t>(16 * 16));
+    // parameter 2 is the start index
+    data.parameter.emplace_back(vc4c::test::toScalarParameter(1));
+
+    const auto result = emulate(data);
+    TEST_ASSERT(result.executionSuccessful)
+    TEST_ASSERT_EQUALS(3u, result.results.size())
+
+    auto& res = result.results[1].second.value();
+    std::vector<uint32_t> expected(16 * 16);
+    unsigned index = 1;
+    for(unsigned i = 0; i < 8; ++i)
+    {
+        for(unsigned k = 0; k < 16; ++k)
+            expected[index * 16 + k] = k + i;
+        index = (index * 5 + 3) % 16;
+    }
+    for(unsigned i = 0; i < expected.size(); ++i)
+        TEST_ASSERT_EQUALS(expected[i], res.at(i))
+}
+
 void TestMemoryAccess::testVectorLoadStoreCharPrivate()
 {
     testPrivateLocalFunction<char>(config, "-DTYPE=char -DSTORAGE=__private",
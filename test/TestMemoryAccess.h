@@ -23,6 +23,8 @@ public:
 
     void testVPMWrites();
     void testVPMReads();
+    void testCombinedStridedVPMWrites();
+    void testRewrittenIndexVPMWrites();
 
     // general vload/vstore tests are in TestVectorFunctions, this is to test optimizations (lowering into register/VPM)
     void testVectorLoadStoreCharPrivate();
@@ -10,8 +10,12 @@
 #include "Module.h"
 #include "intermediate/operators.h"
 #include "optimization/Combiner.h"
+#include "optimization/ControlFlow.h"
 #include "optimization/Eliminator.h"
 #include "optimization/Flags.h"
+#include "optimization/InstructionScheduler.h"
+#include "optimization/Reordering.h"
+#include "periphery/TMU.h"
 
 #include <cmath>
 
@@ -32,6 +36,17 @@ TestOptimizationSteps::TestOptimizationSteps()
     TEST_ADD(TestOptimizationSteps::testCombineConstantLoads);
     TEST_ADD(TestOptimizationSteps::testEliminateBitOperations);
     TEST_ADD(TestOptimizationSteps::testCombineRotations);
+    TEST_ADD(TestOptimizationSteps::testGlobalValueNumbering);
+    TEST_ADD(TestOptimizationSteps::testFillBranchDelaySlots);
+    TEST_ADD(TestOptimizationSteps::testCacheWorkGroupUniforms);
+    TEST_ADD(TestOptimizationSteps::testMoveLoopInvariantCode);
+    TEST_ADD(TestOptimizationSteps::testReduceInductionVariableStrength);
+    TEST_ADD(TestOptimizationSteps::testScheduleSuperblocks);
+    TEST_ADD(TestOptimizationSteps::testPairInstructions);
+    TEST_ADD(TestOptimizationSteps::testSchedulerRegisterPressure);
+    TEST_ADD(TestOptimizationSteps::testReorderNeverExecutedBlocks);
+    TEST_ADD(TestOptimizationSteps::testPipelineTMULoads);
+    TEST_ADD(TestOptimizationSteps::testThreadSwitches);
 }
 
 static bool checkEquals(
@@ -1763,3 +1778,1073 @@ void TestOptimizationSteps::testCombineRotations()
 
     testMethodsEquals(inputMethod, outputMethod);
 }
+
+void TestOptimizationSteps::testGlobalValueNumbering()
+{
+    using namespace vc4c::intermediate;
+    Configuration config{};
+    Module module{config};
+    Method method(module);
+
+    auto& entryBlock = method.createAndInsertNewBlock(method.end(), "%entry");
+    auto& thenBlock = method.createAndInsertNewBlock(method.end(), "%then");
+    auto& elseBlock = method.createAndInsertNewBlock(method.end(), "%else");
+    auto& endBlock = method.createAndInsertNewBlock(method.end(), "%end");
+
+    auto p = method.addNewLocal(TYPE_INT32, "%p");
+    auto q = method.addNewLocal(TYPE_INT32, "%q");
+    auto a = method.addNewLocal(TYPE_INT32, "%a");
+    auto x = method.addNewLocal(TYPE_INT32, "%x");
+    auto b = method.addNewLocal(TYPE_INT32, "%b");
+    auto c = method.addNewLocal(TYPE_INT32, "%c");
+    auto f = method.addNewLocal(TYPE_INT32, "%f");
+    auto d = method.addNewLocal(TYPE_INT32, "%d");
+    auto g = method.addNewLocal(TYPE_INT32, "%g");
+
+    {
+        auto it = entryBlock.walkEnd();
+        assign(it, p) = UNIFORM_REGISTER;
+        assign(it, q) = UNIFORM_REGISTER;
+        assign(it, a) = p + q;
+        assign(it, x) = a + 1_val;
+        it.emplace(new Branch(elseBlock.getLabel()->getLabel(), COND_ZERO_CLEAR, UNIFORM_REGISTER));
+        it.nextInBlock();
+    }
+    {
+        auto it = thenBlock.walkEnd();
+        // calculates the same as %a and %x in the dominating %entry block
+        assign(it, b) = p + q;
+        assign(it, c) = b + 1_val;
+        assign(it, f) = p ^ q;
+        assign(it, UNIFORM_REGISTER) = c;
+        assign(it, UNIFORM_REGISTER) = f;
+        it.emplace(new Branch(endBlock.getLabel()->getLabel(), COND_ALWAYS, BOOL_TRUE));
+        it.nextInBlock();
+    }
+    {
+        auto it = elseBlock.walkEnd();
+        // same as %a with swapped arguments
+        assign(it, d) = q + p;
+        assign(it, UNIFORM_REGISTER) = d;
+    }
+    {
+        auto it = endBlock.walkEnd();
+        // %then does not dominate %end, so %f is not available here
+        assign(it, g) = p ^ q;
+        assign(it, UNIFORM_REGISTER) = g;
+    }
+
+    TEST_ASSERT(eliminateCommonSubexpressionsGlobally(module, method, config))
+
+    auto move = dynamic_cast<const MoveOperation*>(b.getSingleWriter());
+    TEST_ASSERT(move != nullptr && move->getSource() == a)
+    move = dynamic_cast<const MoveOperation*>(c.getSingleWriter());
+    TEST_ASSERT(move != nullptr && move->getSource() == x)
+    move = dynamic_cast<const MoveOperation*>(d.getSingleWriter());
+    TEST_ASSERT(move != nullptr && move->getSource() == a)
+    auto op = dynamic_cast<const Operation*>(g.getSingleWriter());
+    TEST_ASSERT(op != nullptr && op->op == OP_XOR)
+}
+
+static std::size_t findPositionInBlock(vc4c::BasicBlock& block, const vc4c::intermediate::IntermediateInstruction* inst)
+{
+    std::size_t index = 0;
+    for(auto it = block.walk(); !it.isEndOfBlock(); it.nextInBlock(), ++index)
+    {
+        if(it.get() == inst)
+            return index;
+    }
+    return index;
+}
+
+void TestOptimizationSteps::testFillBranchDelaySlots()
+{
+    using namespace vc4c::intermediate;
+    Configuration config{};
+    Module module{config};
+    Method method(module);
+
+    auto& fillBlock = method.createAndInsertNewBlock(method.end(), "%fill");
+    auto& keepBlock = method.createAndInsertNewBlock(method.end(), "%keep");
+    auto& targetBlock = method.createAndInsertNewBlock(method.end(), "%target");
+
+    auto a = method.addNewLocal(TYPE_INT32, "%a");
+    auto b = method.addNewLocal(TYPE_INT32, "%b");
+    auto c = method.addNewLocal(TYPE_INT32, "%c");
+    auto d = method.addNewLocal(TYPE_INT32, "%d");
+    auto e = method.addNewLocal(TYPE_INT32, "%e");
+    auto f = method.addNewLocal(TYPE_INT32, "%f");
+    auto g = method.addNewLocal(TYPE_INT32, "%g");
+
+    const Branch* fillBranch = nullptr;
+    {
+        auto it = fillBlock.walkEnd();
+        assign(it, a) = UNIFORM_REGISTER;
+        assign(it, b) = UNIFORM_REGISTER;
+        // %d is read by the flag setter, so it stays in front of it
+        assign(it, d) = b - 1_val;
+        // %g retains the distance between writing %d and reading it in the flag setter
+        assign(it, g) = a - 1_val;
+        // %c is independent of the branch and can be moved into a delay slot behind the flag setter
+        assign(it, c) = a + b;
+        assignNop(it) = (d ^ 1_val, SetFlag::SET_FLAGS);
+        it.emplace(new Branch(targetBlock.getLabel()->getLabel(), COND_ZERO_CLEAR, BOOL_TRUE));
+        fillBranch = it.get<const Branch>();
+        it.nextInBlock();
+        for(unsigned i = 0; i < 3; ++i)
+        {
+            it.emplace(new Nop(DelayType::BRANCH_DELAY));
+            it.nextInBlock();
+        }
+    }
+    const Branch* keepBranch = nullptr;
+    {
+        auto it = keepBlock.walkEnd();
+        // the flag setter has an output, which could share a register with the input of %e
+        assign(it, e) = a - b;
+        assign(it, f) = (c ^ 1_val, SetFlag::SET_FLAGS);
+        it.emplace(new Branch(targetBlock.getLabel()->getLabel(), COND_ZERO_CLEAR, BOOL_TRUE));
+        keepBranch = it.get<const Branch>();
+        it.nextInBlock();
+        for(unsigned i = 0; i < 3; ++i)
+        {
+            it.emplace(new Nop(DelayType::BRANCH_DELAY));
+            it.nextInBlock();
+        }
+    }
+    {
+        auto it = targetBlock.walkEnd();
+        assign(it, UNIFORM_REGISTER) = c;
+        assign(it, UNIFORM_REGISTER) = d;
+        assign(it, UNIFORM_REGISTER) = e;
+        assign(it, UNIFORM_REGISTER) = f;
+        assign(it, UNIFORM_REGISTER) = g;
+    }
+
+    fillBranchDelaySlots(module, method, config);
+
+    // %c is moved into the first delay slot, %d and %g are kept in front of the flag setter
+    auto fillBranchPosition = findPositionInBlock(fillBlock, fillBranch);
+    TEST_ASSERT_EQUALS(fillBranchPosition + 1, findPositionInBlock(fillBlock, c.getSingleWriter()))
+    TEST_ASSERT(findPositionInBlock(fillBlock, d.getSingleWriter()) < fillBranchPosition)
+    TEST_ASSERT(findPositionInBlock(fillBlock, g.getSingleWriter()) < fillBranchPosition)
+    // %e is not moved behind the flag setter writing %f
+    TEST_ASSERT(findPositionInBlock(keepBlock, e.getSingleWriter()) < findPositionInBlock(keepBlock, keepBranch))
+    // the number of instructions is not changed, the moved instruction replaces the delay slot
+    TEST_ASSERT_EQUALS(10u, fillBlock.size())
+    TEST_ASSERT_EQUALS(7u, keepBlock.size())
+}
+
+struct WorkGroupLoopLocals
+{
+    const vc4c::Local* cachedUniform;
+    const vc4c::Local* loopUniform;
+    const vc4c::Local* maxGroupId;
+    const vc4c::Local* uniformAddress;
+};
+
+/*
+ * Creates the structure inserted by the work-group loop: a block executed once, the kernel code reading its UNIFORMs,
+ * the block resetting the UNIFORM pointer and reading the maximum group id and the block repeating the kernel code.
+ */
+static WorkGroupLoopLocals createWorkGroupLoop(vc4c::Method& method, bool readUniformInLoop)
+{
+    using namespace vc4c::intermediate;
+    auto& startBlock = method.createAndInsertNewBlock(method.end(), "%group_id_initializer");
+    startBlock.getLabel()->addDecorations(InstructionDecorations::WORK_GROUP_LOOP);
+    auto& headBlock = method.createAndInsertNewBlock(method.end(), "%head");
+    auto& resetBlock = method.createAndInsertNewBlock(method.end(), "%reset");
+    auto& repeatBlock = method.createAndInsertNewBlock(method.end(), "%repeat");
+    method.metaData.uniformsUsed.setUniformAddressUsed(true);
+
+    auto groupId = method.addNewLocal(TYPE_INT32, "%group_id");
+    auto maxGroupId = method.addNewLocal(TYPE_INT32, "%max_group_id");
+    auto address = method.addNewLocal(TYPE_INT32, "%address");
+    auto p = method.addNewLocal(TYPE_INT32, "%p");
+    auto q = method.addNewLocal(TYPE_INT32, "%q");
+    auto x = method.addNewLocal(TYPE_INT32, "%x");
+    auto r = method.addNewLocal(TYPE_INT32, "%r");
+
+    {
+        auto it = startBlock.walkEnd();
+        assign(it, groupId) = INT_ZERO;
+    }
+    {
+        auto it = headBlock.walkEnd();
+        assign(it, p) = UNIFORM_REGISTER;
+        assign(it, q) = UNIFORM_REGISTER;
+        // depends on the work-group, so this and all following instructions are kept in the loop
+        assign(it, x) = groupId + p;
+        if(readUniformInLoop)
+            assign(it, r) = UNIFORM_REGISTER;
+        assign(it, NOP_REGISTER) = x ^ q;
+    }
+    {
+        auto it = resetBlock.walkEnd();
+        assign(it, address) = UNIFORM_REGISTER;
+        assign(it, maxGroupId) = UNIFORM_REGISTER;
+        assign(it, Value(REG_UNIFORM_ADDRESS, TYPE_INT32)) = address;
+    }
+    {
+        auto it = repeatBlock.walkEnd();
+        assign(it, groupId) = groupId + INT_ONE;
+        assignNop(it) = (groupId ^ maxGroupId, SetFlag::SET_FLAGS);
+        it.emplace((new Branch(headBlock.getLabel()->getLabel(), COND_ZERO_CLEAR, BOOL_TRUE))
+                       ->addDecorations(InstructionDecorations::WORK_GROUP_LOOP));
+        it.nextInBlock();
+    }
+    return WorkGroupLoopLocals{p.local(), r.local(), maxGroupId.local(), address.local()};
+}
+
+static const vc4c::intermediate::IntermediateInstruction* findUniformAddressWrite(vc4c::Method& method)
+{
+    for(auto it = method.walkAllInstructions(); !it.isEndOfMethod(); it.nextInMethod())
+    {
+        if(it.has() && it->writesRegister(REG_UNIFORM_ADDRESS))
+            return it.get();
+    }
+    return nullptr;
+}
+
+void TestOptimizationSteps::testCacheWorkGroupUniforms()
+{
+    using namespace vc4c::intermediate;
+    Configuration config{};
+    Module module{config};
+
+    {
+        // some UNIFORMs are still read in the loop, so the UNIFORM pointer is reset to skip the ones read once
+        Method method(module);
+        auto locals = createWorkGroupLoop(method, true);
+
+        TEST_ASSERT(cacheWorkGroupUniforms(module, method, config))
+
+        auto& startBlock = *method.begin();
+        TEST_ASSERT(findPositionInBlock(startBlock, locals.cachedUniform->getSingleWriter()) < startBlock.size())
+        TEST_ASSERT_EQUALS(startBlock.size(), findPositionInBlock(startBlock, locals.loopUniform->getSingleWriter()))
+        TEST_ASSERT_EQUALS(startBlock.size(), findPositionInBlock(startBlock, locals.maxGroupId->getSingleWriter()))
+
+        // the 2 UNIFORMs read once are skipped
+        auto reset = dynamic_cast<const Operation*>(findUniformAddressWrite(method));
+        TEST_ASSERT(reset != nullptr)
+        TEST_ASSERT(reset && reset->op == OP_ADD && reset->getFirstArg().checkLocal() == locals.uniformAddress)
+        TEST_ASSERT(reset && reset->getSecondArg() && reset->getSecondArg()->getLiteralValue() == Literal(8u))
+        TEST_ASSERT(method.metaData.uniformsUsed.getUniformAddressUsed())
+    }
+
+    {
+        // all UNIFORMs are read once, so the UNIFORM pointer is neither reset nor passed to the kernel
+        Method method(module);
+        auto locals = createWorkGroupLoop(method, false);
+
+        TEST_ASSERT(cacheWorkGroupUniforms(module, method, config))
+
+        auto& startBlock = *method.begin();
+        TEST_ASSERT(findPositionInBlock(startBlock, locals.cachedUniform->getSingleWriter()) < startBlock.size())
+        TEST_ASSERT(findPositionInBlock(startBlock, locals.maxGroupId->getSingleWriter()) < startBlock.size())
+        TEST_ASSERT(findUniformAddressWrite(method) == nullptr)
+        TEST_ASSERT(locals.uniformAddress->getUsers().empty())
+        TEST_ASSERT(!method.metaData.uniformsUsed.getUniformAddressUsed())
+    }
+}
+
+void TestOptimizationSteps::testMoveLoopInvariantCode()
+{
+    using namespace vc4c::intermediate;
+    Configuration config{};
+    Module module{config};
+
+    {
+        // the address calculation from the parameters is moved into a newly inserted preheader, since the block in
+        // front of the loop can also skip the loop
+        Method method(module);
+        auto& entryBlock = method.createAndInsertNewBlock(method.end(), "%entry");
+        auto& loopBlock = method.createAndInsertNewBlock(method.end(), "%loop");
+        auto& endBlock = method.createAndInsertNewBlock(method.end(), "%end");
+
+        auto base = method.addNewLocal(TYPE_INT32, "%base");
+        auto n = method.addNewLocal(TYPE_INT32, "%n");
+        auto i = method.addNewLocal(TYPE_INT32, "%i");
+        auto offset = method.addNewLocal(TYPE_INT32, "%offset");
+        auto rowAddress = method.addNewLocal(TYPE_INT32, "%row_address");
+        auto elementOffset = method.addNewLocal(TYPE_INT32, "%element_offset");
+        auto address = method.addNewLocal(TYPE_INT32, "%address");
+
+        {
+            auto it = entryBlock.walkEnd();
+            assign(it, base) = UNIFORM_REGISTER;
+            assign(it, n) = UNIFORM_REGISTER;
+            assign(it, i) = INT_ZERO;
+            assignNop(it) = (n, SetFlag::SET_FLAGS);
+            it.emplace(new Branch(endBlock.getLabel()->getLabel(), COND_ZERO_SET, n));
+            it.nextInBlock();
+        }
+        {
+            auto it = loopBlock.walkEnd();
+            assign(it, offset) = n << 4_val;
+            assign(it, rowAddress) = base + offset;
+            assign(it, elementOffset) = i << 2_val;
+            assign(it, address) = rowAddress + elementOffset;
+            assign(it, UNIFORM_REGISTER) = address;
+            assign(it, i) = i + INT_ONE;
+            assignNop(it) = (i ^ n, SetFlag::SET_FLAGS);
+            it.emplace(new Branch(loopBlock.getLabel()->getLabel(), COND_ZERO_CLEAR, i));
+            it.nextInBlock();
+        }
+        {
+            auto it = endBlock.walkEnd();
+            assign(it, UNIFORM_REGISTER) = i;
+        }
+
+        TEST_ASSERT(moveLoopInvariantCode(module, method, config))
+
+        TEST_ASSERT_EQUALS(4u, method.size())
+        auto& preheader = *std::next(method.begin());
+        TEST_ASSERT(preheader.getLabel()->getLabel()->name.find("loop_preheader") != std::string::npos)
+        TEST_ASSERT(findPositionInBlock(preheader, offset.getSingleWriter()) < preheader.size())
+        TEST_ASSERT(findPositionInBlock(preheader, rowAddress.getSingleWriter()) < preheader.size())
+        TEST_ASSERT(findPositionInBlock(loopBlock, elementOffset.getSingleWriter()) < loopBlock.size())
+        TEST_ASSERT(findPositionInBlock(loopBlock, address.getSingleWriter()) < loopBlock.size())
+        // the branch skipping the loop is not redirected into the preheader
+        auto skipBranch = std::find_if(entryBlock.begin(), entryBlock.end(),
+            [](const std::unique_ptr<IntermediateInstruction>& inst) -> bool {
+                return dynamic_cast<const Branch*>(inst.get()) != nullptr;
+            });
+        TEST_ASSERT(skipBranch != entryBlock.end())
+        TEST_ASSERT(skipBranch != entryBlock.end() &&
+            dynamic_cast<const Branch*>(skipBranch->get())->getTarget() == endBlock.getLabel()->getLabel())
+    }
+
+    {
+        // every value moved out of the loop is live throughout the whole loop, so only as many values are moved as
+        // fit into the threshold
+        config.additionalOptions.maxLoopInvariantLocals = 2;
+        Method method(module);
+        auto& entryBlock = method.createAndInsertNewBlock(method.end(), "%entry");
+        auto& loopBlock = method.createAndInsertNewBlock(method.end(), "%loop");
+
+        auto n = method.addNewLocal(TYPE_INT32, "%n");
+        auto i = method.addNewLocal(TYPE_INT32, "%i");
+        auto x1 = method.addNewLocal(TYPE_INT32, "%x1");
+        auto x2 = method.addNewLocal(TYPE_INT32, "%x2");
+        auto x3 = method.addNewLocal(TYPE_INT32, "%x3");
+
+        {
+            auto it = entryBlock.walkEnd();
+            assign(it, n) = UNIFORM_REGISTER;
+            assign(it, i) = INT_ZERO;
+        }
+        {
+            auto it = loopBlock.walkEnd();
+            assign(it, x1) = n + 1_val;
+            assign(it, x2) = n + 2_val;
+            assign(it, x3) = n + 3_val;
+            assign(it, UNIFORM_REGISTER) = x1 + i;
+            assign(it, UNIFORM_REGISTER) = x2 + i;
+            assign(it, UNIFORM_REGISTER) = x3 + i;
+            assign(it, i) = i + INT_ONE;
+            assignNop(it) = (i ^ 16_val, SetFlag::SET_FLAGS);
+            it.emplace(new Branch(loopBlock.getLabel()->getLabel(), COND_ZERO_CLEAR, i));
+            it.nextInBlock();
+        }
+
+        TEST_ASSERT(moveLoopInvariantCode(module, method, config))
+
+        // the block in front of the loop only continues into the loop, so no preheader is inserted
+        TEST_ASSERT_EQUALS(2u, method.size())
+        // moving %x1 adds a second value live throughout the loop, moving %x2 too would exceed the threshold
+        TEST_ASSERT(findPositionInBlock(entryBlock, x1.getSingleWriter()) < entryBlock.size())
+        TEST_ASSERT(findPositionInBlock(loopBlock, x2.getSingleWriter()) < loopBlock.size())
+        TEST_ASSERT(findPositionInBlock(loopBlock, x3.getSingleWriter()) < loopBlock.size())
+    }
+}
+
+/*
+ * Creates a loop (with the phi-nodes as generated by the front-ends) writing "base + (i << 2)" to a UNIFORM in every
+ * iteration and returns the local of the written value
+ */
+static const vc4c::Local* createAddressLoop(vc4c::Method& method, vc4c::OpCode stepOperation, const vc4c::Value& step)
+{
+    using namespace vc4c::intermediate;
+    auto& entryBlock = method.createAndInsertNewBlock(method.end(), "%entry");
+    auto& loopBlock = method.createAndInsertNewBlock(method.end(), "%loop");
+
+    auto base = method.addNewLocal(TYPE_INT32, "%base");
+    auto i = method.addNewLocal(TYPE_INT32, "%i");
+    auto nextI = method.addNewLocal(TYPE_INT32, "%i.next");
+    auto offset = method.addNewLocal(TYPE_INT32, "%offset");
+    auto address = method.addNewLocal(TYPE_INT32, "%address");
+
+    {
+        auto it = entryBlock.walkEnd();
+        assign(it, base) = UNIFORM_REGISTER;
+        if(auto loc = step.checkLocal())
+            assign(it, loc->createReference()) = UNIFORM_REGISTER;
+        assign(it, i) = (16_val, InstructionDecorations::PHI_NODE);
+    }
+    {
+        auto it = loopBlock.walkEnd();
+        assign(it, offset) = i << 2_val;
+        assign(it, address) = base + offset;
+        assign(it, UNIFORM_REGISTER) = address;
+        it.emplace(new Operation(stepOperation, nextI, i, step));
+        it.nextInBlock();
+        assign(it, i) = (nextI, InstructionDecorations::PHI_NODE);
+        assignNop(it) = (nextI ^ 32_val, SetFlag::SET_FLAGS);
+        it.emplace(new Branch(loopBlock.getLabel()->getLabel(), COND_ZERO_CLEAR, nextI));
+        it.nextInBlock();
+    }
+    return address.local();
+}
+
+/*
+ * Returns the separate induction variable the value is copied from, if the calculation of the value was replaced
+ */
+static const vc4c::Local* getStrengthReducedSource(const vc4c::Local* value)
+{
+    auto move = dynamic_cast<const vc4c::intermediate::MoveOperation*>(value->getSingleWriter());
+    if(!move || !move->getSource().checkLocal() ||
+        move->getSource().local()->name.find("strength_reduced") == std::string::npos)
+        return nullptr;
+    return move->getSource().local();
+}
+
+/*
+ * Returns the value the separate induction variable is incremented with in every iteration
+ */
+static vc4c::Optional<vc4c::Literal> getStrengthReducedIncrement(const vc4c::Local* inductionVariable)
+{
+    vc4c::Optional<vc4c::Literal> increment;
+    inductionVariable->forUsers(vc4c::LocalUse::Type::WRITER, [&](const vc4c::LocalUser* writer) {
+        auto op = dynamic_cast<const vc4c::intermediate::Operation*>(writer);
+        if(op && op->op == vc4c::OP_ADD && op->getFirstArg().checkLocal() == inductionVariable && op->getSecondArg())
+            increment = op->getSecondArg()->getLiteralValue();
+    });
+    return increment;
+}
+
+void TestOptimizationSteps::testReduceInductionVariableStrength()
+{
+    using namespace vc4c::intermediate;
+    Configuration config{};
+    Module module{config};
+
+    {
+        // the address is calculated by adding 4 to its previous value in every iteration
+        Method method(module);
+        auto address = createAddressLoop(method, OP_ADD, 1_val);
+
+        TEST_ASSERT(reduceInductionVariableStrength(module, method, config))
+
+        auto inductionVariable = getStrengthReducedSource(address);
+        TEST_ASSERT(inductionVariable != nullptr)
+        TEST_ASSERT(inductionVariable && getStrengthReducedIncrement(inductionVariable) == Literal(4u))
+        // the initial value is calculated in front of the loop
+        TEST_ASSERT(inductionVariable && inductionVariable->getUsers(LocalUse::Type::WRITER).size() == 2)
+    }
+
+    {
+        // the address is decremented by 4 in every iteration
+        Method method(module);
+        auto address = createAddressLoop(method, OP_SUB, 1_val);
+
+        TEST_ASSERT(reduceInductionVariableStrength(module, method, config))
+
+        auto inductionVariable = getStrengthReducedSource(address);
+        TEST_ASSERT(inductionVariable != nullptr)
+        TEST_ASSERT(inductionVariable && getStrengthReducedIncrement(inductionVariable) == Literal(-4))
+    }
+
+    {
+        // the step is only known at run-time, so the loop is left alone
+        Method method(module);
+        auto step = method.addNewLocal(TYPE_INT32, "%step");
+        auto address = createAddressLoop(method, OP_ADD, step);
+
+        TEST_ASSERT(!reduceInductionVariableStrength(module, method, config))
+
+        TEST_ASSERT(getStrengthReducedSource(address) == nullptr)
+        auto op = dynamic_cast<const Operation*>(address->getSingleWriter());
+        TEST_ASSERT(op != nullptr && op->op == OP_ADD)
+    }
+}
+
+void TestOptimizationSteps::testScheduleSuperblocks()
+{
+    using namespace vc4c::intermediate;
+    Configuration config{};
+    Module module{config};
+
+    {
+        // instructions are hoisted into the stall NOPs of the previous block, but only if they are pure calculations
+        // and do not overwrite a value required by the side exit
+        Method method(module);
+        auto& firstBlock = method.createAndInsertNewBlock(method.end(), "%first");
+        auto& secondBlock = method.createAndInsertNewBlock(method.end(), "%second");
+        auto& exitBlock = method.createAndInsertNewBlock(method.end(), "%exit");
+
+        auto a = method.addNewLocal(TYPE_INT32, "%a");
+        auto b = method.addNewLocal(TYPE_INT32, "%b");
+        auto c = method.addNewLocal(TYPE_INT32, "%c");
+        auto d = method.addNewLocal(TYPE_INT32, "%d");
+        auto u = method.addNewLocal(TYPE_INT32, "%u");
+        auto w = method.addNewLocal(TYPE_INT32, "%w");
+
+        const IntermediateInstruction* initialU = nullptr;
+        const IntermediateInstruction* overwrittenU = nullptr;
+        {
+            auto it = firstBlock.walkEnd();
+            assign(it, a) = UNIFORM_REGISTER;
+            assign(it, b) = UNIFORM_REGISTER;
+            assign(it, u) = UNIFORM_REGISTER;
+            initialU = it.copy().previousInBlock().get();
+            for(unsigned i = 0; i < 3; ++i)
+            {
+                it.emplace(new Nop(DelayType::WAIT_REGISTER));
+                it.nextInBlock();
+            }
+            assignNop(it) = (a, SetFlag::SET_FLAGS);
+            it.emplace(new Branch(exitBlock.getLabel()->getLabel(), COND_ZERO_SET, a));
+            it.nextInBlock();
+        }
+        const IntermediateInstruction* memoryAccess = nullptr;
+        const IntermediateInstruction* flagSetter = nullptr;
+        {
+            auto it = secondBlock.walkEnd();
+            assign(it, Value(REG_TMU0_ADDRESS, TYPE_INT32)) = a;
+            memoryAccess = it.copy().previousInBlock().get();
+            assignNop(it) = (b, SetFlag::SET_FLAGS);
+            flagSetter = it.copy().previousInBlock().get();
+            assign(it, c) = (a, COND_ZERO_SET);
+            assign(it, d) = (a ^ b, SetFlag::SET_FLAGS);
+            // %u is read in the side exit, so it must not be overwritten before the branch
+            assign(it, u) = a - b;
+            overwrittenU = it.copy().previousInBlock().get();
+            assign(it, w) = a + b;
+            assign(it, UNIFORM_REGISTER) = c;
+            assign(it, UNIFORM_REGISTER) = d;
+            assign(it, UNIFORM_REGISTER) = w;
+        }
+        {
+            auto it = exitBlock.walkEnd();
+            assign(it, UNIFORM_REGISTER) = u;
+        }
+        TEST_ASSERT(scheduleSuperblocks(module, method, config))
+
+        TEST_ASSERT(findPositionInBlock(firstBlock, w.getSingleWriter()) < firstBlock.size())
+        TEST_ASSERT(findPositionInBlock(secondBlock, memoryAccess) < secondBlock.size())
+        TEST_ASSERT(findPositionInBlock(secondBlock, flagSetter) < secondBlock.size())
+        TEST_ASSERT(findPositionInBlock(secondBlock, c.getSingleWriter()) < secondBlock.size())
+        TEST_ASSERT(findPositionInBlock(secondBlock, d.getSingleWriter()) < secondBlock.size())
+        TEST_ASSERT(findPositionInBlock(firstBlock, initialU) < firstBlock.size())
+        TEST_ASSERT(findPositionInBlock(secondBlock, overwrittenU) < secondBlock.size())
+    }
+
+    {
+        // instructions are sunk into the stall NOPs of the next block, the value is re-calculated in the side exit
+        Method method(module);
+        auto& firstBlock = method.createAndInsertNewBlock(method.end(), "%first");
+        auto& secondBlock = method.createAndInsertNewBlock(method.end(), "%second");
+        auto& exitBlock = method.createAndInsertNewBlock(method.end(), "%exit");
+        auto& endBlock = method.createAndInsertNewBlock(method.end(), "%end");
+
+        auto a = method.addNewLocal(TYPE_INT32, "%a");
+        auto v = method.addNewLocal(TYPE_INT32, "%v");
+
+        const IntermediateInstruction* memoryAccess = nullptr;
+        {
+            auto it = firstBlock.walkEnd();
+            assign(it, a) = UNIFORM_REGISTER;
+            assign(it, Value(REG_TMU0_ADDRESS, TYPE_INT32)) = a;
+            memoryAccess = it.copy().previousInBlock().get();
+            assign(it, v) = a + 1_val;
+            assignNop(it) = (a, SetFlag::SET_FLAGS);
+            it.emplace(new Branch(exitBlock.getLabel()->getLabel(), COND_ZERO_SET, a));
+            it.nextInBlock();
+        }
+        {
+            auto it = secondBlock.walkEnd();
+            it.emplace(new Nop(DelayType::WAIT_REGISTER));
+            it.nextInBlock();
+            assign(it, UNIFORM_REGISTER) = v;
+            it.emplace(new Branch(endBlock.getLabel()->getLabel(), COND_ALWAYS, BOOL_TRUE));
+            it.nextInBlock();
+        }
+        {
+            auto it = exitBlock.walkEnd();
+            assign(it, UNIFORM_REGISTER) = a;
+            assign(it, UNIFORM_REGISTER) = v;
+        }
+        {
+            auto it = endBlock.walkEnd();
+            assign(it, UNIFORM_REGISTER) = a;
+        }
+
+        TEST_ASSERT(scheduleSuperblocks(module, method, config))
+
+        // the calculation is moved into the next block and copied into the side exit
+        unsigned numFirstWriters = 0;
+        unsigned numSecondWriters = 0;
+        unsigned numExitWriters = 0;
+        v.local()->forUsers(LocalUse::Type::WRITER, [&](const LocalUser* writer) {
+            if(findPositionInBlock(firstBlock, writer) < firstBlock.size())
+                ++numFirstWriters;
+            if(findPositionInBlock(secondBlock, writer) < secondBlock.size())
+                ++numSecondWriters;
+            if(findPositionInBlock(exitBlock, writer) < exitBlock.size())
+                ++numExitWriters;
+        });
+        TEST_ASSERT_EQUALS(0u, numFirstWriters)
+        TEST_ASSERT_EQUALS(1u, numSecondWriters)
+        TEST_ASSERT_EQUALS(1u, numExitWriters)
+        TEST_ASSERT(findPositionInBlock(firstBlock, memoryAccess) < firstBlock.size())
+    }
+}
+
+void TestOptimizationSteps::testPairInstructions()
+{
+    using namespace vc4c::intermediate;
+    Configuration config{};
+    Module module{config};
+
+    auto countCombined = [](const BasicBlock& block) -> unsigned {
+        unsigned numCombined = 0;
+        for(const auto& inst : block)
+        {
+            if(dynamic_cast<const CombinedOperation*>(inst.get()))
+                ++numCombined;
+        }
+        return numCombined;
+    };
+
+    {
+        // an independent instruction is moved up to be combined with an instruction for the other ALU
+        Method method(module);
+        auto& block = method.createAndInsertNewBlock(method.end(), "%pair");
+        auto a = method.addNewLocal(TYPE_INT32, "%a");
+        auto b = method.addNewLocal(TYPE_INT32, "%b");
+        auto x = method.addNewLocal(TYPE_INT32, "%x");
+        auto y = method.addNewLocal(TYPE_INT32, "%y");
+        auto z = method.addNewLocal(TYPE_INT32, "%z");
+
+        auto it = block.walkEnd();
+        assign(it, x) = a + b;
+        assign(it, z) = UNIFORM_REGISTER;
+        assign(it, y) = mul24(a, b);
+
+        TEST_ASSERT(combineOperations(module, method, config))
+        TEST_ASSERT_EQUALS(1u, countCombined(block))
+    }
+
+    {
+        // the instruction depends on the flags set in between, so it cannot be moved above the flag setter
+        Method method(module);
+        auto& block = method.createAndInsertNewBlock(method.end(), "%flags");
+        auto a = method.addNewLocal(TYPE_INT32, "%a");
+        auto b = method.addNewLocal(TYPE_INT32, "%b");
+        auto c = method.addNewLocal(TYPE_INT32, "%c");
+        auto x = method.addNewLocal(TYPE_INT32, "%x");
+        auto y = method.addNewLocal(TYPE_INT32, "%y");
+
+        auto it = block.walkEnd();
+        assign(it, x) = a + b;
+        assignNop(it) = (c, SetFlag::SET_FLAGS);
+        const IntermediateInstruction* flagSetter = it.copy().previousInBlock().get();
+        assign(it, y) = (mul24(a, b), COND_ZERO_SET);
+
+        combineOperations(module, method, config);
+        TEST_ASSERT_EQUALS(0u, countCombined(block))
+        TEST_ASSERT(findPositionInBlock(block, flagSetter) < findPositionInBlock(block, y.getSingleWriter()))
+    }
+
+    {
+        // the instruction reads a local written in between, so it cannot be moved above the writer
+        Method method(module);
+        auto& block = method.createAndInsertNewBlock(method.end(), "%dependency");
+        auto a = method.addNewLocal(TYPE_INT32, "%a");
+        auto b = method.addNewLocal(TYPE_INT32, "%b");
+        auto x = method.addNewLocal(TYPE_INT32, "%x");
+        auto y = method.addNewLocal(TYPE_INT32, "%y");
+
+        auto it = block.walkEnd();
+        assign(it, x) = a + b;
+        assign(it, b) = UNIFORM_REGISTER;
+        const IntermediateInstruction* writer = it.copy().previousInBlock().get();
+        assign(it, y) = mul24(a, b);
+
+        combineOperations(module, method, config);
+        TEST_ASSERT_EQUALS(0u, countCombined(block))
+        TEST_ASSERT(findPositionInBlock(block, writer) < findPositionInBlock(block, y.getSingleWriter()))
+    }
+}
+
+/*
+ * Returns the maximum number of locals written within the block, which are live at the same time
+ */
+static std::size_t calculatePeakLiveLocals(vc4c::BasicBlock& block)
+{
+    vc4c::FastMap<const vc4c::Local*, std::size_t> lastReads;
+    std::size_t index = 0;
+    for(auto it = block.walk().nextInBlock(); !it.isEndOfBlock(); it.nextInBlock(), ++index)
+    {
+        if(!it.has())
+            continue;
+        for(const auto& arg : it->getArguments())
+        {
+            if(auto loc = arg.checkLocal())
+                lastReads[loc] = index;
+        }
+    }
+
+    vc4c::FastSet<const vc4c::Local*> liveLocals;
+    std::size_t peak = 0;
+    index = 0;
+    for(auto it = block.walk().nextInBlock(); !it.isEndOfBlock(); it.nextInBlock(), ++index)
+    {
+        if(!it.has())
+            continue;
+        for(const auto& arg : it->getArguments())
+        {
+            auto loc = arg.checkLocal();
+            if(loc && lastReads.at(loc) == index)
+                liveLocals.erase(loc);
+        }
+        auto out = it->checkOutputLocal();
+        if(out && lastReads.find(out) != lastReads.end() && lastReads.at(out) > index)
+            liveLocals.emplace(out);
+        peak = std::max(peak, liveLocals.size());
+    }
+    return peak;
+}
+
+void TestOptimizationSteps::testSchedulerRegisterPressure()
+{
+    using namespace vc4c::intermediate;
+    Configuration config{};
+    Module module{config};
+    const std::size_t numValues = 16;
+
+    // all values are calculated before any of them is consumed, so all of them are live at the same time
+    auto scheduleBlock = [&](unsigned threshold) -> std::pair<std::size_t, std::size_t> {
+        Method method(module);
+        auto& block = method.createAndInsertNewBlock(method.end(), "%pressure");
+        auto a = method.addNewLocal(TYPE_INT32, "%a");
+
+        auto it = block.walkEnd();
+        assign(it, a) = UNIFORM_REGISTER;
+        std::vector<Value> values;
+        for(unsigned i = 0; i < numValues; ++i)
+        {
+            values.emplace_back(method.addNewLocal(TYPE_INT32, "%val"));
+            assign(it, values.back()) = a + Value(Literal(i), TYPE_INT32);
+        }
+        for(const auto& val : values)
+            assign(it, UNIFORM_REGISTER) = val;
+
+        auto peakBefore = calculatePeakLiveLocals(block);
+        Configuration localConfig = config;
+        localConfig.additionalOptions.maxSchedulerRegisterPressure = threshold;
+        reorderInstructions(module, method, localConfig);
+        return std::make_pair(peakBefore, calculatePeakLiveLocals(block));
+    };
+
+    auto unlimited = scheduleBlock(std::numeric_limits<unsigned>::max());
+    TEST_ASSERT_EQUALS(numValues, unlimited.first)
+
+    // with the block above the threshold, the scheduler interleaves the consumers to end live-ranges early
+    auto limited = scheduleBlock(static_cast<unsigned>(numValues / 2));
+    TEST_ASSERT_EQUALS(numValues, limited.first)
+    TEST_ASSERT(limited.second < limited.first)
+    TEST_ASSERT(limited.second <= unlimited.second)
+}
+
+/*
+ * Returns the position of the given block within the method
+ */
+static std::size_t findBlockPosition(vc4c::Method& method, const vc4c::BasicBlock& block)
+{
+    std::size_t index = 0;
+    for(const auto& bb : method)
+    {
+        if(&bb == &block)
+            return index;
+        ++index;
+    }
+    return index;
+}
+
+void TestOptimizationSteps::testReorderNeverExecutedBlocks()
+{
+    using namespace vc4c::intermediate;
+    Configuration config{};
+    Module module{config};
+
+    // %rare is only entered conditionally from %start and continues into %common, which has two predecessors
+    auto createBlocks = [](Method& method) -> std::array<BasicBlock*, 3> {
+        auto& startBlock = method.createAndInsertNewBlock(method.end(), "%start");
+        auto& rareBlock = method.createAndInsertNewBlock(method.end(), "%rare");
+        auto& commonBlock = method.createAndInsertNewBlock(method.end(), "%common");
+        auto& lastBlock = method.createAndInsertNewBlock(method.end(), BasicBlock::LAST_BLOCK);
+
+        auto a = method.addNewLocal(TYPE_INT32, "%a");
+        {
+            auto it = startBlock.walkEnd();
+            assign(it, a) = UNIFORM_REGISTER;
+            assignNop(it) = (a, SetFlag::SET_FLAGS);
+            it.emplace(new Branch(rareBlock.getLabel()->getLabel(), COND_ZERO_SET, a));
+            it.nextInBlock();
+            it.emplace(new Branch(commonBlock.getLabel()->getLabel(), COND_ZERO_CLEAR, a));
+            it.nextInBlock();
+        }
+        {
+            auto it = rareBlock.walkEnd();
+            assign(it, UNIFORM_REGISTER) = a;
+            it.emplace(new Branch(commonBlock.getLabel()->getLabel(), COND_ALWAYS, BOOL_TRUE));
+            it.nextInBlock();
+        }
+        {
+            auto it = commonBlock.walkEnd();
+            assign(it, UNIFORM_REGISTER) = a + 1_val;
+            it.emplace(new Branch(lastBlock.getLabel()->getLabel(), COND_ALWAYS, BOOL_TRUE));
+            it.nextInBlock();
+        }
+        {
+            auto it = lastBlock.walkEnd();
+            it.emplace(new Nop(DelayType::THREAD_END));
+        }
+        return {&startBlock, &rareBlock, &commonBlock};
+    };
+
+    {
+        // without a profile, the block order is kept
+        Method method(module);
+        method.name = "no_profile";
+        auto blocks = createBlocks(method);
+        reorderBasicBlocks(module, method, config);
+        TEST_ASSERT_EQUALS(1u, findBlockPosition(method, *blocks[1]))
+        TEST_ASSERT_EQUALS(2u, findBlockPosition(method, *blocks[2]))
+    }
+
+    {
+        // the never executed block is moved out of the way, so the executed blocks are next to each other
+        Method method(module);
+        method.name = "with_profile";
+        auto blocks = createBlocks(method);
+        config.blockProfile["with_profile"] = {
+            {"%start", 4}, {"%rare", 0}, {"%common", 4}, {BasicBlock::LAST_BLOCK, 4}};
+        reorderBasicBlocks(module, method, config);
+        TEST_ASSERT_EQUALS(0u, findBlockPosition(method, *blocks[0]))
+        TEST_ASSERT_EQUALS(1u, findBlockPosition(method, *blocks[2]))
+        TEST_ASSERT_EQUALS(2u, findBlockPosition(method, *blocks[1]))
+        config.blockProfile.clear();
+    }
+}
+
+void TestOptimizationSteps::testPipelineTMULoads()
+{
+    using namespace vc4c::intermediate;
+    Configuration config{};
+    Module module{config};
+    Method method(module);
+
+    auto& block = method.createAndInsertNewBlock(method.end(), "%loads");
+    auto base = method.addNewLocal(TYPE_INT32, "%base");
+    auto sum = method.addNewLocal(TYPE_INT32, "%sum");
+
+    const unsigned numLoads = 6;
+    std::vector<const IntermediateInstruction*> requests;
+    std::vector<const IntermediateInstruction*> triggers;
+    {
+        auto it = block.walkEnd();
+        assign(it, base) = UNIFORM_REGISTER;
+        assign(it, sum) = INT_ZERO;
+        for(unsigned i = 0; i < numLoads; ++i)
+        {
+            auto address = method.addNewLocal(TYPE_INT32, "%address");
+            auto result = method.addNewLocal(TYPE_INT32, "%result");
+            auto tmp = method.addNewLocal(TYPE_INT32, "%sum");
+            assign(it, address) = base + Value(Literal(4 * i), TYPE_INT32);
+            assign(it, Value(REG_TMU0_ADDRESS, TYPE_INT32)) = address;
+            requests.push_back(it.copy().previousInBlock().get());
+            it.emplace(new Nop(DelayType::WAIT_TMU, SIGNAL_LOAD_TMU0));
+            it.nextInBlock();
+            triggers.push_back(it.copy().previousInBlock().get());
+            assign(it, result) = Value(REG_TMU_OUT, TYPE_INT32);
+            assign(it, tmp) = sum + result;
+            sum = tmp;
+        }
+        assign(it, UNIFORM_REGISTER) = sum;
+    }
+
+    TEST_ASSERT(pipelineTMULoads(module, method, config))
+
+    // the loads are recognized by their identity, so following requests can also be moved in front of the responses
+    // of previously moved loads
+    auto firstTrigger = findPositionInBlock(block, triggers.front());
+    std::size_t numOutstandingRequests = 0;
+    for(auto request : requests)
+    {
+        if(findPositionInBlock(block, request) < firstTrigger)
+            ++numOutstandingRequests;
+    }
+    TEST_ASSERT(numOutstandingRequests >= 3)
+    TEST_ASSERT(numOutstandingRequests <= 2 * periphery::TMU_FIFO_DEPTH)
+
+    // the requests and responses keep their order and every response is loaded from the TMU of its request
+    for(std::size_t i = 0; i < numLoads; ++i)
+    {
+        TEST_ASSERT(findPositionInBlock(block, requests[i]) < findPositionInBlock(block, triggers[i]))
+        if(i > 0)
+        {
+            TEST_ASSERT(findPositionInBlock(block, requests[i - 1]) < findPositionInBlock(block, requests[i]))
+            TEST_ASSERT(findPositionInBlock(block, triggers[i - 1]) < findPositionInBlock(block, triggers[i]))
+        }
+        auto usesTMU1 = requests[i]->checkOutputRegister() == REG_TMU1_ADDRESS;
+        TEST_ASSERT_EQUALS(usesTMU1 ? SIGNAL_LOAD_TMU1 : SIGNAL_LOAD_TMU0, triggers[i]->signal)
+    }
+}
+
+void TestOptimizationSteps::testThreadSwitches()
+{
+    using namespace vc4c::intermediate;
+    Configuration config{};
+    Module module{config};
+
+    auto countSignals = [](BasicBlock& block, Signaling signal) -> unsigned {
+        return static_cast<unsigned>(std::count_if(block.begin(), block.end(),
+            [&](const IL& inst) -> bool { return inst && inst->signal == signal; }));
+    };
+
+    {
+        // the instructions between the TMU request and loading the response are used as delay slots
+        Method method(module);
+        method.metaData.isMultiThreaded = true;
+        auto& block = method.createAndInsertNewBlock(method.end(), "%start");
+        auto a = method.addNewLocal(TYPE_INT32, "%a");
+        auto b = method.addNewLocal(TYPE_INT32, "%b");
+        auto c = method.addNewLocal(TYPE_INT32, "%c");
+        auto r = method.addNewLocal(TYPE_INT32, "%r");
+        auto d = method.addNewLocal(TYPE_INT32, "%d");
+
+        const IntermediateInstruction* request = nullptr;
+        const IntermediateInstruction* trigger = nullptr;
+        const IntermediateInstruction* programEnd = nullptr;
+        {
+            auto it = block.walkEnd();
+            assign(it, a) = UNIFORM_REGISTER;
+            assign(it, Value(REG_TMU0_ADDRESS, TYPE_INT32)) = a;
+            request = it.copy().previousInBlock().get();
+            assign(it, b) = a + a;
+            assign(it, c) = a ^ b;
+            it.emplace(new Nop(DelayType::WAIT_TMU, SIGNAL_LOAD_TMU0));
+            trigger = it.get();
+            it.nextInBlock();
+            assign(it, r) = Value(REG_TMU_OUT, TYPE_INT32);
+            assign(it, d) = r + c;
+            assign(it, Value(REG_VPM_IO, TYPE_INT32)) = d;
+            it.emplace(new Nop(DelayType::THREAD_END, SIGNAL_END_PROGRAM));
+            programEnd = it.get();
+            it.nextInBlock();
+            it.emplace(new Nop(DelayType::THREAD_END));
+            it.nextInBlock();
+            it.emplace(new Nop(DelayType::THREAD_END));
+            it.nextInBlock();
+        }
+        const auto numInstructions = block.size();
+
+        periphery::insertThreadSwitches(method);
+
+        TEST_ASSERT_EQUALS(1u, countSignals(block, SIGNAL_SWITCH_THREAD))
+        TEST_ASSERT_EQUALS(1u, countSignals(block, SIGNAL_THREAD_SWITCH_LAST))
+        // no NOPs are required, the thread switch is signaled by the request itself
+        TEST_ASSERT_EQUALS(numInstructions, block.size())
+        TEST_ASSERT_EQUALS(SIGNAL_SWITCH_THREAD, request->signal)
+        TEST_ASSERT_EQUALS(findPositionInBlock(block, request) + 3, findPositionInBlock(block, trigger))
+        // the last thread switch takes effect before the end of the program
+        auto lastSwitchIt = std::find_if(block.begin(), block.end(),
+            [](const IL& inst) -> bool { return inst && inst->signal == SIGNAL_THREAD_SWITCH_LAST; });
+        TEST_ASSERT(lastSwitchIt != block.end())
+        TEST_ASSERT(findPositionInBlock(block, lastSwitchIt->get()) + 3 <= findPositionInBlock(block, programEnd))
+        TEST_ASSERT(findPositionInBlock(block, trigger) < findPositionInBlock(block, lastSwitchIt->get()))
+    }
+
+    {
+        // the delay slots are filled with NOPs if there are no instructions in between, the flags are not preserved
+        // across the thread switch
+        Method method(module);
+        method.metaData.isMultiThreaded = true;
+        auto& block = method.createAndInsertNewBlock(method.end(), "%start");
+        auto a = method.addNewLocal(TYPE_INT32, "%a");
+        auto r0 = method.addNewLocal(TYPE_INT32, "%r");
+        auto r1 = method.addNewLocal(TYPE_INT32, "%r");
+
+        const IntermediateInstruction* firstRequest = nullptr;
+        const IntermediateInstruction* firstTrigger = nullptr;
+        const IntermediateInstruction* secondTrigger = nullptr;
+        {
+            auto it = block.walkEnd();
+            assign(it, a) = UNIFORM_REGISTER;
+            assign(it, Value(REG_TMU0_ADDRESS, TYPE_INT32)) = a;
+            firstRequest = it.copy().previousInBlock().get();
+            it.emplace(new Nop(DelayType::WAIT_TMU, SIGNAL_LOAD_TMU0));
+            firstTrigger = it.get();
+            it.nextInBlock();
+            assign(it, r0) = Value(REG_TMU_OUT, TYPE_INT32);
+            assignNop(it) = (r0, SetFlag::SET_FLAGS);
+            assign(it, Value(REG_TMU0_ADDRESS, TYPE_INT32)) = a;
+            it.emplace(new Nop(DelayType::WAIT_TMU, SIGNAL_LOAD_TMU0));
+            secondTrigger = it.get();
+            it.nextInBlock();
+            assign(it, r1) = Value(REG_TMU_OUT, TYPE_INT32);
+            assign(it, Value(REG_VPM_IO, TYPE_INT32)) = (r1, COND_ZERO_SET);
+            it.emplace(new Nop(DelayType::THREAD_END, SIGNAL_END_PROGRAM));
+            it.nextInBlock();
+        }
+
+        periphery::insertThreadSwitches(method);
+
+        // there is no thread switch for the second load, since the flags are read afterwards
+        TEST_ASSERT_EQUALS(1u, countSignals(block, SIGNAL_SWITCH_THREAD))
+        TEST_ASSERT_EQUALS(1u, countSignals(block, SIGNAL_THREAD_SWITCH_LAST))
+        TEST_ASSERT_EQUALS(SIGNAL_SWITCH_THREAD, firstRequest->signal)
+        TEST_ASSERT_EQUALS(findPositionInBlock(block, firstRequest) + 3, findPositionInBlock(block, firstTrigger))
+        TEST_ASSERT_EQUALS(SIGNAL_LOAD_TMU0, secondTrigger->signal)
+    }
+
+    {
+        // TMU loads in conditional blocks are executed a different number of times
+        Method method(module);
+        auto& startBlock = method.createAndInsertNewBlock(method.end(), "%start");
+        auto& loadBlock = method.createAndInsertNewBlock(method.end(), "%load");
+        auto& endBlock = method.createAndInsertNewBlock(method.end(), "%end");
+        auto a = method.addNewLocal(TYPE_INT32, "%a");
+        auto r = method.addNewLocal(TYPE_INT32, "%r");
+
+        auto insertLoad = [&](BasicBlock& block) {
+            auto it = block.walkEnd();
+            if(it.copy().previousInBlock().get<Branch>())
+                it.previousInBlock();
+            assign(it, Value(REG_TMU0_ADDRESS, TYPE_INT32)) = a;
+            nop(it, DelayType::WAIT_TMU, SIGNAL_LOAD_TMU0);
+            assign(it, r) = Value(REG_TMU_OUT, TYPE_INT32);
+        };
+
+        {
+            auto it = startBlock.walkEnd();
+            assign(it, a) = UNIFORM_REGISTER;
+            assignNop(it) = (a, SetFlag::SET_FLAGS);
+            it.emplace(new Branch(endBlock.getLabel()->getLabel(), COND_ZERO_SET, a));
+            it.nextInBlock();
+        }
+        {
+            auto it = endBlock.walkEnd();
+            assign(it, UNIFORM_REGISTER) = a;
+        }
+        insertLoad(startBlock);
+        insertLoad(endBlock);
+        TEST_ASSERT(periphery::hasUniformTMUAccesses(method))
+
+        insertLoad(loadBlock);
+        TEST_ASSERT(!periphery::hasUniformTMUAccesses(method))
+    }
+}
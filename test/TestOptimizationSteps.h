@@ -31,6 +31,17 @@ public:
     void testCombineRotations();
     void testEliminateMoves();
     void testEliminateDeadCode();
+    void testGlobalValueNumbering();
+    void testFillBranchDelaySlots();
+    void testCacheWorkGroupUniforms();
+    void testMoveLoopInvariantCode();
+    void testReduceInductionVariableStrength();
+    void testScheduleSuperblocks();
+    void testPairInstructions();
+    void testSchedulerRegisterPressure();
+    void testReorderNeverExecutedBlocks();
+    void testPipelineTMULoads();
+    void testThreadSwitches();
 
 private:
     void testMethodsEquals(vc4c::Method& m1, vc4c::Method& m2);
@@ -6,11 +6,17 @@
 
 #include "TestOptimizations.h"
 
+#include "Compiler.h"
 #include "InstructionWalker.h"
 #include "Method.h"
 #include "Module.h"
 #include "intermediate/IntermediateInstruction.h"
 #include "optimization/Optimizer.h"
+#include "test_cases.h"
+#include "tools.h"
+
+#include <fstream>
+#include <sstream>
 
 using namespace vc4c;
 
@@ -65,6 +71,13 @@ TestOptimizations::TestOptimizations(const vc4c::Configuration& config) : TestEm
         TEST_ADD_WITH_STRING(TestOptimizations::testClamp, pass.parameterName);
         TEST_ADD_WITH_STRING(TestOptimizations::testCross, pass.parameterName);
     }
+    TEST_ADD(TestOptimizations::testSpecializedParameters);
+    TEST_ADD(TestOptimizations::testProfileGuidedOptimization);
+    TEST_ADD(TestOptimizations::testCacheWorkGroupUniforms);
+    TEST_ADD(TestOptimizations::testStrengthReduction);
+    TEST_ADD(TestOptimizations::testSuperblockSideExits);
+    TEST_ADD(TestOptimizations::testUnrollLoops);
+    TEST_ADD(TestOptimizations::testPipelineTMULoads);
     // TODO the profiling info is wrong, since all optimization counters get merged!
     // TEST_ADD(TestEmulator::printProfilingInfo);
     // TODO the test failures are not printed anymore for some reason (neither is the summary line), iff no other test
@@ -85,6 +98,16 @@ static const optimizations::OptimizationPass& getPass(std::string&& paramName)
     throw CompilationError(CompilationStep::GENERAL, "Pass does not exist", paramName);
 }
 
+static std::size_t findIntegerTest(const std::string& kernelName)
+{
+    for(std::size_t i = 0; i < vc4c::test::integerTests.size(); ++i)
+    {
+        if(vc4c::test::integerTests[i].first.kernelName == kernelName)
+            return i;
+    }
+    throw CompilationError(CompilationStep::GENERAL, "Test case does not exist", kernelName);
+}
+
 void TestOptimizations::testEmptyIterator(std::string passParamName)
 {
     /*
@@ -263,3 +286,121 @@ void TestOptimizations::testCross(std::string passParamName)
 
     TestEmulator::testFloatEmulations(11, "test_cross");
 }
+
+void TestOptimizations::testSpecializedParameters()
+{
+    config.additionalEnabledOptimizations = {requiredOptimization};
+    config.optimizationLevel = OptimizationLevel::FULL;
+    config.specializedParameters["fibonacci"] = {{0, 1u}, {1, 1u}};
+
+    // the kernel is run with other start values, so the expected results (for the start values 1 and 1) are only
+    // calculated if the specialized constants replace the reads of the parameters
+    auto& testCase = vc4c::test::integerTests.at(findIntegerTest("fibonacci"));
+    auto data = testCase.first;
+    auto expectedResults = testCase.second;
+    data.parameter.at(0) = vc4c::test::toScalarParameter(7u);
+    data.parameter.at(1) = vc4c::test::toScalarParameter(13u);
+    testIntegerEmulation(data, expectedResults);
+    config.specializedParameters.clear();
+
+    // the specialized values are only 32 bits wide, so wider parameters cannot be specialized
+    std::stringstream source("__kernel void test_long(long val, __global long* out) { *out = val; }");
+    std::stringstream output;
+    config.specializedParameters["test_long"] = {{0, 1u}};
+    TEST_THROWS(Compiler::compile(source, output, config), CompilationError)
+    config.specializedParameters.clear();
+}
+
+void TestOptimizations::testProfileGuidedOptimization()
+{
+    config.additionalEnabledOptimizations = {requiredOptimization};
+    config.optimizationLevel = OptimizationLevel::FULL;
+    config.outputMode = OutputMode::BINARY;
+    config.writeKernelInfo = true;
+
+    // record the block profile of a first execution
+    auto data = vc4c::test::integerTests.at(0).first;
+    std::ifstream input(data.module.first);
+    std::stringstream buffer;
+    BlockLayout layout;
+    Compiler::compile(input, buffer, config, "", data.module.first, &layout);
+    data.module = std::make_pair("", &buffer);
+    const auto result = tools::emulate(data);
+    TEST_ASSERT(result.executionSuccessful)
+    TEST_ASSERT_EQUALS(1u, layout.count(data.kernelName))
+    const auto profile = tools::createBlockProfile(result, layout.at(data.kernelName));
+    TEST_ASSERT(!profile.empty())
+
+    // the profile needs to survive being written to and read from a file
+    std::stringstream profileData;
+    std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>> blockProfile;
+    blockProfile.emplace(data.kernelName, profile);
+    tools::writeBlockProfile(profileData, blockProfile);
+    TEST_ASSERT(tools::readBlockProfile(profileData, config))
+    TEST_ASSERT(config.blockProfile.at(data.kernelName) == profile)
+
+    // recompile with the profile applied
+    TestEmulator::testIntegerEmulations(0, "fibonacci");
+    config.blockProfile.clear();
+}
+
+void TestOptimizations::testCacheWorkGroupUniforms()
+{
+    config.additionalEnabledOptimizations = {requiredOptimization, "cache-uniforms"};
+    config.optimizationLevel = OptimizationLevel::NONE;
+    const auto defaultThreshold = config.additionalOptions.maxLoopInvariantLocals;
+
+    // With the lower thresholds only the first few UNIFORMs are read once and the UNIFORM pointer is reset to skip
+    // them, while the remaining UNIFORMs are still read in every work-group. With the default threshold, all UNIFORMs
+    // are read once and the UNIFORM pointer is not reset at all.
+    for(unsigned threshold : {0u, 1u, 2u, 3u, 4u, 6u, defaultThreshold})
+    {
+        config.additionalOptions.maxLoopInvariantLocals = threshold;
+        TestEmulator::testIntegerEmulations(findIntegerTest("test_work_group_uniforms"), "test_work_group_uniforms");
+    }
+    config.additionalOptions.maxLoopInvariantLocals = defaultThreshold;
+}
+
+void TestOptimizations::testStrengthReduction()
+{
+    config.additionalEnabledOptimizations = {"reduce-strength"};
+    config.optimizationLevel = OptimizationLevel::NONE;
+
+    TestEmulator::testIntegerEmulations(findIntegerTest("test_strength_reduction"), "test_strength_reduction");
+}
+
+void TestOptimizations::testSuperblockSideExits()
+{
+    config.additionalEnabledOptimizations = {"schedule-superblocks"};
+    config.optimizationLevel = OptimizationLevel::NONE;
+
+    TestEmulator::testIntegerEmulations(findIntegerTest("test_superblock_exits"), "test_superblock_exits");
+}
+
+void TestOptimizations::testUnrollLoops()
+{
+    config.additionalEnabledOptimizations = {"unroll-loops"};
+    config.optimizationLevel = OptimizationLevel::NONE;
+    const auto defaultThreshold = config.additionalOptions.maxUnrolledInstructions;
+
+    // With the default threshold the loops with constant trip count are unrolled completely. The lower thresholds only
+    // allow partial unrolling by a factor dividing the trip count, which rejects the loop with the prime trip count,
+    // and finally reject all loops. The loop with the run-time trip count is never unrolled.
+    for(unsigned threshold : {defaultThreshold, 32u, 8u})
+    {
+        config.additionalOptions.maxUnrolledInstructions = threshold;
+        TestEmulator::testIntegerEmulations(findIntegerTest("test_unroll_loops"), "test_unroll_loops");
+    }
+    config.additionalOptions.maxUnrolledInstructions = defaultThreshold;
+}
+
+void TestOptimizations::testPipelineTMULoads()
+{
+    config.additionalEnabledOptimizations = {"pipeline-tmu-loads"};
+    config.optimizationLevel = OptimizationLevel::NONE;
+
+    TestEmulator::testIntegerEmulations(findIntegerTest("test_pipeline_tmu_loads"), "test_pipeline_tmu_loads");
+    // the unrolled loop iterations share a block, so their loads are issued concurrently
+    config.additionalEnabledOptimizations = {"unroll-loops", "pipeline-tmu-loads"};
+    TestEmulator::testIntegerEmulations(findIntegerTest("test_unroll_loops"), "test_unroll_loops");
+}
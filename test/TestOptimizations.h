@@ -42,6 +42,14 @@ public:
     void testArithmetic(std::string passParamName);
     void testClamp(std::string passParamName);
     void testCross(std::string passParamName);
+
+    void testSpecializedParameters();
+    void testProfileGuidedOptimization();
+    void testCacheWorkGroupUniforms();
+    void testStrengthReduction();
+    void testSuperblockSideExits();
+    void testUnrollLoops();
+    void testPipelineTMULoads();
 };
 
 #endif /* VC4C_TEST_OPTIMIZATIONS_H */
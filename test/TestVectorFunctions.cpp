@@ -158,6 +158,8 @@ TestVectorFunctions::TestVectorFunctions(const vc4c::Configuration& config) : co
     TEST_ADD(TestVectorFunctions::testVectorReorder8);
     TEST_ADD(TestVectorFunctions::testVectorReorder16);
     TEST_ADD(TestVectorFunctions::testVectorReorderLong);
+    TEST_ADD(TestVectorFunctions::testVectorReorderReverse);
+    TEST_ADD(TestVectorFunctions::testVectorReorderDeinterleave);
 
     /*XXX
         TEST_ADD(TestVectorFunctions::testExtractElement);
@@ -653,6 +655,26 @@ void TestVectorFunctions::testVectorReorderLong()
         std::bind(&TestVectorFunctions::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
 }
 
+void TestVectorFunctions::testVectorReorderReverse()
+{
+    testVectorReorderFunction<int, 4>(
+        config, "-DTYPE=int4 -DORDER=wzyx",
+        [](const std::array<int, 4>& in) -> std::array<int, 4> {
+            return checkShuffle(in, {3, 2, 1, 0});
+        },
+        std::bind(&TestVectorFunctions::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
+}
+
+void TestVectorFunctions::testVectorReorderDeinterleave()
+{
+    testVectorReorderFunction<int, 8>(
+        config, "-DTYPE=int8 -DORDER=s02461357",
+        [](const std::array<int, 8>& in) -> std::array<int, 8> {
+            return checkShuffle(in, {0, 2, 4, 6, 1, 3, 5, 7});
+        },
+        std::bind(&TestVectorFunctions::onMismatch, this, std::placeholders::_1, std::placeholders::_2));
+}
+
 template <typename T, std::size_t N>
 std::string to_string(const std::array<T, N>& vec, unsigned numElements)
 {
@@ -70,6 +70,8 @@ public:
     void testVectorReorder8();
     void testVectorReorder16();
     void testVectorReorderLong();
+    void testVectorReorderReverse();
+    void testVectorReorderDeinterleave();
     void testExtractElement();
     void testInsertElement();
 
@@ -211,6 +211,44 @@ namespace vc4c
 					{toParameter(std::vector<unsigned>{0x01010101, 0x23232323, 0x45454545, 0x67676767}), toParameter(std::vector<unsigned>(2))}, {}, maxExecutionCycles),
 					addVector({}, 1, std::vector<unsigned>{0x01010101, 0x45454545})
 				),
+				std::make_pair(EmulationData(VC4C_ROOT_PATH "testing/test_other.cl", "test_invariant_division",
+					{toParameter(std::vector<int32_t>{0, 7, 1000, -123456789}), toParameter(std::vector<int32_t>(16)), toScalarParameter(7u), toScalarParameter(-3)}, {}, maxExecutionCycles),
+					addVector({}, 1, std::vector<int32_t>{0, 0, 0, 0, 1, 0, -2, 1, 142, 6, -333, 1, 595930072, 3, 41152263, 0})
+				),
+				std::make_pair(EmulationData(VC4C_ROOT_PATH "testing/test_other.cl", "test_work_group_uniforms",
+					{toParameter(std::vector<int32_t>(24)), toScalarParameter(100), toScalarParameter(1000), toScalarParameter(10), toScalarParameter(1)}, toConfig(4, 1, 1, 3, 2, 1), maxExecutionCycles),
+					addVector({}, 0, std::vector<int32_t>{1, 11, 21, 31, 101, 111, 121, 131, 201, 211, 221, 231, 1001, 1011, 1021, 1031, 1101, 1111, 1121, 1131, 1201, 1211, 1221, 1231})
+				),
+				std::make_pair(EmulationData(VC4C_ROOT_PATH "testing/test_other.cl", "test_strength_reduction",
+					{toParameter(std::vector<int32_t>(24)), toScalarParameter(2)}, {}, maxExecutionCycles),
+					addVector({}, 0, std::vector<int32_t>{0, 0, 0, 1, 5, 14, 2, 10, 28, 3, 15, 42, 4, 20, 56, 5, 25, 70, 6, 30, 84, 7, 35, 98})
+				),
+				std::make_pair(EmulationData(VC4C_ROOT_PATH "testing/test_other.cl", "test_superblock_exits",
+					{toParameter(toRange<int32_t>(0, 8)), toParameter(std::vector<int32_t>(16))}, {}, maxExecutionCycles),
+					addVector({}, 1, std::vector<int32_t>{7, 8, 9, 10, 12, 15, 18, 21, 0, 0, 0, 0, 8, 10, 12, 14})
+				),
+				std::make_pair(EmulationData(VC4C_ROOT_PATH "testing/test_other.cl", "test_unroll_loops",
+					{toParameter(toRange<int32_t>(1, 17)), toParameter(std::vector<int32_t>(4)), toScalarParameter(10)}, {},
+					maxExecutionCycles),
+					addVector({}, 1, std::vector<int32_t>{108, 12274, 41, 10})
+				),
+				// division by one, powers of two, unsigned divisors above 2^31 and INT_MIN
+				std::make_pair(EmulationData(VC4C_ROOT_PATH "testing/test_other.cl", "test_invariant_division",
+					{toParameter(std::vector<int32_t>{0, 7, 1000, -123456789}), toParameter(std::vector<int32_t>(16)), toScalarParameter(1u), toScalarParameter(1)}, {}, maxExecutionCycles),
+					addVector({}, 1, std::vector<int32_t>{0, 0, 0, 0, 7, 0, 7, 0, 1000, 0, 1000, 0, -123456789, 0, -123456789, 0})
+				),
+				std::make_pair(EmulationData(VC4C_ROOT_PATH "testing/test_other.cl", "test_invariant_division",
+					{toParameter(std::vector<int32_t>{0, 7, 1000, -123456789}), toParameter(std::vector<int32_t>(16)), toScalarParameter(16u), toScalarParameter(8)}, {}, maxExecutionCycles),
+					addVector({}, 1, std::vector<int32_t>{0, 0, 0, 0, 0, 7, 0, 7, 62, 8, 125, 0, 260719406, 11, -15432098, -5})
+				),
+				std::make_pair(EmulationData(VC4C_ROOT_PATH "testing/test_other.cl", "test_invariant_division",
+					{toParameter(std::vector<int32_t>{0, 7, 1000, -123456789}), toParameter(std::vector<int32_t>(16)), toScalarParameter(0x80000005u), toScalarParameter(std::numeric_limits<int32_t>::min())}, {}, maxExecutionCycles),
+					addVector({}, 1, std::vector<int32_t>{0, 0, 0, 0, 0, 7, 0, 7, 0, 1000, 0, 1000, 1, 2024026854, 0, -123456789})
+				),
+				std::make_pair(EmulationData(VC4C_ROOT_PATH "testing/test_other.cl", "test_pipeline_tmu_loads",
+					{toParameter(toRange<int32_t>(1, 17)), toParameter(std::vector<int32_t>(3))}, {}, maxExecutionCycles),
+					addVector({}, 1, std::vector<int32_t>{390, 24, -136})
+				),
 				// TODO fix result error
 				// std::make_pair(EmulationData(VC4C_ROOT_PATH "testing/pocl/test_structs_as_args.cl", "test_kernel",
 				// 	{toParameter(std::vector<unsigned>{0x01001001, 0x02002002, 0x03003003, 0x04004004, 0x05005005, 0x06006006, 0x07007007, 0x48008008, 0x09009009, 0x0A00A00A, 0x0B00B00B, 0x0C00C00C}), toParameter(std::vector<unsigned>(10))}, {}, maxExecutionCycles),
@@ -268,6 +306,10 @@ namespace vc4c
 					{toParameter(std::vector<float>(1024))}, {}, maxExecutionCycles * 2),
 					addVector({}, 0, toRange<float>(0.0f, 1024.0f))
 				),
+				std::make_pair(EmulationData(VC4C_ROOT_PATH "testing/test_vectorization.cl", "test12",
+					{toParameter(std::vector<float>(1024)), toScalarParameter(1021)}, {}, maxExecutionCycles * 2),
+					addVector({}, 0, toRange<float>(0.0f, 1021.0f))
+				),
 				std::make_pair(EmulationData(VC4C_ROOT_PATH "testing/OpenCL-CTS/clamp.cl", "test_clamp",
 					{toParameter(std::vector<float>{17.0f, 0.0f, 3.0f}), toParameter(std::vector<float>{1.0f, 1.0f, 1.0f}), toParameter(std::vector<float>{5.0f, 5.0f, 5.0f}), toParameter(std::vector<float>(3))},
 					toConfig(3, 1, 1, 1, 1, 1), maxExecutionCycles),
@@ -100,3 +100,107 @@ __kernel void test_global_data(const int index, __global int* out)
 	out[0] = globalData[index];
 	out[1] = localData[index];
 }
+
+__kernel void test_invariant_division(const __global int* in, __global int* out, const uint udivisor, const int sdivisor)
+{
+	for(int i = 0; i < 4; ++i)
+	{
+		uint u = in[i];
+		out[i * 4 + 0] = u / udivisor;
+		out[i * 4 + 1] = u % udivisor;
+		out[i * 4 + 2] = in[i] / sdivisor;
+		out[i * 4 + 3] = in[i] % sdivisor;
+	}
+}
+
+/*
+ * Tests reading the work-item info and parameters once for all work-groups
+ */
+__kernel void test_work_group_uniforms(__global int* out, const int a, const int b, const int c, const int d)
+{
+	size_t index = get_global_id(1) * get_global_size(0) + get_global_id(0);
+	out[index] = (int) get_group_id(0) * a + (int) get_group_id(1) * b + (int) get_local_id(0) * c + d;
+}
+
+/*
+ * Tests replacing multiplications of the induction variable with separately incremented values
+ */
+__kernel void test_strength_reduction(__global int* out, const int step)
+{
+	// constant positive step
+	for(int i = 0; i < 8; ++i)
+		out[i * 3] = i;
+	// constant negative step
+	for(int i = 7; i >= 0; --i)
+		out[i * 3 + 1] = i * 5;
+	// step only known at run-time
+	for(int i = 0, k = 0; k < 8; i += step, ++k)
+		out[k * 3 + 2] = i * 7;
+}
+
+/*
+ * Tests scheduling instructions across the conditional side exits of a superblock
+ */
+__kernel void test_superblock_exits(const __global int* in, __global int* out)
+{
+	for(int i = 0; i < 8; ++i)
+	{
+		int val = in[i];
+		int res = val + 7;
+		if(val > 3)
+		{
+			res = val * 3;
+			out[i + 8] = res - val;
+		}
+		out[i] = res;
+	}
+}
+
+/*
+ * Tests unrolling loops with constant and run-time iteration counts
+ */
+__kernel void test_unroll_loops(const __global int* in, __global int* out, const int count)
+{
+	// constant trip count
+	int sum = 0;
+#pragma unroll 1
+	for(int i = 0; i < 8; ++i)
+		sum += in[i] * 3;
+	out[0] = sum;
+	// the trip count is not a multiple of every unroll factor
+	int acc = 1;
+#pragma unroll 1
+	for(int i = 0; i < 12; ++i)
+		acc = acc * 2 + in[i];
+	out[1] = acc;
+	// the prime trip count can only be unrolled completely
+	int val = 0;
+#pragma unroll 1
+	for(int i = 0; i < 7; ++i)
+		val = (val ^ in[i]) + i;
+	out[2] = val;
+	// trip count only known at run-time
+	int rt = 0;
+#pragma unroll 1
+	for(int i = 0; i < count; ++i)
+		rt += in[i] - i;
+	out[3] = rt;
+}
+
+/*
+ * Tests issuing several independent TMU loads before consuming their results
+ */
+__kernel void test_pipeline_tmu_loads(const __global int* in, __global int* out)
+{
+	int a = in[0];
+	int b = in[3];
+	int c = in[5];
+	int d = in[6];
+	int e = in[9];
+	int f = in[10];
+	int g = in[12];
+	int h = in[15];
+	out[0] = a + b * 2 + c * 3 + d * 4 + e * 5 + f * 6 + g * 7 + h * 8;
+	out[1] = a ^ b ^ c ^ d ^ e ^ f ^ g ^ h;
+	out[2] = a * b - c * d + e * f - g * h;
+}
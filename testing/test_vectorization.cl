@@ -92,3 +92,10 @@ kernel void test11(global struct Foo *out) {
     f.A[i] = f.B[i] + 100;
   *out = f;
 }
+
+kernel void test12(global float *A, int count) {
+  //Expected: should be able to vectorize
+  //Actual: loop is vectorized (factor 16) with a scalar copy of the loop executing the remaining iterations
+  for (int i = 0; i < count; ++i)
+    A[i] = i;
+}
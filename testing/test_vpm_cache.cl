@@ -0,0 +1,20 @@
+/*
+ * Tests caching of memory accesses within loops in VPM
+ *
+ * The loops must not be unrolled, since only memory accessed within loops is cached.
+ */
+__kernel void test_vpm_cache(const __global int* in, __global int* out, __global int* sum)
+{
+	int tmp = 0;
+	#pragma unroll 1
+	for(int i = 0; i < 4; ++i)
+	{
+		out[i + 4] = in[i] * 2 + i;
+	}
+	#pragma unroll 1
+	for(int i = 0; i < 4; ++i)
+	{
+		tmp += out[i + 4];
+	}
+	*sum = tmp;
+}
@@ -19,3 +19,27 @@ __kernel void test_vpm_write(__global const int16* in, __global int16* out1, __g
 
 	//TODO test optimization with strided writes and unknown stride - possible?
 }
+
+/*
+ * Tests combining strided writes to addresses only known at run-time
+ */
+__kernel void test_vpm_write_strided(__global const int16* in, __global int16* out, const int offset)
+{
+	int16 val = *in;
+	for(int i = 0; i < 8; ++i)
+		out[offset + 2 * i] = val + (int16)i;
+}
+
+/*
+ * Tests writes which must not be combined, since the index is re-calculated between the writes
+ */
+__kernel void test_vpm_write_rewritten(__global const int16* in, __global int16* out, const int offset)
+{
+	int16 val = *in;
+	int index = offset;
+	for(int i = 0; i < 8; ++i)
+	{
+		out[index] = val + (int16)i;
+		index = (index * 5 + 3) % 16;
+	}
+}
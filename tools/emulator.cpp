@@ -10,6 +10,7 @@
 #include "Profiler.h"
 #include "asm/Instruction.h"
 #include "asm/KernelInfo.h"
+#include "parameters.h"
 
 #include "log.h"
 
@@ -64,88 +65,6 @@ void printValue(uint32_t val, BufferType type)
     }
 }
 
-static std::vector<tools::Word> readBinaryFile(std::string fileName)
-{
-    std::ifstream s(fileName);
-    std::vector<tools::Word> res;
-
-    tools::Word word;
-    while(s.read(reinterpret_cast<char*>(&word), sizeof(tools::Word)))
-    {
-        res.push_back(word);
-    }
-
-    return res;
-}
-
-static std::vector<tools::Word> readDirectData(std::string data)
-{
-    std::vector<tools::Word> words;
-
-    tools::Word currentWord{};
-    for(std::size_t i = 0; i < data.size(); ++i)
-    {
-        currentWord |= static_cast<tools::Word>(data.at(i)) << ((i % 4) * 8);
-        if(i % 4 == 3)
-        {
-            words.push_back(currentWord);
-            currentWord = 0;
-        }
-    }
-    // last word
-    if(data.size() % sizeof(tools::Word) != 0)
-        words.push_back(currentWord);
-
-    return words;
-}
-
-template <typename T>
-struct HexHelper : public std::make_unsigned<T>
-{
-};
-
-template <>
-struct HexHelper<float>
-{
-    using type = float;
-};
-
-template <typename T>
-static std::vector<tools::Word> readDirectBuffer(std::string data)
-{
-    std::vector<tools::Word> words;
-    std::stringstream ss(data);
-    T t = 0;
-    while((ss.peek() == 'i') || (ss.peek() == 'n') || (ss >> t))
-    {
-        if(ss.peek() == 'i' || ss.peek() == 'n')
-        {
-            // inf / nan
-            std::string tmp;
-            ss >> tmp;
-            if(tmp == "inf")
-                t = std::numeric_limits<T>::infinity();
-            else if(tmp == "nan")
-                t = std::numeric_limits<T>::quiet_NaN();
-        }
-        else if(t == 0 && ss.peek() == 'x')
-        {
-            // skip x in (0x...)
-            ss.get();
-            using HexType = typename HexHelper<T>::type;
-            HexType tmp = 0;
-            // read number as hexadecimal unsigned
-            ss >> std::hex >> tmp >> std::dec;
-            t = bit_cast<HexType, T>(tmp);
-        }
-        words.emplace_back(bit_cast<T, uint32_t>(t));
-        while(ss.peek() == ' ')
-            ss.get();
-    }
-
-    return words;
-}
-
 static void printHelp()
 {
     std::cout << "Usage: emulator [-k <kernel-name>] [-d <dump-file>] [-l <local-sizes>] [-g <global-sizes>] [args] "
@@ -0,0 +1,110 @@
+/*
+ * Helper functions to read the kernel parameters for emulated executions from the command-line, shared by the tools
+ *
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+#ifndef VC4C_TOOLS_PARAMETERS_H
+#define VC4C_TOOLS_PARAMETERS_H
+
+#include "helper.h"
+#include "tools.h"
+#include "tools/Emulator.h"
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace vc4c
+{
+    namespace tools
+    {
+        inline std::vector<tools::Word> readBinaryFile(const std::string& fileName)
+        {
+            std::ifstream s(fileName);
+            std::vector<tools::Word> res;
+
+            tools::Word word;
+            while(s.read(reinterpret_cast<char*>(&word), sizeof(tools::Word)))
+            {
+                res.push_back(word);
+            }
+
+            return res;
+        }
+
+        inline std::vector<tools::Word> readDirectData(const std::string& data)
+        {
+            std::vector<tools::Word> words;
+
+            tools::Word currentWord{};
+            for(std::size_t i = 0; i < data.size(); ++i)
+            {
+                currentWord |= static_cast<tools::Word>(data.at(i)) << ((i % 4) * 8);
+                if(i % 4 == 3)
+                {
+                    words.push_back(currentWord);
+                    currentWord = 0;
+                }
+            }
+            // last word
+            if(data.size() % sizeof(tools::Word) != 0)
+                words.push_back(currentWord);
+
+            return words;
+        }
+
+        template <typename T>
+        struct HexHelper : public std::make_unsigned<T>
+        {
+        };
+
+        template <>
+        struct HexHelper<float>
+        {
+            using type = float;
+        };
+
+        template <typename T>
+        std::vector<tools::Word> readDirectBuffer(const std::string& data)
+        {
+            std::vector<tools::Word> words;
+            std::stringstream ss(data);
+            T t = 0;
+            while((ss.peek() == 'i') || (ss.peek() == 'n') || (ss >> t))
+            {
+                if(ss.peek() == 'i' || ss.peek() == 'n')
+                {
+                    // inf / nan
+                    std::string tmp;
+                    ss >> tmp;
+                    if(tmp == "inf")
+                        t = std::numeric_limits<T>::infinity();
+                    else if(tmp == "nan")
+                        t = std::numeric_limits<T>::quiet_NaN();
+                }
+                else if(t == 0 && ss.peek() == 'x')
+                {
+                    // skip x in (0x...)
+                    ss.get();
+                    using HexType = typename HexHelper<T>::type;
+                    HexType tmp = 0;
+                    // read number as hexadecimal unsigned
+                    ss >> std::hex >> tmp >> std::dec;
+                    t = bit_cast<HexType, T>(tmp);
+                }
+                words.emplace_back(bit_cast<T, uint32_t>(t));
+                while(ss.peek() == ' ')
+                    ss.get();
+            }
+
+            return words;
+        }
+    } // namespace tools
+} // namespace vc4c
+
+#endif /* VC4C_TOOLS_PARAMETERS_H */
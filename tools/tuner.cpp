@@ -0,0 +1,465 @@
+/*
+ * Author: doe300
+ *
+ * See the file "LICENSE" for the full license governing this code.
+ */
+
+#include "CompilationError.h"
+#include "Compiler.h"
+#include "ThreadPool.h"
+#include "optimization/Optimizer.h"
+#include "parameters.h"
+#include "tools.h"
+
+#include "log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+using namespace vc4c;
+using namespace vc4c::tools;
+
+/*
+ * The settings of a single tuning candidate, maps the tuned dimension (the optimization level, an optimization
+ * parameter or an optimization pass) to the compiler option selected for this dimension.
+ *
+ * Dimensions without an entry use the value of the base configuration.
+ */
+using Settings = std::map<std::string, std::string>;
+
+/*
+ * The values tried for the optimization parameters, the values are chosen around the default values
+ */
+static const std::vector<std::pair<std::string, std::vector<unsigned>>> TUNED_PARAMETERS = {
+    {"combine-load-threshold", {2, 6, 12, 24}},
+    {"accumulator-threshold", {5, 6, 8, 12}},
+    {"replace-nop-threshold", {16, 64, 256}},
+    {"common-subexpression-threshold", {16, 64, 256}},
+    {"unroll-threshold", {32, 128, 512}},
+    {"loop-invariant-threshold", {16, 32, 48}},
+    {"scheduler-pressure-threshold", {24, 48, 64}},
+    {"combine-distance-threshold", {4, 8, 16}},
+};
+
+static const std::vector<std::pair<std::string, OptimizationLevel>> TUNED_LEVELS = {
+    {"-O1", OptimizationLevel::BASIC},
+    {"-O2", OptimizationLevel::MEDIUM},
+    {"-O3", OptimizationLevel::FULL},
+};
+
+// required for the machine code to be valid, so never disabled
+static const std::string REQUIRED_PASS = "split-read-write";
+
+struct Evaluation
+{
+    Settings settings;
+    bool successful = false;
+    uint32_t numCycles = 0;
+    std::vector<std::pair<uint32_t, Optional<std::vector<uint32_t>>>> results;
+    // the number of executions of the blocks of the tuned kernel
+    std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>> blockProfile;
+};
+
+static void printHelp()
+{
+    std::cout << "Usage: tuner [-k <kernel-name>] [-l <local-sizes>] [-g <global-sizes>] [-r <rounds>] [-j <threads>] "
+                 "[-p <profile-file>] [-i <block-profile>] [--no-passes] [compiler options] [args] input-file"
+              << std::endl;
+    std::cout << "Searches the optimization settings resulting in the fewest emulated cycles for the given kernel and "
+                 "input"
+              << std::endl;
+    std::cout << "\t-k <kernel-name>\tSpecifies the kernel to tune, defaults to the first/only kernel in the module"
+              << std::endl;
+    std::cout << "\t-l <local-sizes>\tUses the given local sizes in the format x y z (3 parameter), defaults to single "
+                 "execution"
+              << std::endl;
+    std::cout << "\t-g <num-groups>\t\tUses the given number of work-groups in the format x y z (3 parameter), "
+                 "defaults to single execution"
+              << std::endl;
+    std::cout << "\t-r <rounds>\t\tThe maximum number of tuning rounds, each round applies the single best change, "
+                 "defaults to 8"
+              << std::endl;
+    std::cout << "\t-j <threads>\t\tThe number of configurations to compile and emulate in parallel, defaults to the "
+                 "number of CPU cores"
+              << std::endl;
+    std::cout << "\t-p <profile-file>\tWrites the compiler options of the best configuration into the file specified, "
+                 "to be applied with --options=<profile-file>"
+              << std::endl;
+    std::cout << "\t-i <block-profile>\tWrites the block execution counts of the best configuration into the file "
+                 "specified, to be used for profile-guided optimization (--profile=<block-profile>)"
+              << std::endl;
+    std::cout << "\t--no-passes\t\tDo not try to enable/disable single optimization passes" << std::endl;
+    std::cout << "\t-h, --help\t\tPrint this help message" << std::endl;
+    std::cout << "\t-q, --quiet\t\tQuiet all debug output" << std::endl;
+    std::cout << "\t--verbose\t\tPrint verbose debug output" << std::endl;
+    std::cout << "[compiler options] are applied to all configurations and are the same as for the VC4C compiler, "
+                 "e.g. -O2 or --fno-<pass>"
+              << std::endl;
+    std::cout << "[args] specify the values for the input parameters and can take following values:" << std::endl;
+    std::cout << "\t-f <file-name>\t\tRead <file-name> as binary file" << std::endl;
+    std::cout << "\t-s <string>\t\tUse <string> as input string" << std::endl;
+    std::cout << "\t-b <num>\t\tAllocate an empty buffer with <num> words of size" << std::endl;
+    std::cout << "\t-ib <values>\t\tAllocate a buffer containing the given values. The values are passed "
+                 "space-separated inside a string (double-quotes, e.g. \"0 1 2 3 ...\")"
+              << std::endl;
+    std::cout << "\t-fb <values>\t\tAllocate a buffer containing the given values. The values are passed "
+                 "space-separated inside a string (double-quotes, e.g. \"0.0 1.0 2.0 3.0 ...\")"
+              << std::endl;
+    std::cout << "\t<data>\t\t\tUse <data> as input word" << std::endl;
+}
+
+static std::string toOptions(const Settings& settings, const std::string& separator)
+{
+    std::string options;
+    for(const auto& setting : settings)
+        options.append(options.empty() ? "" : separator).append(setting.second);
+    return options;
+}
+
+static OptimizationLevel getLevel(const Settings& settings, const Configuration& baseConfig)
+{
+    auto it = settings.find("level");
+    if(it == settings.end())
+        return baseConfig.optimizationLevel;
+    return std::find_if(TUNED_LEVELS.begin(), TUNED_LEVELS.end(),
+        [&](const std::pair<std::string, OptimizationLevel>& level) -> bool { return level.first == it->second; })
+        ->second;
+}
+
+static bool isPassEnabled(const std::string& pass, const Settings& settings, const Configuration& baseConfig)
+{
+    auto it = settings.find(pass);
+    if(it != settings.end())
+        return it->second == "--f" + pass;
+    auto passes = optimizations::Optimizer::getPasses(getLevel(settings, baseConfig));
+    return passes.find(pass) != passes.end();
+}
+
+/*
+ * Creates all candidates differing from the given settings in exactly one dimension
+ */
+static std::vector<Settings> createNeighbors(const Settings& current, const Configuration& baseConfig, bool tunePasses)
+{
+    std::vector<Settings> neighbors;
+    auto addNeighbor = [&](const std::string& dimension, const std::string& option) {
+        auto it = current.find(dimension);
+        if(it != current.end() && it->second == option)
+            return;
+        Settings neighbor(current);
+        neighbor[dimension] = option;
+        neighbors.emplace_back(std::move(neighbor));
+    };
+
+    if(baseConfig.optimizationLevel != OptimizationLevel::NONE)
+    {
+        for(const auto& level : TUNED_LEVELS)
+        {
+            if(current.find("level") != current.end() || level.second != baseConfig.optimizationLevel)
+                addNeighbor("level", level.first);
+        }
+    }
+    for(const auto& param : TUNED_PARAMETERS)
+    {
+        for(auto value : param.second)
+            addNeighbor(param.first, "--f" + param.first + "=" + std::to_string(value));
+    }
+    if(tunePasses)
+    {
+        for(const auto& pass : optimizations::Optimizer::ALL_PASSES)
+        {
+            const auto& name = pass.parameterName;
+            // passes explicitly set by the user are not tuned
+            const auto& enabled = baseConfig.additionalEnabledOptimizations;
+            const auto& disabled = baseConfig.additionalDisabledOptimizations;
+            if(name == REQUIRED_PASS || enabled.find(name) != enabled.end() || disabled.find(name) != disabled.end())
+                continue;
+            addNeighbor(name, (isPassEnabled(name, current, baseConfig) ? "--fno-" : "--f") + name);
+        }
+    }
+    return neighbors;
+}
+
+static bool isSameResult(const Evaluation& reference, const Evaluation& candidate, const EmulationData& data)
+{
+    if(reference.results.size() != candidate.results.size())
+        return false;
+    for(std::size_t i = 0; i < reference.results.size(); ++i)
+    {
+        const auto& expected = reference.results[i];
+        const auto& actual = candidate.results[i];
+        // for buffers, the first entry is the address the buffer was mapped to, which can differ between modules
+        if(!data.parameter[i].second && expected.first != actual.first)
+            return false;
+        if(expected.second && (!actual.second || *expected.second != *actual.second))
+            return false;
+    }
+    return true;
+}
+
+static Evaluation evaluate(const Settings& settings, const Configuration& baseConfig, const std::string& options,
+    const std::string& source, const std::string& inputFile, const EmulationData& baseData)
+{
+    Evaluation evaluation;
+    evaluation.settings = settings;
+
+    Configuration config(baseConfig);
+    config.outputMode = OutputMode::BINARY;
+    config.writeKernelInfo = true;
+    for(const auto& setting : settings)
+        parseConfigurationParameter(config, setting.second);
+
+    try
+    {
+        std::istringstream input(source);
+        std::stringstream binary;
+        BlockLayout layout;
+        Compiler::compile(input, binary, config, options, inputFile, &layout);
+
+        EmulationData data(baseData);
+        data.module = std::make_pair("", &binary);
+        auto result = emulate(data);
+        evaluation.successful = result.executionSuccessful;
+        evaluation.numCycles = result.numCycles;
+        evaluation.results = std::move(result.results);
+        auto layoutIt = data.kernelName.empty() && layout.size() == 1 ? layout.begin() : layout.find(data.kernelName);
+        if(layoutIt != layout.end())
+            evaluation.blockProfile.emplace(layoutIt->first, createBlockProfile(result, layoutIt->second));
+    }
+    catch(const std::exception& e)
+    {
+        // any failure (e.g. an unsupported construct in the emulator) only disqualifies this configuration
+        CPPLOG_LAZY(logging::Level::INFO,
+            log << "Configuration '" << toOptions(settings, " ") << "' failed: " << e.what() << logging::endl);
+        evaluation.successful = false;
+    }
+    return evaluation;
+}
+
+static void writeProfile(const std::string& fileName, const EmulationData& data, const Evaluation& best,
+    const Evaluation& baseline)
+{
+    std::ofstream f(fileName, std::ios_base::out | std::ios_base::trunc);
+    f << "# Optimization profile for kernel '" << data.kernelName << "': " << best.numCycles << " cycles (baseline "
+      << baseline.numCycles << " cycles)" << std::endl;
+    f << "# Each line is a compiler option, apply them with: vc4c --options=" << fileName << std::endl;
+    for(const auto& setting : best.settings)
+        f << setting.second << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+#if DEBUG_MODE
+    setLogger(std::wcout, true, LogLevel::DEBUG);
+#else
+    setLogger(std::wcout, true, LogLevel::WARNING);
+#endif
+
+    if(argc == 1 || (argc == 2 && (std::string("-h") == argv[1] || std::string("--help") == argv[1])))
+    {
+        printHelp();
+        return 0;
+    }
+
+    EmulationData data;
+
+    data.workGroup.dimensions = 1;
+    data.workGroup.globalOffsets = {0, 0, 0};
+    data.workGroup.localSizes = {1, 1, 1};
+    data.workGroup.numGroups = {1, 1, 1};
+
+    Configuration baseConfig;
+    std::string options;
+    std::string profileFile;
+    std::string blockProfileFile;
+    unsigned maxRounds = 8;
+    unsigned numThreads = std::thread::hardware_concurrency();
+    bool tunePasses = true;
+
+    for(int i = 1; i < argc - 1; ++i)
+    {
+        if(std::string("-h") == argv[i] || std::string("--help") == argv[i])
+        {
+            printHelp();
+            return 0;
+        }
+        else if(std::string("-l") == argv[i])
+        {
+            ++i;
+            data.workGroup.localSizes.at(0) = static_cast<tools::Word>(std::strtol(argv[i], nullptr, 0));
+            ++i;
+            data.workGroup.localSizes.at(1) = static_cast<tools::Word>(std::strtol(argv[i], nullptr, 0));
+            ++i;
+            data.workGroup.localSizes.at(2) = static_cast<tools::Word>(std::strtol(argv[i], nullptr, 0));
+            data.workGroup.dimensions = 3;
+        }
+        else if(std::string("-g") == argv[i])
+        {
+            ++i;
+            data.workGroup.numGroups.at(0) = static_cast<tools::Word>(std::strtol(argv[i], nullptr, 0));
+            ++i;
+            data.workGroup.numGroups.at(1) = static_cast<tools::Word>(std::strtol(argv[i], nullptr, 0));
+            ++i;
+            data.workGroup.numGroups.at(2) = static_cast<tools::Word>(std::strtol(argv[i], nullptr, 0));
+            data.workGroup.dimensions = 3;
+        }
+        else if(std::string("-k") == argv[i])
+        {
+            ++i;
+            data.kernelName = argv[i];
+        }
+        else if(std::string("-r") == argv[i])
+        {
+            ++i;
+            maxRounds = static_cast<unsigned>(std::strtol(argv[i], nullptr, 0));
+        }
+        else if(std::string("-j") == argv[i])
+        {
+            ++i;
+            numThreads = std::max(1u, static_cast<unsigned>(std::strtol(argv[i], nullptr, 0)));
+        }
+        else if(std::string("-p") == argv[i])
+        {
+            ++i;
+            profileFile = argv[i];
+        }
+        else if(std::string("-i") == argv[i])
+        {
+            ++i;
+            blockProfileFile = argv[i];
+        }
+        else if(std::string("--no-passes") == argv[i])
+            tunePasses = false;
+        else if(std::string("-f") == argv[i])
+        {
+            ++i;
+            data.parameter.emplace_back(0u, readBinaryFile(argv[i]));
+        }
+        else if(std::string("-s") == argv[i])
+        {
+            ++i;
+            data.parameter.emplace_back(0u, readDirectData(argv[i]));
+        }
+        else if(std::string("-b") == argv[i])
+        {
+            ++i;
+            data.parameter.emplace_back(
+                0u, std::vector<tools::Word>(static_cast<std::size_t>(std::strtol(argv[i], nullptr, 0)), 0x0));
+        }
+        else if(std::string("-ib") == argv[i])
+        {
+            ++i;
+            data.parameter.emplace_back(0u, readDirectBuffer<int>(argv[i]));
+        }
+        else if(std::string("-fb") == argv[i])
+        {
+            ++i;
+            data.parameter.emplace_back(0u, readDirectBuffer<float>(argv[i]));
+        }
+        else if(std::string("-q") == argv[i] || std::string("--quiet") == argv[i])
+        {
+            setLogger(std::wcout, true, LogLevel::WARNING);
+        }
+        else if(std::string("--verbose") == argv[i])
+        {
+            setLogger(std::wcout, true, LogLevel::DEBUG);
+        }
+        else if(argv[i][0] == '-' && !std::isdigit(argv[i][1]))
+        {
+            // pass every not understood option to the pre-compiler, as well as every OpenCL compiler option
+            if(!parseConfigurationParameter(baseConfig, argv[i]) || strstr(argv[i], "-cl") == argv[i])
+                options.append(argv[i]).append(" ");
+        }
+        else
+            data.parameter.emplace_back(
+                static_cast<tools::Word>(std::strtol(argv[i], nullptr, 0)), Optional<std::vector<uint32_t>>{});
+    }
+
+    const std::string inputFile = argv[argc - 1];
+    std::string source;
+    {
+        std::ifstream input(inputFile);
+        if(!input.is_open())
+        {
+            std::cerr << "Cannot open input file '" << inputFile << "', aborting!" << std::endl;
+            return 2;
+        }
+        std::stringstream ss;
+        ss << input.rdbuf();
+        source = ss.str();
+    }
+
+    auto baseline = evaluate({}, baseConfig, options, source, inputFile, data);
+    if(!baseline.successful)
+    {
+        std::cerr << "Failed to compile and execute the kernel with the base configuration, aborting!" << std::endl;
+        return 3;
+    }
+    std::cout << "Baseline: " << baseline.numCycles << " cycles" << std::endl;
+
+    // configurations taking considerably longer than the baseline can never be selected, so abort them early
+    if(baseline.numCycles < std::numeric_limits<uint32_t>::max() / 2)
+        data.maxEmulationCycles = std::min(data.maxEmulationCycles, baseline.numCycles * 2);
+
+    Evaluation best = baseline;
+    ThreadPool pool{"Tuner", numThreads};
+    for(unsigned round = 0; round < maxRounds; ++round)
+    {
+        auto candidates = createNeighbors(best.settings, baseConfig, tunePasses);
+        std::vector<Evaluation> evaluations(candidates.size());
+        std::vector<std::future<void>> futures;
+        futures.reserve(candidates.size());
+        for(std::size_t i = 0; i < candidates.size(); ++i)
+        {
+            futures.emplace_back(pool.schedule([&, i]() {
+                evaluations[i] = evaluate(candidates[i], baseConfig, options, source, inputFile, data);
+            }));
+        }
+        for(auto& future : futures)
+            future.get();
+
+        const Evaluation* roundBest = nullptr;
+        for(const auto& evaluation : evaluations)
+        {
+            if(!evaluation.successful)
+                continue;
+            if(!isSameResult(baseline, evaluation, data))
+            {
+                logging::warn() << "Configuration '" << toOptions(evaluation.settings, " ")
+                                << "' produces different results than the baseline, skipping" << logging::endl;
+                continue;
+            }
+            if(evaluation.numCycles < (roundBest ? roundBest->numCycles : best.numCycles))
+                roundBest = &evaluation;
+        }
+        if(!roundBest)
+            // local optimum reached, no single change improves the execution time any further
+            break;
+        best = *roundBest;
+        std::cout << "Round " << (round + 1) << ": " << best.numCycles << " cycles with '"
+                  << toOptions(best.settings, " ") << "'" << std::endl;
+    }
+
+    std::cout << "Best configuration: " << best.numCycles << " cycles (" << (best.numCycles * 100u) / baseline.numCycles
+              << "% of baseline) with '" << toOptions(best.settings, " ") << "'" << std::endl;
+
+    if(!profileFile.empty())
+        writeProfile(profileFile, data, best, baseline);
+    if(!blockProfileFile.empty())
+    {
+        std::ofstream f(blockProfileFile, std::ios_base::out | std::ios_base::trunc);
+        writeBlockProfile(f, best.blockProfile);
+    }
+
+    return 0;
+}